@@ -0,0 +1,246 @@
+# Card reading and parsing code shared by the app and the tools.
+# Doesn't depend on QtQuick.
+
+DEFINES += NFCDC_NEED_PEER_SERVICE=0
+QMAKE_CXXFLAGS += -Wno-unused-parameter
+QMAKE_CFLAGS += -Wno-unused-parameter
+
+CONFIG(debug, debug|release) {
+    DEFINES += DEBUG HARBOUR_DEBUG
+}
+
+# qmake CONFIG+=alloc_stats counts heap allocations made at each
+# phase of reading and showing a card (see TravelCardAllocStats.h)
+alloc_stats {
+    DEFINES += MATKAKORTTI_ALLOC_STATS
+}
+
+# qmake CONFIG+=trace records the timeline of reading and showing
+# a card (see TravelCardTrace.h)
+trace {
+    DEFINES += MATKAKORTTI_TRACE
+}
+
+# qmake CONFIG+=transports adds the in-process replay and emulator
+# transports (see TravelCardTransport.h) and saving the card dumps to
+# MATKAKORTTI_DUMP_DIR. The tools need it, the app doesn't.
+transports {
+    DEFINES += MATKAKORTTI_TRANSPORTS
+}
+
+# Directories
+
+HARBOUR_LIB_DIR = $${PWD}/harbour-lib
+LIBGLIBUTIL_DIR = $${PWD}/libglibutil
+LIBGNFCDC_DIR = $${PWD}/libgnfcdc
+
+# libglibutil
+
+LIBGLIBUTIL_SRC = $${LIBGLIBUTIL_DIR}/src
+LIBGLIBUTIL_INCLUDE = $${LIBGLIBUTIL_DIR}/include
+
+INCLUDEPATH += \
+    $${LIBGLIBUTIL_INCLUDE}
+
+HEADERS += \
+    $${LIBGLIBUTIL_INCLUDE}/*.h
+
+SOURCES += \
+    $${LIBGLIBUTIL_SRC}/gutil_log.c \
+    $${LIBGLIBUTIL_SRC}/gutil_misc.c \
+    $${LIBGLIBUTIL_SRC}/gutil_strv.c \
+    $${LIBGLIBUTIL_SRC}/gutil_timenotify.c
+
+# libgnfcdc
+
+LIBGNFCDC_INCLUDE = $${LIBGNFCDC_DIR}/include
+LIBGNFCDC_SRC = $${LIBGNFCDC_DIR}/src
+LIBGNFCDC_SPEC = $${LIBGNFCDC_DIR}/spec
+
+INCLUDEPATH += \
+    $${LIBGNFCDC_INCLUDE}
+
+HEADERS += \
+    $${LIBGNFCDC_INCLUDE}/*.h \
+    $${LIBGNFCDC_SRC}/*.h
+
+SOURCES += \
+    $${LIBGNFCDC_SRC}/nfcdc_adapter.c \
+    $${LIBGNFCDC_SRC}/nfcdc_base.c \
+    $${LIBGNFCDC_SRC}/nfcdc_daemon.c \
+    $${LIBGNFCDC_SRC}/nfcdc_default_adapter.c \
+    $${LIBGNFCDC_SRC}/nfcdc_error.c \
+    $${LIBGNFCDC_SRC}/nfcdc_isodep.c \
+    $${LIBGNFCDC_SRC}/nfcdc_log.c \
+    $${LIBGNFCDC_SRC}/nfcdc_tag.c \
+    $${LIBGNFCDC_SRC}/nfcdc_util.c
+
+OTHER_FILES += \
+    $${LIBGNFCDC_SPEC}/*.xml
+
+defineTest(generateStub) {
+    xml = $${LIBGNFCDC_SPEC}/org.sailfishos.nfc.$${1}.xml
+    cmd = gdbus-codegen --generate-c-code org.sailfishos.nfc.$${1} $${xml}
+
+    gen_h = org.sailfishos.nfc.$${1}.h
+    gen_c = org.sailfishos.nfc.$${1}.c
+    target_h = org_sailfishos_nfc_$${1}_h
+    target_c = org_sailfishos_nfc_$${1}_c
+
+    $${target_h}.target = $${gen_h}
+    $${target_h}.depends = $${xml}
+    $${target_h}.commands = $${cmd}
+    export($${target_h}.target)
+    export($${target_h}.depends)
+    export($${target_h}.commands)
+
+    GENERATED_HEADERS += $${gen_h}
+    PRE_TARGETDEPS += $${gen_h}
+    QMAKE_EXTRA_TARGETS += $${target_h}
+
+    $${target_c}.target = $${gen_c}
+    $${target_c}.depends = $${gen_h}
+    export($${target_c}.target)
+    export($${target_c}.depends)
+
+    GENERATED_SOURCES += $${gen_c}
+    QMAKE_EXTRA_TARGETS += $${target_c}
+    PRE_TARGETDEPS += $${gen_c}
+
+    export(QMAKE_EXTRA_TARGETS)
+    export(GENERATED_SOURCES)
+    export(PRE_TARGETDEPS)
+}
+
+generateStub(Adapter)
+generateStub(Daemon)
+generateStub(IsoDep)
+generateStub(Settings)
+generateStub(Tag)
+
+# harbour-lib
+
+HARBOUR_LIB_INCLUDE = $${HARBOUR_LIB_DIR}/include
+HARBOUR_LIB_SRC = $${HARBOUR_LIB_DIR}/src
+
+INCLUDEPATH += \
+    $${HARBOUR_LIB_INCLUDE}
+
+HEADERS += \
+    $${HARBOUR_LIB_INCLUDE}/HarbourDebug.h \
+    $${HARBOUR_LIB_INCLUDE}/HarbourUtil.h
+
+SOURCES += \
+    $${HARBOUR_LIB_SRC}/HarbourUtil.cpp
+
+# Core
+
+# App version goes into the card dumps
+APP_VERSION = $$system(sed -n -e 's/^Version:[[:space:]]*//p' $${PWD}/rpm/harbour-matkakortti.spec)
+DEFINES += APP_VERSION=\\\"$${APP_VERSION}\\\"
+
+INCLUDEPATH += \
+    $${PWD}/src
+
+HEADERS += \
+    $${PWD}/src/TravelCard.h \
+    $${PWD}/src/TravelCardApduLog.h \
+    $${PWD}/src/TravelCardArchive.h \
+    $${PWD}/src/TravelCardDump.h \
+    $${PWD}/src/TravelCardHistoryFilter.h \
+    $${PWD}/src/TravelCardImpl.h \
+    $${PWD}/src/TravelCardIsoDep.h \
+    $${PWD}/src/TravelCardSession.h \
+    $${PWD}/src/TravelCardSummary.h \
+    $${PWD}/src/Util.h
+
+SOURCES += \
+    $${PWD}/src/TravelCard.cpp \
+    $${PWD}/src/TravelCardApduLog.cpp \
+    $${PWD}/src/TravelCardArchive.cpp \
+    $${PWD}/src/TravelCardDump.cpp \
+    $${PWD}/src/TravelCardHistoryFilter.cpp \
+    $${PWD}/src/TravelCardIsoDep.cpp \
+    $${PWD}/src/TravelCardSession.cpp \
+    $${PWD}/src/TravelCardSummary.cpp \
+    $${PWD}/src/Util.cpp
+
+# HSL
+
+HEADERS += \
+    $${PWD}/src/hsl/HslArea.h \
+    $${PWD}/src/hsl/HslCard.h \
+    $${PWD}/src/hsl/HslCardAppInfo.h \
+    $${PWD}/src/hsl/HslCardEticket.h \
+    $${PWD}/src/hsl/HslCardHistory.h \
+    $${PWD}/src/hsl/HslCardPeriodPass.h \
+    $${PWD}/src/hsl/HslCardStatistics.h \
+    $${PWD}/src/hsl/HslCardStoredValue.h \
+    $${PWD}/src/hsl/HslData.h
+
+SOURCES += \
+    $${PWD}/src/hsl/HslArea.cpp \
+    $${PWD}/src/hsl/HslCard.cpp \
+    $${PWD}/src/hsl/HslCardAppInfo.cpp \
+    $${PWD}/src/hsl/HslCardEticket.cpp \
+    $${PWD}/src/hsl/HslCardHistory.cpp \
+    $${PWD}/src/hsl/HslCardPeriodPass.cpp \
+    $${PWD}/src/hsl/HslCardStatistics.cpp \
+    $${PWD}/src/hsl/HslCardStoredValue.cpp \
+    $${PWD}/src/hsl/HslData.cpp
+
+# Nysse
+
+HEADERS += \
+    $${PWD}/src/nysse/NysseCard.h \
+    $${PWD}/src/nysse/NysseCardAppInfo.h \
+    $${PWD}/src/nysse/NysseCardBalance.h \
+    $${PWD}/src/nysse/NysseCardHistory.h \
+    $${PWD}/src/nysse/NysseCardOwnerInfo.h \
+    $${PWD}/src/nysse/NysseCardTicketInfo.h \
+    $${PWD}/src/nysse/NysseUtil.h
+
+SOURCES += \
+    $${PWD}/src/nysse/NysseCard.cpp \
+    $${PWD}/src/nysse/NysseCardAppInfo.cpp \
+    $${PWD}/src/nysse/NysseCardBalance.cpp \
+    $${PWD}/src/nysse/NysseCardHistory.cpp \
+    $${PWD}/src/nysse/NysseCardOwnerInfo.cpp \
+    $${PWD}/src/nysse/NysseCardTicketInfo.cpp \
+    $${PWD}/src/nysse/NysseUtil.cpp
+
+# Allocation counting
+
+alloc_stats {
+    HEADERS += \
+        $${PWD}/src/AllocCounter.h \
+        $${PWD}/src/TravelCardAllocStats.h
+
+    SOURCES += \
+        $${PWD}/src/AllocCounter.cpp \
+        $${PWD}/src/TravelCardAllocStats.cpp
+}
+
+# In-process transports
+
+transports {
+    HEADERS += \
+        $${PWD}/src/TravelCardEmulator.h \
+        $${PWD}/src/TravelCardReplay.h \
+        $${PWD}/src/TravelCardTransport.h
+
+    SOURCES += \
+        $${PWD}/src/TravelCardEmulator.cpp \
+        $${PWD}/src/TravelCardReplay.cpp \
+        $${PWD}/src/TravelCardTransport.cpp
+}
+
+# Tracing
+
+trace {
+    HEADERS += \
+        $${PWD}/src/TravelCardTrace.h
+
+    SOURCES += \
+        $${PWD}/src/TravelCardTrace.cpp
+}
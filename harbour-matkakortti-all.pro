@@ -0,0 +1,15 @@
+# The app and the command line tools in one go:
+#
+#   qmake harbour-matkakortti-all.pro && make
+#
+# The rpm is built from harbour-matkakortti.pro and doesn't include
+# the tools.
+
+TEMPLATE = subdirs
+
+SUBDIRS = \
+    app \
+    tools
+
+app.file = harbour-matkakortti.pro
+tools.file = tools/tools.pro
@@ -6,9 +6,6 @@ CONFIG += sailfishapp link_pkgconfig
 PKGCONFIG += sailfishapp glib-2.0 gobject-2.0 gio-unix-2.0
 QT += qml quick dbus
 
-DEFINES += NFCDC_NEED_PEER_SERVICE=0
-QMAKE_CXXFLAGS += -Wno-unused-parameter
-QMAKE_CFLAGS += -Wno-unused-parameter
 LIBS += -ldl
 
 TARGET_DATA_DIR = /usr/share/$${TARGET}
@@ -20,9 +17,7 @@ app_settings {
     TRANSLATIONS_PATH = $${TARGET_DATA_DIR}/translations
 }
 
-CONFIG(debug, debug|release) {
-    DEFINES += DEBUG HARBOUR_DEBUG
-} else {
+!CONFIG(debug, debug|release) {
     QMAKE_CXXFLAGS += -flto -fPIC
     QMAKE_CFLAGS += -flto -fPIC
     QMAKE_LFLAGS += -flto -fPIC
@@ -30,9 +25,6 @@ CONFIG(debug, debug|release) {
 
 # Directories
 
-HARBOUR_LIB_DIR = $${_PRO_FILE_PWD_}/harbour-lib
-LIBGLIBUTIL_DIR = $${_PRO_FILE_PWD_}/libglibutil
-LIBGNFCDC_DIR = $${_PRO_FILE_PWD_}/libgnfcdc
 LIBQNFCDC_DIR = $${_PRO_FILE_PWD_}/libqnfcdc
 
 # Files
@@ -49,89 +41,9 @@ OTHER_FILES += \
     icons/*.svg \
     translations/*.ts
 
-# libglibutil
-
-LIBGLIBUTIL_SRC = $${LIBGLIBUTIL_DIR}/src
-LIBGLIBUTIL_INCLUDE = $${LIBGLIBUTIL_DIR}/include
-
-INCLUDEPATH += \
-    $${LIBGLIBUTIL_INCLUDE}
-
-HEADERS += \
-    $${LIBGLIBUTIL_INCLUDE}/*.h
-
-SOURCES += \
-    $${LIBGLIBUTIL_SRC}/gutil_log.c \
-    $${LIBGLIBUTIL_SRC}/gutil_misc.c \
-    $${LIBGLIBUTIL_SRC}/gutil_strv.c \
-    $${LIBGLIBUTIL_SRC}/gutil_timenotify.c
-
-# libgnfcdc
-
-LIBGNFCDC_INCLUDE = $${LIBGNFCDC_DIR}/include
-LIBGNFCDC_SRC = $${LIBGNFCDC_DIR}/src
-LIBGNFCDC_SPEC = $${LIBGNFCDC_DIR}/spec
-
-INCLUDEPATH += \
-    $${LIBGNFCDC_INCLUDE}
-
-HEADERS += \
-    $${LIBGNFCDC_INCLUDE}/*.h \
-    $${LIBGNFCDC_SRC}/*.h
-
-SOURCES += \
-    $${LIBGNFCDC_SRC}/nfcdc_adapter.c \
-    $${LIBGNFCDC_SRC}/nfcdc_base.c \
-    $${LIBGNFCDC_SRC}/nfcdc_daemon.c \
-    $${LIBGNFCDC_SRC}/nfcdc_default_adapter.c \
-    $${LIBGNFCDC_SRC}/nfcdc_error.c \
-    $${LIBGNFCDC_SRC}/nfcdc_isodep.c \
-    $${LIBGNFCDC_SRC}/nfcdc_log.c \
-    $${LIBGNFCDC_SRC}/nfcdc_tag.c \
-    $${LIBGNFCDC_SRC}/nfcdc_util.c
-
-OTHER_FILES += \
-    $${LIBGNFCDC_SPEC}/*.xml
-
-defineTest(generateStub) {
-    xml = $${LIBGNFCDC_SPEC}/org.sailfishos.nfc.$${1}.xml
-    cmd = gdbus-codegen --generate-c-code org.sailfishos.nfc.$${1} $${xml}
-
-    gen_h = org.sailfishos.nfc.$${1}.h
-    gen_c = org.sailfishos.nfc.$${1}.c
-    target_h = org_sailfishos_nfc_$${1}_h
-    target_c = org_sailfishos_nfc_$${1}_c
+# Card reading and parsing
 
-    $${target_h}.target = $${gen_h}
-    $${target_h}.depends = $${xml}
-    $${target_h}.commands = $${cmd}
-    export($${target_h}.target)
-    export($${target_h}.depends)
-    export($${target_h}.commands)
-
-    GENERATED_HEADERS += $${gen_h}
-    PRE_TARGETDEPS += $${gen_h}
-    QMAKE_EXTRA_TARGETS += $${target_h}
-
-    $${target_c}.target = $${gen_c}
-    $${target_c}.depends = $${gen_h}
-    export($${target_c}.target)
-    export($${target_c}.depends)
-
-    GENERATED_SOURCES += $${gen_c}
-    QMAKE_EXTRA_TARGETS += $${target_c}
-    PRE_TARGETDEPS += $${gen_c}
-
-    export(QMAKE_EXTRA_TARGETS)
-    export(GENERATED_SOURCES)
-    export(PRE_TARGETDEPS)
-}
-
-generateStub(Adapter)
-generateStub(Daemon)
-generateStub(IsoDep)
-generateStub(Settings)
-generateStub(Tag)
+include(core.pri)
 
 # libqnfcdc
 
@@ -153,23 +65,15 @@ SOURCES += \
 
 # harbour-lib
 
-HARBOUR_LIB_INCLUDE = $${HARBOUR_LIB_DIR}/include
-HARBOUR_LIB_SRC = $${HARBOUR_LIB_DIR}/src
 HARBOUR_LIB_QML = $${HARBOUR_LIB_DIR}/qml
 
-INCLUDEPATH += \
-    $${HARBOUR_LIB_INCLUDE}
-
 HEADERS += \
-    $${HARBOUR_LIB_INCLUDE}/HarbourDebug.h \
     $${HARBOUR_LIB_INCLUDE}/HarbourSystemInfo.h \
-    $${HARBOUR_LIB_INCLUDE}/HarbourSystemTime.h \
-    $${HARBOUR_LIB_INCLUDE}/HarbourUtil.h
+    $${HARBOUR_LIB_INCLUDE}/HarbourSystemTime.h
 
 SOURCES += \
     $${HARBOUR_LIB_SRC}/HarbourSystemInfo.cpp \
-    $${HARBOUR_LIB_SRC}/HarbourSystemTime.cpp \
-    $${HARBOUR_LIB_SRC}/HarbourUtil.cpp
+    $${HARBOUR_LIB_SRC}/HarbourSystemTime.cpp
 
 HARBOUR_QML_COMPONENTS = \
     $${HARBOUR_LIB_QML}/HarbourHighlightIcon.qml
@@ -182,20 +86,23 @@ INSTALLS += qml_components
 
 # App
 
-INCLUDEPATH += \
-    src
+# Restricting the polling techs needs nfc_tech_request_new() which
+# only newer libgnfcdc has. It's used only if nfcdc_daemon.c (which
+# is compiled in by core.pri) provides it, so that the app links
+# with whichever libgnfcdc is checked out.
+NFCDC_DAEMON_SRC = $$cat($${LIBGNFCDC_SRC}/nfcdc_daemon.c)
+contains(NFCDC_DAEMON_SRC, "nfc_tech_request_new.*") {
+    DEFINES += MATKAKORTTI_TECH_REQUEST
+} else {
+    message("libgnfcdc can't request NFC techs, polling for all of them")
+}
 
 HEADERS += \
-    src/TravelCard.h \
-    src/TravelCardImpl.h \
-    src/TravelCardIsoDep.h \
-    src/Util.h
+    src/TravelCardPolling.h
 
 SOURCES += \
     src/main.cpp \
-    src/TravelCard.cpp \
-    src/TravelCardIsoDep.cpp \
-    src/Util.cpp
+    src/TravelCardPolling.cpp
 
 # HSL
 
@@ -203,49 +110,45 @@ OTHER_FILES += \
     qml/hsl/*.qml \
     qml/hsl/images/*.svg
 
-HEADERS += \
-    src/hsl/HslArea.h \
-    src/hsl/HslCard.h \
-    src/hsl/HslCardAppInfo.h \
-    src/hsl/HslCardEticket.h \
-    src/hsl/HslCardHistory.h \
-    src/hsl/HslCardPeriodPass.h \
-    src/hsl/HslCardStoredValue.h \
-    src/hsl/HslData.h
-
-SOURCES += \
-    src/hsl/HslArea.cpp \
-    src/hsl/HslCard.cpp \
-    src/hsl/HslCardAppInfo.cpp \
-    src/hsl/HslCardEticket.cpp \
-    src/hsl/HslCardHistory.cpp \
-    src/hsl/HslCardPeriodPass.cpp \
-    src/hsl/HslCardStoredValue.cpp \
-    src/hsl/HslData.cpp
-
 # Nysse
 
 OTHER_FILES += \
     qml/nysse/*.qml \
     qml/nysse/images/*.svg
 
-HEADERS += \
-    src/nysse/NysseCard.h \
-    src/nysse/NysseCardAppInfo.h \
-    src/nysse/NysseCardBalance.h \
-    src/nysse/NysseCardHistory.h \
-    src/nysse/NysseCardOwnerInfo.h \
-    src/nysse/NysseCardTicketInfo.h \
-    src/nysse/NysseUtil.h
-
-SOURCES += \
-    src/nysse/NysseCard.cpp \
-    src/nysse/NysseCardAppInfo.cpp \
-    src/nysse/NysseCardBalance.cpp \
-    src/nysse/NysseCardHistory.cpp \
-    src/nysse/NysseCardOwnerInfo.cpp \
-    src/nysse/NysseCardTicketInfo.cpp \
-    src/nysse/NysseUtil.cpp
+# Ahead-of-time compiled QML (qmake CONFIG+=aot_qml)
+#
+# All QML (and the images it refers to by relative URLs) goes into
+# the binary and gets compiled by the Qt Quick Compiler at build time,
+# if the compiler is available. Otherwise, it's only bundled, which
+# still saves a bunch of file system lookups at startup.
+
+aot_qml {
+    QML_FILES = \
+        $$files($${_PRO_FILE_PWD_}/qml/*.qml, true) \
+        $$files($${_PRO_FILE_PWD_}/qml/*.js, true) \
+        $$files($${_PRO_FILE_PWD_}/qml/*.svg, true)
+
+    QML_QRC = $${OUT_PWD}/qml.qrc
+    QML_QRC_LINES = "<RCC>" "<qresource prefix=\"/\">"
+    for(f, QML_FILES) {
+        QML_QRC_LINES += "<file alias=\"$$relative_path($$f, $$_PRO_FILE_PWD_)\">$$f</file>"
+    }
+    for(f, HARBOUR_QML_COMPONENTS) {
+        QML_QRC_LINES += "<file alias=\"qml/harbour/$$basename(f)\">$$f</file>"
+    }
+    QML_QRC_LINES += "</qresource>" "</RCC>"
+    write_file($${QML_QRC}, QML_QRC_LINES)|error("Failed to write $${QML_QRC}")
+
+    RESOURCES += $${QML_QRC}
+    DEFINES += APP_QML_RESOURCES
+
+    exists($$[QT_HOST_DATA]/mkspecs/features/qtquickcompiler.prf) {
+        CONFIG += qtquickcompiler
+    } else {
+        warning("Qt Quick Compiler is not available, QML is only bundled")
+    }
+}
 
 # Icons
 ICON_SIZES = 86 108 128 172 256
@@ -10,17 +10,18 @@ CoverBackground {
     id: cover
 
     property Page cardInfoPage
+    property var cardSummary
     property bool unrecorgnizedCard
 
     readonly property bool _darkOnLight: ('colorScheme' in Theme) && Theme.colorScheme === 1
     readonly property color _ticketValidBackground: _darkOnLight ? "lightgreen" : "darkgreen"
     readonly property color _ticketAboutToExpireBackground: _darkOnLight ? "yellow" : "#483d00"
     readonly property real _extraSize: Theme.paddingMedium
-    readonly property int _ticketSecondsRemaining: cardInfoPage ? cardInfoPage.ticketSecondsRemaining : TravelCard.PeriodInvalid
-    readonly property int _periodPassDaysRemaining: cardInfoPage ? cardInfoPage.periodPassDaysRemaining : TravelCard.PeriodInvalid
-    readonly property var _periodPassEndDate: cardInfoPage ? cardInfoPage.periodPassEndDate : undefined
-    readonly property string _remainingBalance: (cardInfoPage && cardInfoPage.remainingBalance) ?
-        cardInfoPage.remainingBalance : ""
+    // Summary of the last recognized card, doesn't depend on the card page
+    readonly property int _ticketSecondsRemaining: cardSummary ? cardSummary.ticketSecondsRemaining : TravelCard.PeriodInvalid
+    readonly property int _periodPassDaysRemaining: cardSummary ? cardSummary.periodPassDaysRemaining : TravelCard.PeriodInvalid
+    readonly property var _periodPassEndDate: cardSummary ? cardSummary.periodPassEndDate : undefined
+    readonly property string _remainingBalance: cardSummary ? Matkakortti.moneyString(cardSummary.balance) : ""
 
     signal popCardInfo()
 
@@ -7,8 +7,13 @@ Page {
 
     property var debug
 
-    readonly property bool _haveDebugLog: debug && debug.log
-    readonly property string _debugLog: _haveDebugLog ? debug.log : ""
+    // The log is formatted on demand, i.e. when this page gets opened
+    readonly property string _debugLog: (debug && debug.log) ? debug.log.text : ""
+    readonly property bool _haveDebugLog: _debugLog !== ""
+    // Only there if the app is built with CONFIG+=alloc_stats
+    readonly property string _allocStats: (debug && debug.alloc) ? debug.alloc.text : ""
+    // Same, with CONFIG+=trace
+    readonly property var _trace: debug ? debug.trace : null
     readonly property string _transferEngineVersion: HarbourSystemInfo.packageVersion("declarative-transferengine-qt5")
     readonly property bool _canShare: _haveDebugLog && HarbourSystemInfo.compareVersions(_transferEngineVersion, "0.4.0") >= 0
 
@@ -17,7 +22,7 @@ Page {
         contentHeight: height
 
         PullDownMenu {
-            visible: _haveDebugLog
+            visible: _haveDebugLog || _trace
 
             MenuItem {
                 //: Generic menu item, shares the content
@@ -30,7 +35,7 @@ Page {
                         action = Qt.createQmlObject("import Sailfish.Share 1.0;ShareAction{mimeType: 'text/plain'}",
                             thisPage, "SailfishShare")
                     }
-                    action.resources = [{ "data": debug.log, "name": "matkakortti.log" }]
+                    action.resources = [{ "data": _debugLog, "name": "matkakortti.log" }]
                     action.trigger()
                 }
             }
@@ -41,6 +46,13 @@ Page {
                 visible: _haveDebugLog
                 onClicked: Clipboard.text = _debugLog
             }
+            //: Debug menu item, copies the trace of the last card read to clipboard
+            //% "Copy trace"
+            MenuItem {
+                text: qsTrId("matkakortti-menu-copy_trace")
+                visible: !!_trace
+                onClicked: Clipboard.text = _trace.json()
+            }
         }
 
         PageHeader {
@@ -71,8 +83,8 @@ Page {
                 backgroundStyle: TextEditor.FilledBackground
                 softwareInputPanelEnabled: false
                 focus: false
-                text: _debugLog
-                visible: _haveDebugLog
+                text: _allocStats ? (_allocStats + "\n" + _debugLog) : _debugLog
+                visible: _haveDebugLog || _allocStats
             }
 
             VerticalScrollDecorator { }
@@ -15,9 +15,91 @@ Page {
 
     readonly property bool unrecorgnizedCard: NfcAdapter.targetPresent && travelCard.cardState === TravelCard.CardNone && !readTimer.running
     readonly property Page cardInfoPage: pageStack.nextPage(page)
+    readonly property var cardSummary: travelCard.summary
 
     readonly property bool _nysseSupported: NfcSystem.version >= NfcSystem.Version_1_0_26
     readonly property bool _readingCard: travelCard.cardState === TravelCard.CardReading || readTimer.running
+    // The page of the last card type gets compiled in the background,
+    // the engine then reuses the compiled component when it's pushed
+    readonly property var _predictedPage: travelCard.defaultPageUrl ?
+        Qt.createComponent(Qt.resolvedUrl(travelCard.defaultPageUrl), Component.Asynchronous) : null
+    // And an instance of it is incubated while we are idle, so that only
+    // data binding remains to be done when the card gets recognized
+    property var _prewarmedPage
+    property var _incubator
+    // Prewarmed pages have no parent and the page stack doesn't own them
+    // either, they have to be destroyed explicitly once they are popped
+    property var _pushedPages: []
+
+    on_PredictedPageChanged: _prewarm()
+    onCardInfoPageChanged: _releasePushedPages()
+
+    Connections {
+        target: pageStack
+        onBusyChanged: _releasePushedPages()
+    }
+
+    function _releasePushedPages() {
+        if (!pageStack.busy) {
+            // Wait for the transition to finish before destroying anything
+            var pages = _pushedPages
+            var remaining = []
+            for (var i = 0; i < pages.length; i++) {
+                if (pages[i] === cardInfoPage) {
+                    remaining.push(pages[i])
+                } else {
+                    pages[i].destroy()
+                }
+            }
+            if (remaining.length < pages.length) {
+                _pushedPages = remaining
+                // destroy() is deferred, let it happen before
+                // creating the next page
+                prewarmTimer.restart()
+                return
+            }
+        }
+        if (!cardInfoPage) _prewarm()
+    }
+
+    function _prewarm() {
+        var cardType = travelCard.defaultCardType
+        if (_prewarmedPage && _prewarmedPage.cardInfo.cardType !== cardType) {
+            _prewarmedPage.destroy()
+            _prewarmedPage = null
+        }
+        // Don't create another one while the popped page is still alive
+        if (!_prewarmedPage && !_incubator && !cardInfoPage &&
+            !_pushedPages.length && _predictedPage && _predictedPage.status === Component.Ready) {
+            var incubator = _predictedPage.incubateObject(null, { cardInfo: { cardType: cardType } })
+            if (incubator.status === Component.Ready) {
+                _prewarmedPage = incubator.object
+            } else {
+                _incubator = incubator
+                incubator.onStatusChanged = function(status) {
+                    _incubator = null
+                    if (status === Component.Ready) {
+                        _prewarmedPage = incubator.object
+                        _prewarm() // In case if the card type has changed
+                    }
+                }
+            }
+        }
+    }
+
+    function _takePrewarmedPage(cardType) {
+        var prewarmed = _prewarmedPage
+        if (prewarmed && prewarmed.cardInfo.cardType === cardType) {
+            _prewarmedPage = null
+            return prewarmed
+        }
+        return null
+    }
+
+    Connections {
+        target: _predictedPage
+        onStatusChanged: _prewarm()
+    }
 
     ConfigurationValue {
         id: lastCardType
@@ -38,14 +120,25 @@ Page {
 
             case TravelCard.CardRecognized:
                 lastCardType.value = cardInfo.cardType
-                if (cardInfoPage) {
-                    if (cardInfoPage.cardInfo.cardType === cardInfo.cardType) {
-                        cardInfoPage.cardInfo = cardInfo // Reuse the existing page
+                // Only there if the app is built with CONFIG+=trace
+                var trace = cardInfo.debug ? cardInfo.debug.trace : null
+                if (trace) trace.mark("pagePush")
+                if (cardInfoPage && cardInfoPage.cardInfo.cardType === cardInfo.cardType) {
+                    // Reuse the existing page, unless there's nothing new to show
+                    if (!sameContents) cardInfoPage.cardInfo = cardInfo
+                } else {
+                    var prewarmed = _takePrewarmedPage(cardInfo.cardType)
+                    if (prewarmed) {
+                        prewarmed.cardInfo = cardInfo
+                        _pushedPages = _pushedPages.concat([prewarmed])
+                    }
+                    var target = prewarmed ? prewarmed : Qt.resolvedUrl(pageUrl)
+                    var props = prewarmed ? {} : { cardInfo: cardInfo }
+                    if (cardInfoPage) {
+                        pageStack.replaceAbove(page, target, props)
                     } else {
-                        pageStack.replaceAbove(page, Qt.resolvedUrl(pageUrl), { cardInfo: cardInfo })
+                        pageStack.push(target, props)
                     }
-                } else {
-                    pageStack.push(Qt.resolvedUrl(pageUrl), { cardInfo: cardInfo })
                 }
                 break
             }
@@ -58,6 +151,13 @@ Page {
         interval: 500
     }
 
+    Timer {
+        id: prewarmTimer
+
+        interval: 0
+        onTriggered: if (!cardInfoPage) _prewarm()
+    }
+
     Item {
         anchors.fill: parent
         opacity: (NfcSystem.valid && (!NfcSystem.present || !NfcAdapter.present)) ? 1 : 0
@@ -3,14 +3,14 @@ import Sailfish.Silica 1.0
 import harbour.matkakortti 1.0
 
 import "../components"
-import "../components/Utils.js" as Utils
 
 BackgroundItem {
     property int type
     property alias time: boardingTime.value
-    property int price
+    property alias price: priceLabel.value
+    property string total
     property int group
-    property int saldo
+    property alias saldo: saldoLabel.value
     property alias separator: bottomSeparator.visible
 
     height: column.y + column.height
@@ -47,27 +47,29 @@ BackgroundItem {
             visible: type === HslCardHistory.TransactionPurchase
 
             ValueLabel {
+                id: priceLabel
+
                 width: Math.min(preferredWidth, parent.width)
                 //: Label
                 //% "Cost:"
                 title: qsTrId("matkakortti-details-ticket-cost")
-                value: Utils.moneyString(price)
             }
 
             Label {
                 visible: group > 1
                 color: Theme.secondaryHighlightColor
-                text: "\u00d7 " + group + " = " + Utils.moneyString(price * group)
+                text: "\u00d7 " + group + " = " + total
             }
         }
 
         ValueLabel {
+            id: saldoLabel
+
             width: parent.width
-            visible: saldo > 0
+            visible: value !== ""
             //: Label
             //% "Remaining balance:"
             title: qsTrId("matkakortti-history-remaining_balance")
-            value: Utils.moneyString(saldo)
         }
 
         VerticalSpace { height: column.y }
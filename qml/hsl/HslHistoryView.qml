@@ -3,30 +3,90 @@ import Sailfish.Silica 1.0
 import harbour.matkakortti 1.0
 
 import "../components"
-import "../components/Utils.js" as Utils
 
 SilicaListView {
     id: view
 
+    property alias history: historyFilter.sourceModel
+    property alias storedValue: statistics.storedValue
+    property int transactionType: TravelCardHistoryFilter.AnyTransaction
+
+    model: TravelCardHistoryFilter {
+        id: historyFilter
+
+        transactionType: view.transactionType
+    }
+
+    HslCardStatistics {
+        id: statistics
+
+        history: historyFilter.sourceModel
+        maxCount: 3 // Three most recent months
+    }
+
     header: Column {
         width: parent.width
 
+        SectionHeader {
+            visible: statistics.count > 0
+            //: Section header
+            //% "Monthly spending"
+            text: qsTrId("matkakortti-history-section-monthly_spending")
+        }
+
+        Repeater {
+            model: statistics
+
+            delegate: DetailItem {
+                label: Qt.locale().standaloneMonthName(model.month - 1) + " " + model.year
+                value: model.spentString
+            }
+        }
+
         SectionHeader {
             //: Section header
             //% "Previous journeys"
             text: qsTrId("matkakortti-history-section-previous_journeys")
         }
 
+        ComboBox {
+            //: Combo box label
+            //% "Show"
+            label: qsTrId("matkakortti-history-filter-label")
+            menu: ContextMenu {
+                MenuItem {
+                    readonly property int transactionType: TravelCardHistoryFilter.AnyTransaction
+                    //: Combo box value (history filter)
+                    //% "Everything"
+                    text: qsTrId("matkakortti-history-filter-all")
+                }
+                MenuItem {
+                    readonly property int transactionType: HslCardHistory.TransactionPurchase
+                    //: Combo box value (history filter)
+                    //% "Purchases"
+                    text: qsTrId("matkakortti-history-filter-purchases")
+                }
+                MenuItem {
+                    readonly property int transactionType: HslCardHistory.TransactionBoarding
+                    //: Label (transaction type)
+                    //% "Season ticket or boarding"
+                    text: qsTrId("matkakortti-history-transaction_type")
+                }
+            }
+            onCurrentItemChanged: if (currentItem) view.transactionType = currentItem.transactionType
+        }
+
         VerticalSpace { height: Theme.paddingLarge/2 }
     }
 
     delegate: HslHistoryItem {
         width: parent.width
-        type: transactionType
-        time: Utils.dateTimeString(boardingTime)
-        price: ticketPrice
-        group: groupSize
-        saldo: remainingValue
+        type: model.transactionType
+        time: model.boardingTimeString
+        price: model.ticketPriceString
+        total: model.totalPriceString
+        group: model.groupSize
+        saldo: model.remainingValueString
         separator: (index + 1) < view.count
     }
 
@@ -32,11 +32,17 @@ Page {
         when: showNavigationIndicator
     }
 
-    HslCardAppInfo { id: appInfoParser; data: cardInfo.appInfo }
-    HslCardEticket { id: eTicketParser; data: cardInfo.eTicket }
-    HslCardStoredValue { id: storedValueParser; data: cardInfo.storedValue }
-    HslCardPeriodPass { id: periodPassParser; data: cardInfo.periodPass }
-    HslCardHistory { id: historyParser; data: cardInfo.history }
+    HslCardAppInfo { id: appInfoParser; data: cardInfo.appInfo || "" }
+    HslCardEticket { id: eTicketParser; data: cardInfo.eTicket || "" }
+    HslCardStoredValue { id: storedValueParser; data: cardInfo.storedValue || "" }
+    HslCardPeriodPass { id: periodPassParser; data: cardInfo.periodPass || "" }
+    HslCardHistory {
+        id: historyParser
+
+        data: cardInfo.history || ""
+        cardNumber: appInfoParser.cardNumber
+        includeArchive: true
+    }
 
     TravelCardHeader {
         id: header
@@ -114,7 +120,8 @@ Page {
 
         HslHistoryView {
             anchors.fill: parent
-            model: historyParser
+            history: historyParser
+            storedValue: storedValueParser
         }
     }
 }
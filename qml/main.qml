@@ -16,6 +16,7 @@ ApplicationWindow {
     initialPage: MainPage { id: mainPage }
     cover: CoverPage {
         cardInfoPage: mainPage.cardInfoPage
+        cardSummary: mainPage.cardSummary
         unrecorgnizedCard: mainPage.unrecorgnizedCard
         onPopCardInfo: pageStack.pop(mainPage, PageStackAction.Immediate)
     }
@@ -26,6 +27,10 @@ ApplicationWindow {
         active: Qt.application.active
     }
 
+    TravelCardPolling {
+        active: Qt.application.active
+    }
+
     Connections {
         target: HarbourSystemTime
         onPreNotify: Date.timeZoneUpdated()
@@ -3,13 +3,13 @@ import Sailfish.Silica 1.0
 import harbour.matkakortti 1.0
 
 import "../components"
-import "../components/Utils.js" as Utils
 
 BackgroundItem {
     property int type
     property alias time: timestamp.value
     property int group
-    property int moneyAmount
+    property string amount
+    property string total
     property alias separator: bottomSeparator.visible
 
     readonly property bool _isDeposit: type === NysseCardHistory.TransactionDeposit
@@ -42,13 +42,13 @@ BackgroundItem {
                 //: Label
                 //% "Cost:"
                 title: qsTrId("matkakortti-details-ticket-cost")
-                value: Utils.moneyString(moneyAmount)
+                value: amount
             }
 
             Label {
                 visible: group > 1
                 color: Theme.secondaryHighlightColor
-                text: "\u00d7 " + group + " = " + Utils.moneyString(moneyAmount * group)
+                text: "\u00d7 " + group + " = " + total
             }
         }
 
@@ -61,9 +61,9 @@ BackgroundItem {
                 //: Label
                 //% "Cost:"
                 qsTrId("matkakortti-details-ticket-cost")
-            value: Utils.moneyString(moneyAmount)
+            value: amount
             boldValue: _isDeposit
-            visible: moneyAmount > 0 && type !== NysseCardHistory.TransactionPurchase
+            visible: amount !== "" && type !== NysseCardHistory.TransactionPurchase
         }
 
         VerticalSpace { height: column.y }
@@ -2,17 +2,53 @@ import QtQuick 2.0
 import Sailfish.Silica 1.0
 import harbour.matkakortti 1.0
 
-import "../components/Utils.js" as Utils
-
 SilicaListView {
     id: view
 
+    property alias history: historyFilter.sourceModel
+    property int transactionType: TravelCardHistoryFilter.AnyTransaction
+
+    model: TravelCardHistoryFilter {
+        id: historyFilter
+
+        transactionType: view.transactionType
+    }
+
+    header: ComboBox {
+        width: parent.width
+        //: Combo box label
+        //% "Show"
+        label: qsTrId("matkakortti-history-filter-label")
+        menu: ContextMenu {
+            MenuItem {
+                readonly property int transactionType: TravelCardHistoryFilter.AnyTransaction
+                //: Combo box value (history filter)
+                //% "Everything"
+                text: qsTrId("matkakortti-history-filter-all")
+            }
+            MenuItem {
+                readonly property int transactionType: NysseCardHistory.TransactionPurchase
+                //: Combo box value (history filter)
+                //% "Purchases"
+                text: qsTrId("matkakortti-history-filter-purchases")
+            }
+            MenuItem {
+                readonly property int transactionType: NysseCardHistory.TransactionDeposit
+                //: Combo box value (history filter)
+                //% "Deposits"
+                text: qsTrId("matkakortti-history-filter-deposits")
+            }
+        }
+        onCurrentItemChanged: if (currentItem) view.transactionType = currentItem.transactionType
+    }
+
     delegate: NysseHistoryItem {
         width: parent.width
         type: model.transactionType
-        time: Utils.dateTimeString(model.transactionTime)
+        time: model.transactionTimeString
         group: model.passengerCount
-        moneyAmount: model.moneyAmount
+        amount: model.moneyAmountString
+        total: model.totalAmountString
         separator: (model.index + 1) < view.count
     }
 
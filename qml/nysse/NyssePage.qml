@@ -31,11 +31,17 @@ Page {
         when: showNavigationIndicator
     }
 
-    NysseCardAppInfo { id: appInfoParser; data: cardInfo.appInfoData }
-    NysseCardOwnerInfo { id: ownerInfoParser; data: cardInfo.ownerInfoData }
-    NysseCardBalance { id: balanceParser; data: cardInfo.balanceData }
-    NysseCardHistory { id: historyParser; data: cardInfo.historyData }
-    NysseCardTicketInfo { id: ticketInfoParser; data: cardInfo.ticketInfoData }
+    NysseCardAppInfo { id: appInfoParser; data: cardInfo.appInfoData || "" }
+    NysseCardOwnerInfo { id: ownerInfoParser; data: cardInfo.ownerInfoData || "" }
+    NysseCardBalance { id: balanceParser; data: cardInfo.balanceData || "" }
+    NysseCardHistory {
+        id: historyParser
+
+        data: cardInfo.historyData || ""
+        cardNumber: appInfoParser.cardNumber
+        includeArchive: true
+    }
+    NysseCardTicketInfo { id: ticketInfoParser; data: cardInfo.ticketInfoData || "" }
 
     TravelCardHeader {
         id: header
@@ -178,7 +184,7 @@ Page {
 
         NysseHistoryView {
             anchors.fill: parent
-            model: historyParser
+            history: historyParser
         }
     }
 }
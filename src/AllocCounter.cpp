@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "AllocCounter.h"
+
+#include <atomic>
+
+#include <errno.h>
+#include <stdlib.h>
+
+// Static initialization of these doesn't involve any code, i.e.
+// they can be used before constructors are run.
+static std::atomic<bool> alloc_counter_enabled(false);
+static std::atomic<quint64> alloc_counter_count(0);
+static std::atomic<quint64> alloc_counter_bytes(0);
+
+static inline
+void
+alloc_counter_add(
+    size_t aSize)
+{
+    if (alloc_counter_enabled.load(std::memory_order_relaxed)) {
+        alloc_counter_count.fetch_add(1, std::memory_order_relaxed);
+        alloc_counter_bytes.fetch_add(aSize, std::memory_order_relaxed);
+    }
+}
+
+extern "C" {
+
+void* __libc_malloc(size_t);
+void* __libc_calloc(size_t, size_t);
+void* __libc_realloc(void*, size_t);
+void* __libc_memalign(size_t, size_t);
+
+void*
+malloc(
+    size_t aSize) __THROW
+{
+    alloc_counter_add(aSize);
+    return __libc_malloc(aSize);
+}
+
+void*
+calloc(
+    size_t aCount,
+    size_t aSize) __THROW
+{
+    alloc_counter_add(aCount * aSize);
+    return __libc_calloc(aCount, aSize);
+}
+
+void*
+realloc(
+    void* aPtr,
+    size_t aSize) __THROW
+{
+    // Growing a block counts as an allocation
+    alloc_counter_add(aSize);
+    return __libc_realloc(aPtr, aSize);
+}
+
+void*
+memalign(
+    size_t aAlign,
+    size_t aSize) __THROW
+{
+    alloc_counter_add(aSize);
+    return __libc_memalign(aAlign, aSize);
+}
+
+int
+posix_memalign(
+    void** aPtr,
+    size_t aAlign,
+    size_t aSize) __THROW
+{
+    alloc_counter_add(aSize);
+    *aPtr = __libc_memalign(aAlign, aSize);
+    return *aPtr ? 0 : ENOMEM;
+}
+
+} // extern "C"
+
+void
+AllocCounter::start()
+{
+    alloc_counter_enabled.store(true);
+}
+
+void
+AllocCounter::stop()
+{
+    alloc_counter_enabled.store(false);
+}
+
+AllocCounter::Stats
+AllocCounter::stats()
+{
+    Stats stats;
+
+    stats.iCount = alloc_counter_count.load();
+    stats.iBytes = alloc_counter_bytes.load();
+    return stats;
+}
+
+void
+AllocCounter::reset()
+{
+    alloc_counter_count.store(0);
+    alloc_counter_bytes.store(0);
+}
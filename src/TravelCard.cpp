@@ -38,7 +38,12 @@
 #include "gutil_types.h"
 
 #include "TravelCard.h"
+#include "TravelCardAllocStats.h"
+#include "TravelCardTrace.h"
+#include "Util.h"
 #include "TravelCardImpl.h"
+#include "TravelCardSession.h"
+#include "TravelCardSummary.h"
 
 #include "hsl/HslCard.h"
 #include "nysse/NysseCard.h"
@@ -54,42 +59,67 @@ class TravelCard::Private : public QObject {
 
 public:
     static const TravelCardImpl::CardDesc * const gCardTypes[];
+    static const char* gTypeUri;
+    static int gTypeVersion[2];
+    static bool gTypesRegistered[];
 
     Private(TravelCard* aParent);
     ~Private();
 
     static void deleteObjectLater(QObject* aObject);
+    static QObject* apduLog(const QVariantMap& aCardInfo);
+    static void registerCardTypes(int aTypeIndex);
     TravelCard* parentObject() const;
+    void clearCardInfo();
+    void setLastCardInfo(const QVariantMap& aCardInfo);
+    bool updateCardInfo(const QVariantMap& aCardInfo);
+    void setSummary(TravelCardSummary* aSummary);
+    void dropSession();
     void setPath(QString aPath);
     bool setDefaultCardType(QString aType);
     int currentCardTypeIndex() const;
     const TravelCardImpl::CardDesc* currentCardDesc() const;
     void tryNext();
+    void tagLost();
 
 private Q_SLOTS:
     void onReadFailed();
+    void onTagLost();
     void onReadDone(QString aPageUrl, QVariantMap aCardInfo);
 
 public:
     QString iPath;
+    TravelCardSession* iSession;
     TravelCardImpl* iCardImpl;
     int iCurrentStep;
     int iDefaultCardTypeIndex;
+    bool iDefaultCardTypeSet;
     CardState iCardState;
     QVariantMap iCardInfo;
+    QVariantMap iLastCardInfo;
+    bool iSameContents;
     QString iPageUrl;
+    TravelCardSummary* iSummary;
 };
 
 const TravelCardImpl::CardDesc* const TravelCard::Private::gCardTypes[] = {
     &HslCard::Desc, &NysseCard::Desc
 };
 
+const char* TravelCard::Private::gTypeUri = Q_NULLPTR;
+int TravelCard::Private::gTypeVersion[2];
+bool TravelCard::Private::gTypesRegistered[G_N_ELEMENTS(gCardTypes)];
+
 TravelCard::Private::Private(TravelCard* aParent) :
     QObject(aParent),
+    iSession(Q_NULLPTR),
     iCardImpl(Q_NULLPTR),
     iCurrentStep(-1),
     iDefaultCardTypeIndex(0),
-    iCardState(CardNone)
+    iDefaultCardTypeSet(false),
+    iCardState(CardNone),
+    iSameContents(false),
+    iSummary(Q_NULLPTR)
 {
 }
 
@@ -115,19 +145,136 @@ const TravelCardImpl::CardDesc* TravelCard::Private::currentCardDesc() const
     return (typeIndex >= 0) ? gCardTypes[typeIndex] : Q_NULLPTR;
 }
 
+void TravelCard::Private::registerCardTypes(int aTypeIndex)
+{
+    // Must happen before the QML engine sees the page of this type
+    if (gTypeUri && !gTypesRegistered[aTypeIndex]) {
+        HDEBUG(gCardTypes[aTypeIndex]->iName);
+        gTypesRegistered[aTypeIndex] = true;
+        gCardTypes[aTypeIndex]->iRegisterTypes(gTypeUri,
+            gTypeVersion[0], gTypeVersion[1]);
+    }
+}
+
 void TravelCard::Private::deleteObjectLater(QObject* aObject)
 {
     // See https://bugreports.qt.io/browse/QTBUG-18434
     QMetaObject::invokeMethod(aObject, "deleteLater", Qt::QueuedConnection);
 }
 
+QObject* TravelCard::Private::apduLog(const QVariantMap& aCardInfo)
+{
+    return qvariant_cast<QObject*>(aCardInfo.value("debug").toMap().
+        value("log"));
+}
+
+void TravelCard::Private::clearCardInfo()
+{
+    iCardInfo.clear();
+    iSameContents = false;
+}
+
+void TravelCard::Private::setLastCardInfo(const QVariantMap& aCardInfo)
+{
+    // The APDU log (if there is one) belongs to us
+    QObject* log = apduLog(iLastCardInfo);
+    iLastCardInfo = aCardInfo;
+    if (log && log != apduLog(aCardInfo)) {
+        deleteObjectLater(log);
+    }
+}
+
+bool TravelCard::Private::updateCardInfo(const QVariantMap& aCardInfo)
+{
+    // The blocks that haven't changed since the last read keep the
+    // previous value (sharing its data) so that the parsers have nothing
+    // to do with them. If nothing has changed at all, the previous card
+    // info is kept as a whole. A plain comparison is enough here, the
+    // blocks are small and the ones that differ usually differ in size
+    // or early on.
+    QVariantMap info(aCardInfo);
+    int blocks = 0, prevBlocks = 0;
+    bool same = true;
+
+    for (QVariantMap::iterator it = info.begin(); it != info.end(); ++it) {
+        if (it.value().userType() == QMetaType::QString) {
+            const QVariant prev(iLastCardInfo.value(it.key()));
+
+            blocks++;
+            if (prev.userType() == QMetaType::QString &&
+                prev.toString() == it.value().toString()) {
+                it.value() = prev;
+            } else {
+                same = false;
+            }
+        }
+    }
+    for (QVariantMap::const_iterator it = iLastCardInfo.constBegin();
+         same && it != iLastCardInfo.constEnd(); ++it) {
+        if (it.value().userType() == QMetaType::QString) {
+            prevBlocks++;
+        }
+    }
+
+    if (same && blocks == prevBlocks) {
+        QObject* log = apduLog(aCardInfo);
+        if (log) {
+            deleteObjectLater(log);
+        }
+        iCardInfo = iLastCardInfo;
+        return true;
+    } else {
+        setLastCardInfo(info);
+        iCardInfo = info;
+        return false;
+    }
+}
+
+void TravelCard::Private::setSummary(TravelCardSummary* aSummary)
+{
+    if (iSummary != aSummary) {
+        if (iSummary) {
+            deleteObjectLater(iSummary);
+        }
+        iSummary = aSummary;
+        Q_EMIT parentObject()->summaryChanged();
+    }
+}
+
+void TravelCard::Private::dropSession()
+{
+    // Releases the tag lock (once the drivers are gone)
+    if (iSession) {
+        deleteObjectLater(iSession);
+        iSession = Q_NULLPTR;
+    }
+}
+
 void TravelCard::Private::setPath(QString aPath)
 {
     if (iPath != aPath) {
+        TravelCardSession* prevSession = iSession;
+
         iPath = aPath;
         HDEBUG(aPath);
-        iCurrentStep = aPath.isEmpty() ? G_N_ELEMENTS(gCardTypes) : (-1);
-        tryNext();
+        TRACE_INSTANT("setPath");
+        if (aPath.isEmpty() && iCardState == CardReading) {
+            // The tag path may get cleared before the driver notices
+            // that the tag is gone, depending on the order in which
+            // nfcd signals arrive. Either way, the tag has been lost.
+            tagLost();
+        } else {
+            ALLOC_STATS_RESET();
+            // The session starts locking the tag right away, before
+            // the first driver gets created
+            iSession = aPath.isEmpty() ? Q_NULLPTR :
+                new TravelCardSession(aPath, this);
+            iCurrentStep = aPath.isEmpty() ? G_N_ELEMENTS(gCardTypes) : (-1);
+            tryNext();
+            if (prevSession) {
+                deleteObjectLater(prevSession);
+            }
+        }
         parentObject()->pathChanged();
     }
 }
@@ -137,8 +284,11 @@ bool TravelCard::Private::setDefaultCardType(QString aType)
     for (int i = 0; i < (int) G_N_ELEMENTS(gCardTypes); i++) {
         if (gCardTypes[i]->iName == aType) {
             HDEBUG(aType);
-            if (iDefaultCardTypeIndex != i) {
+            // Likely to be needed soon
+            registerCardTypes(i);
+            if (iDefaultCardTypeIndex != i || !iDefaultCardTypeSet) {
                 iDefaultCardTypeIndex = i;
+                iDefaultCardTypeSet = true;
                 return true; // Emit the change event
             } else {
                 return false;
@@ -161,10 +311,11 @@ void TravelCard::Private::tryNext()
     if (++iCurrentStep < (int)G_N_ELEMENTS(gCardTypes)) {
         const int typeIndex = currentCardTypeIndex();
         HDEBUG(gCardTypes[typeIndex]->iName);
-        iCardInfo.clear();
+        clearCardInfo();
         iCardState = CardReading;
-        iCardImpl = gCardTypes[typeIndex]->iNewCard(iPath, this);
+        iCardImpl = gCardTypes[typeIndex]->iNewCard(iSession, this);
         connect(iCardImpl, SIGNAL(readFailed()), SLOT(onReadFailed()));
+        connect(iCardImpl, SIGNAL(tagLost()), SLOT(onTagLost()));
         connect(iCardImpl,
             SIGNAL(readDone(QString,QVariantMap)),
             SLOT(onReadDone(QString,QVariantMap)));
@@ -172,7 +323,10 @@ void TravelCard::Private::tryNext()
     } else if (iCardState == CardReading) {
         HDEBUG("No more card types to try");
         iCardState = CardNone;
-        iCardInfo.clear();
+        clearCardInfo();
+        setLastCardInfo(QVariantMap());
+        setSummary(Q_NULLPTR);
+        dropSession();
     }
     if (prevState != iCardState) {
         Q_EMIT parentObject()->cardStateChanged();
@@ -184,18 +338,54 @@ void TravelCard::Private::tryNext()
 
 void TravelCard::Private::onReadFailed()
 {
+    TRACE_INSTANT("TravelCard::onReadFailed");
     HDEBUG(currentCardDesc()->iName);
     tryNext();
 }
 
+void TravelCard::Private::onTagLost()
+{
+    TRACE_INSTANT("TravelCard::onTagLost");
+    HDEBUG(currentCardDesc()->iName);
+    tagLost();
+}
+
+void TravelCard::Private::tagLost()
+{
+    // No point in trying the remaining card types. Unlike the case of
+    // an unrecognized tag, the last card (and its summary) remains.
+    if (iCardImpl) {
+        iCardImpl->disconnect(this);
+        deleteObjectLater(iCardImpl);
+        iCardImpl = Q_NULLPTR;
+    }
+    dropSession();
+    iCurrentStep = G_N_ELEMENTS(gCardTypes);
+    iCardState = CardNone;
+    TravelCard* obj = parentObject();
+    Q_EMIT obj->tagLost();
+    Q_EMIT obj->cardStateChanged();
+}
+
 void TravelCard::Private::onReadDone(QString aPageUrl, QVariantMap aCardInfo)
 {
     HDEBUG(currentCardDesc()->iName << aPageUrl << aCardInfo);
+    TRACE_SCOPE("TravelCard::onReadDone");
+    ALLOC_STATS_SCOPE(QmlAssignment);
     iCardImpl->disconnect(this);
     deleteObjectLater(iCardImpl);
     iCardImpl = Q_NULLPTR;
+    dropSession();
     iCardState = CardRecognized;
-    iCardInfo = aCardInfo;
+    iSameContents = updateCardInfo(aCardInfo);
+    registerCardTypes(currentCardTypeIndex());
+    const TravelCardImpl::CardDesc* desc = currentCardDesc();
+    if (!iSummary || iSummary->cardType() != desc->iName) {
+        setSummary(desc->iNewSummary(this));
+        iSummary->setCardInfo(iCardInfo);
+    } else if (!iSameContents) {
+        iSummary->setCardInfo(iCardInfo);
+    }
     iCurrentStep = -1;
     TravelCard* obj = parentObject();
     if (iPageUrl != aPageUrl) {
@@ -204,6 +394,7 @@ void TravelCard::Private::onReadDone(QString aPageUrl, QVariantMap aCardInfo)
     }
     Q_EMIT obj->cardInfoChanged();
     Q_EMIT obj->cardStateChanged();
+    TRACE_EXPECT_FRAME();
 }
 
 // ==========================================================================
@@ -218,9 +409,18 @@ TravelCard::TravelCard(QObject* aParent) :
 
 void TravelCard::registerTypes(const char* aUri, int v1, int v2)
 {
-    for (int i = 0; i < (int)G_N_ELEMENTS(Private::gCardTypes); i++) {
-        Private::gCardTypes[i]->iRegisterTypes(aUri, v1, v2);
+    Private::gTypeUri = aUri;
+    Private::gTypeVersion[0] = v1;
+    Private::gTypeVersion[1] = v2;
+}
+
+uint TravelCard::nfcTechs()
+{
+    uint techs = 0;
+    for (uint i = 0; i < G_N_ELEMENTS(Private::gCardTypes); i++) {
+        techs |= Private::gCardTypes[i]->iNfcTechs;
     }
+    return techs;
 }
 
 TravelCard::CardState TravelCard::cardState() const
@@ -233,11 +433,21 @@ QVariantMap TravelCard::cardInfo() const
     return iPrivate->iCardInfo;
 }
 
+bool TravelCard::sameContents() const
+{
+    return iPrivate->iSameContents;
+}
+
 QString TravelCard::pageUrl() const
 {
     return iPrivate->iPageUrl;
 }
 
+QObject* TravelCard::summary() const
+{
+    return iPrivate->iSummary;
+}
+
 QString TravelCard::path() const
 {
     return iPrivate->iPath;
@@ -253,6 +463,13 @@ QString TravelCard::defaultCardType() const
     return Private::gCardTypes[iPrivate->iDefaultCardTypeIndex]->iName;
 }
 
+QString TravelCard::defaultPageUrl() const
+{
+    return iPrivate->iDefaultCardTypeSet ?
+        Private::gCardTypes[iPrivate->iDefaultCardTypeIndex]->iPageUrl :
+        QString();
+}
+
 void TravelCard::setDefaultCardType(QString aName)
 {
     if (iPrivate->setDefaultCardType(aName)) {
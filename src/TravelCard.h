@@ -45,9 +45,12 @@ class TravelCard : public QObject {
     Q_DISABLE_COPY(TravelCard)
     Q_PROPERTY(QString path READ path WRITE setPath NOTIFY pathChanged)
     Q_PROPERTY(QString defaultCardType READ defaultCardType WRITE setDefaultCardType NOTIFY defaultCardTypeChanged)
+    Q_PROPERTY(QString defaultPageUrl READ defaultPageUrl NOTIFY defaultCardTypeChanged)
     Q_PROPERTY(CardState cardState READ cardState NOTIFY cardStateChanged)
     Q_PROPERTY(QVariantMap cardInfo READ cardInfo NOTIFY cardInfoChanged)
+    Q_PROPERTY(bool sameContents READ sameContents NOTIFY cardInfoChanged)
     Q_PROPERTY(QString pageUrl READ pageUrl NOTIFY pageUrlChanged)
+    Q_PROPERTY(QObject* summary READ summary NOTIFY summaryChanged)
     Q_ENUMS(PeriodValidity)
     Q_ENUMS(CardState)
 
@@ -73,10 +76,28 @@ public:
     QString defaultCardType() const;
     void setDefaultCardType(QString aType);
 
+    // Page of the explicitly set default card type, empty until then.
+    // The types it needs are registered by the time it's known.
+    QString defaultPageUrl() const;
+
     CardState cardState() const;
     QVariantMap cardInfo() const;
+
+    // True if the card just recognized has exactly the same contents
+    // as the previous one (i.e. there's nothing to update)
+    bool sameContents() const;
+
     QString pageUrl() const;
 
+    // TravelCardSummary of the last recognized card, outlives the card
+    // page. Dropped when the tag isn't recognized as a travel card.
+    QObject* summary() const;
+
+    // Technologies (TravelCardImpl::NfcTech bits) of all supported cards
+    static uint nfcTechs();
+
+    // Operator specific types get registered (under this uri) only
+    // when the card type is set as the default or recognized
     static void registerTypes(const char* aUri, int v1, int v2);
 
 Q_SIGNALS:
@@ -85,6 +106,8 @@ Q_SIGNALS:
     void cardStateChanged();
     void cardInfoChanged();
     void pageUrlChanged();
+    void summaryChanged();
+    void tagLost();
 
 private:
     class Private;
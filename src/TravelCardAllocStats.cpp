@@ -0,0 +1,225 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "AllocCounter.h"
+#include "TravelCardAllocStats.h"
+
+#include "HarbourDebug.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QThread>
+#include <QtQml/QQmlEngine>
+
+#include <string.h>
+
+// ==========================================================================
+// TravelCardAllocStats::Private
+// ==========================================================================
+
+class TravelCardAllocStats::Private
+{
+public:
+    // Phases don't nest deeper than that in practice
+    enum { MAX_DEPTH = 8 };
+
+    static const char* const PHASE_NAME[PhaseCount];
+    static TravelCardAllocStats* gInstance;
+
+    Private();
+
+    static bool isMainThread();
+    void flush();
+
+public:
+    AllocCounter::Stats iPhase[PhaseCount];
+    AllocCounter::Stats iLast;
+    Phase iStack[MAX_DEPTH];
+    int iDepth;
+};
+
+const char* const TravelCardAllocStats::Private::PHASE_NAME[] = {
+    "transport", "readSucceeded", "qml", "parse"
+};
+
+TravelCardAllocStats* TravelCardAllocStats::Private::gInstance = Q_NULLPTR;
+
+TravelCardAllocStats::Private::Private() :
+    iDepth(0)
+{
+    memset(iPhase, 0, sizeof(iPhase));
+    AllocCounter::start();
+    iLast = AllocCounter::stats();
+}
+
+inline
+bool
+TravelCardAllocStats::Private::isMainThread()
+{
+    const QCoreApplication* app = QCoreApplication::instance();
+
+    return app && app->thread() == QThread::currentThread();
+}
+
+void
+TravelCardAllocStats::Private::flush()
+{
+    // Everything allocated since the last flush goes to the innermost
+    // active phase (if any)
+    const AllocCounter::Stats now(AllocCounter::stats());
+
+    if (iDepth > 0) {
+        AllocCounter::Stats* stats = iPhase + iStack[iDepth - 1];
+
+        stats->iCount += now.iCount - iLast.iCount;
+        stats->iBytes += now.iBytes - iLast.iBytes;
+    }
+    iLast = now;
+}
+
+// ==========================================================================
+// TravelCardAllocStats
+// ==========================================================================
+
+TravelCardAllocStats::TravelCardAllocStats() :
+    iPrivate(new Private)
+{
+    // QML must not delete it
+    QQmlEngine::setObjectOwnership(this, QQmlEngine::CppOwnership);
+}
+
+TravelCardAllocStats::~TravelCardAllocStats()
+{
+    delete iPrivate;
+}
+
+TravelCardAllocStats*
+TravelCardAllocStats::instance()
+{
+    if (!Private::gInstance) {
+        Private::gInstance = new TravelCardAllocStats;
+    }
+    return Private::gInstance;
+}
+
+void
+TravelCardAllocStats::reset()
+{
+    if (Private::isMainThread()) {
+        TravelCardAllocStats* self = instance();
+        Private* priv = self->iPrivate;
+
+        priv->flush();
+        memset(priv->iPhase, 0, sizeof(priv->iPhase));
+        if (!priv->iDepth) {
+            Q_EMIT self->phasesChanged();
+        }
+    }
+}
+
+void
+TravelCardAllocStats::begin(
+    Phase aPhase)
+{
+    if (Private::isMainThread()) {
+        Private* priv = instance()->iPrivate;
+
+        priv->flush();
+        if (priv->iDepth < Private::MAX_DEPTH) {
+            priv->iStack[priv->iDepth++] = aPhase;
+        } else {
+            HWARN("Too many nested phases");
+        }
+    }
+}
+
+void
+TravelCardAllocStats::end(
+    Phase aPhase)
+{
+    if (Private::isMainThread()) {
+        TravelCardAllocStats* self = instance();
+        Private* priv = self->iPrivate;
+
+        priv->flush();
+
+        // The phase being ended isn't necessarily the innermost one,
+        // e.g. transport ends when readSucceeded is already running
+        for (int i = priv->iDepth - 1; i >= 0; i--) {
+            if (priv->iStack[i] == aPhase) {
+                priv->iDepth--;
+                memmove(priv->iStack + i, priv->iStack + i + 1,
+                    sizeof(priv->iStack[0]) * (priv->iDepth - i));
+                if (!priv->iDepth) {
+                    Q_EMIT self->phasesChanged();
+                }
+                break;
+            }
+        }
+    }
+}
+
+QVariantMap
+TravelCardAllocStats::phases() const
+{
+    QVariantMap phases;
+
+    for (int i = 0; i < PhaseCount; i++) {
+        const AllocCounter::Stats* stats = iPrivate->iPhase + i;
+        QVariantMap phase;
+
+        phase.insert("count", stats->iCount);
+        phase.insert("bytes", stats->iBytes);
+        phases.insert(Private::PHASE_NAME[i], phase);
+    }
+    return phases;
+}
+
+QString
+TravelCardAllocStats::text() const
+{
+    QString text;
+
+    for (int i = 0; i < PhaseCount; i++) {
+        const AllocCounter::Stats* stats = iPrivate->iPhase + i;
+
+        text += QString::asprintf("%-14s %8llu allocs %10llu bytes\n",
+            Private::PHASE_NAME[i], (unsigned long long) stats->iCount,
+            (unsigned long long) stats->iBytes);
+    }
+    return text;
+}
@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#ifndef TRAVEL_CARD_ALLOC_STATS_H
+#define TRAVEL_CARD_ALLOC_STATS_H
+
+// Heap allocations made at each phase of reading and showing a card:
+//
+//   transport      - from startReading() until the driver has the data
+//   readSucceeded  - the driver turning the data into the card info
+//   qml            - TravelCard handing the card info over to QML
+//   parse          - parsers' setData() including the change signals
+//
+// Allocations are attributed to the innermost active phase, so the
+// numbers don't overlap. The counter is process wide though, i.e.
+// whatever the event loop allocates while waiting for the card to
+// respond ends up in the transport phase.
+//
+// Only compiled in with CONFIG+=alloc_stats, otherwise the macros
+// at the bottom expand to nothing. The numbers are available on the
+// debug page (as debug.alloc object) and printed by matkakortti-cli.
+
+#ifdef MATKAKORTTI_ALLOC_STATS
+
+#include <QtCore/QObject>
+#include <QtCore/QVariantMap>
+
+class TravelCardAllocStats :
+    public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY(TravelCardAllocStats)
+    Q_PROPERTY(QVariantMap phases READ phases NOTIFY phasesChanged)
+    Q_PROPERTY(QString text READ text NOTIFY phasesChanged)
+
+public:
+    enum Phase {
+        Transport,
+        ReadSucceeded,
+        QmlAssignment,
+        Parse,
+        PhaseCount
+    };
+
+    class Scope {
+        Q_DISABLE_COPY(Scope)
+    public:
+        Scope(Phase aPhase) : iPhase(aPhase) { begin(aPhase); }
+        ~Scope() { end(iPhase); }
+    private:
+        const Phase iPhase;
+    };
+
+    static TravelCardAllocStats* instance();
+
+    // These do nothing if invoked on a thread other than the main one
+    static void reset();
+    static void begin(Phase);
+    static void end(Phase);
+
+    QVariantMap phases() const;
+    QString text() const;
+
+Q_SIGNALS:
+    void phasesChanged(); // Emitted when no phase is active
+
+private:
+    TravelCardAllocStats();
+    ~TravelCardAllocStats();
+
+private:
+    class Private;
+    Private* iPrivate;
+};
+
+#  define ALLOC_STATS_RESET() TravelCardAllocStats::reset()
+#  define ALLOC_STATS_BEGIN(phase) \
+    TravelCardAllocStats::begin(TravelCardAllocStats::phase)
+#  define ALLOC_STATS_END(phase) \
+    TravelCardAllocStats::end(TravelCardAllocStats::phase)
+#  define ALLOC_STATS_SCOPE(phase) TravelCardAllocStats::Scope \
+    allocStatsScope(TravelCardAllocStats::phase)
+#else
+#  define ALLOC_STATS_RESET() ((void)0)
+#  define ALLOC_STATS_BEGIN(phase) ((void)0)
+#  define ALLOC_STATS_END(phase) ((void)0)
+#  define ALLOC_STATS_SCOPE(phase) ((void)0)
+#endif // MATKAKORTTI_ALLOC_STATS
+
+#endif // TRAVEL_CARD_ALLOC_STATS_H
@@ -0,0 +1,294 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "nfcdc_isodep.h"
+
+#include "TravelCardApduLog.h"
+
+#include "HarbourUtil.h"
+
+#include <QtCore/QByteArray>
+#include <QtCore/QElapsedTimer>
+
+#include <string.h>
+
+// ==========================================================================
+// TravelCardApduLog::Private
+// ==========================================================================
+
+class TravelCardApduLog::Private
+{
+public:
+    // Plenty for reading any supported card
+    enum { RING_SIZE = 0x4000 };
+
+    enum Type {
+        Command,
+        Response
+    };
+
+    // Followed by CLA INS P1 P2, Le (4 bytes) and the command data,
+    // or by SW (4 bytes) and the response data
+    struct Record {
+        quint32 iSize;      // Size of the payload
+        quint32 iType;
+        qint64 iTime;       // Nanoseconds since the first record
+    };
+
+    Private();
+
+    void put(const void*, quint32);
+    void get(quint64, void*, quint32) const;
+    void add(Type, const void*, quint32, const void*, quint32);
+    QString format(bool aTimestamps) const;
+
+public:
+    QByteArray iRing;
+    quint64 iHead;  // Total number of bytes written
+    quint64 iTail;  // Where the oldest record starts
+    QElapsedTimer iTimer;
+};
+
+TravelCardApduLog::Private::Private() :
+    iHead(0),
+    iTail(0)
+{
+}
+
+void
+TravelCardApduLog::Private::put(
+    const void* aData,
+    quint32 aSize)
+{
+    if (aSize) {
+        const uint pos = (uint)(iHead % RING_SIZE);
+        const uint part = qMin((uint)aSize, (uint)(RING_SIZE - pos));
+        char* ring = iRing.data();
+
+        memcpy(ring + pos, aData, part);
+        memcpy(ring, (const char*)aData + part, aSize - part);
+        iHead += aSize;
+    }
+}
+
+void
+TravelCardApduLog::Private::get(
+    quint64 aOffset,
+    void* aData,
+    quint32 aSize) const
+{
+    const uint pos = (uint)(aOffset % RING_SIZE);
+    const uint part = qMin((uint)aSize, (uint)(RING_SIZE - pos));
+    const char* ring = iRing.constData();
+
+    memcpy(aData, ring + pos, part);
+    memcpy((char*)aData + part, ring, aSize - part);
+}
+
+void
+TravelCardApduLog::Private::add(
+    Type aType,
+    const void* aPrefix,
+    quint32 aPrefixSize,
+    const void* aData,
+    quint32 aDataSize)
+{
+    Record rec;
+
+    if (iRing.isEmpty()) {
+        // Allocated once, on the first use
+        iRing.resize(RING_SIZE);
+    }
+    if (!iHead) {
+        iTimer.start();
+    }
+
+    // Something really huge gets truncated
+    aDataSize = qMin(aDataSize, (quint32)(RING_SIZE - sizeof(rec) -
+        aPrefixSize));
+    rec.iSize = aPrefixSize + aDataSize;
+    rec.iType = aType;
+    rec.iTime = iTimer.nsecsElapsed();
+
+    // Drop the oldest records to make room for the new one
+    const quint64 size = sizeof(rec) + rec.iSize;
+    while (iHead + size - iTail > RING_SIZE) {
+        Record old;
+
+        get(iTail, &old, sizeof(old));
+        iTail += sizeof(old) + old.iSize;
+    }
+
+    put(&rec, sizeof(rec));
+    put(aPrefix, aPrefixSize);
+    put(aData, aDataSize);
+}
+
+QString
+TravelCardApduLog::Private::format(
+    bool aTimestamps) const
+{
+    QString text;
+    QByteArray payload;
+    quint64 offset = iTail;
+    bool haveCommand = false;
+
+    while (offset < iHead) {
+        Record rec;
+
+        get(offset, &rec, sizeof(rec));
+        offset += sizeof(rec);
+        payload.resize(rec.iSize);
+        get(offset, payload.data(), rec.iSize);
+        offset += rec.iSize;
+
+        const uchar* bytes = (const uchar*)payload.constData();
+        quint32 word;
+
+        memcpy(&word, bytes + (rec.iType == Command ? 4 : 0), 4);
+        if (rec.iType == Command) {
+            const uchar* data = bytes + 8;
+            const uint size = rec.iSize - 8;
+
+            if (!text.isEmpty()) {
+                text.append('\n');
+            }
+            if (aTimestamps) {
+                text.append(QString::asprintf("[%9.3f] ", rec.iTime/1e6));
+            }
+            text.append(QString::asprintf("%02x %02x %02x %02x ",
+                bytes[0], bytes[1], bytes[2], bytes[3]));
+            if (size) {
+                text.append(HarbourUtil::toHex(data, size));
+            } else {
+                text.append('-');
+            }
+            if (word > 255) {
+                text.append(QString::asprintf(" %04x", word));
+            } else {
+                text.append(QString::asprintf(" %02x", word));
+            }
+            text.append('\n');
+            haveCommand = true;
+        } else if (haveCommand) {
+            // A response without a command means that the command
+            // has been pushed out of the ring
+            const uchar* data = bytes + 4;
+            const uint size = rec.iSize - 4;
+
+            if (aTimestamps) {
+                text.append(QString::asprintf("[%9.3f] ", rec.iTime/1e6));
+            }
+            if (size) {
+                text.append(HarbourUtil::toHex(data, size));
+                text.append(' ');
+            }
+            text.append(QString::asprintf("%02x%02x\n", (word >> 8) & 0xff,
+                word & 0xff));
+        }
+    }
+    return text;
+}
+
+// ==========================================================================
+// TravelCardApduLog
+// ==========================================================================
+
+TravelCardApduLog::TravelCardApduLog(
+    QObject* aParent) :
+    QObject(aParent),
+    iPrivate(new Private)
+{
+}
+
+TravelCardApduLog::~TravelCardApduLog()
+{
+    delete iPrivate;
+}
+
+void
+TravelCardApduLog::clear()
+{
+    // Keep the buffer
+    iPrivate->iHead = iPrivate->iTail = 0;
+}
+
+void
+TravelCardApduLog::logCommand(
+    const NfcIsoDepApdu* aApdu)
+{
+    uchar prefix[8];
+    const quint32 le = aApdu->le;
+
+    prefix[0] = aApdu->cla;
+    prefix[1] = aApdu->ins;
+    prefix[2] = aApdu->p1;
+    prefix[3] = aApdu->p2;
+    memcpy(prefix + 4, &le, 4);
+    iPrivate->add(Private::Command, prefix, sizeof(prefix),
+        aApdu->data.bytes, aApdu->data.size);
+}
+
+void
+TravelCardApduLog::logResponse(
+    const GUtilData* aData,
+    uint aSw)
+{
+    const quint32 sw = aSw;
+
+    iPrivate->add(Private::Response, &sw, sizeof(sw),
+        aData ? aData->bytes : Q_NULLPTR, aData ? aData->size : 0);
+}
+
+bool
+TravelCardApduLog::isEmpty() const
+{
+    return iPrivate->iHead == iPrivate->iTail;
+}
+
+QString
+TravelCardApduLog::text() const
+{
+    return iPrivate->format(false);
+}
+
+QString
+TravelCardApduLog::timedText() const
+{
+    return iPrivate->format(true);
+}
@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#ifndef TRAVEL_CARD_APDU_LOG_H
+#define TRAVEL_CARD_APDU_LOG_H
+
+#include "nfcdc_types.h"
+
+#include <QtCore/QObject>
+#include <QtCore/QString>
+
+// ISO-DEP transaction log. APDUs are recorded as is (along with the
+// time they were sent or received) into a fixed size ring, i.e. the
+// recording is just a memcpy and the oldest exchanges get dropped if
+// the ring fills up. The text is only produced when someone asks for
+// it, which normally happens when the debug page gets opened.
+//
+// The text is what TravelCardReplay expects, one exchange looks like:
+//
+//   90 5a 00 00 1420ef 0100
+//   9100
+class TravelCardApduLog :
+    public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY(TravelCardApduLog)
+    Q_PROPERTY(QString text READ text CONSTANT)
+
+public:
+    TravelCardApduLog(QObject* aParent = Q_NULLPTR);
+    ~TravelCardApduLog();
+
+    void clear();
+    void logCommand(const NfcIsoDepApdu*);
+    void logResponse(const GUtilData*, uint aSw);
+
+    bool isEmpty() const;
+    QString text() const;
+
+    // Prefixes each line with milliseconds since the first APDU,
+    // the result can't be replayed
+    Q_INVOKABLE QString timedText() const;
+
+private:
+    class Private;
+    Private* iPrivate;
+};
+
+#endif // TRAVEL_CARD_APDU_LOG_H
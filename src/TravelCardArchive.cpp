@@ -0,0 +1,573 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "TravelCardArchive.h"
+
+#include "HarbourDebug.h"
+
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QPair>
+#include <QtCore/QSaveFile>
+#include <QtCore/QStandardPaths>
+#include <QtCore/QVector>
+
+#include <algorithm>
+
+#include <string.h>
+
+// File layout:
+//
+// +===========================================================+
+// | Offset | Size | Description                               |
+// +===========================================================+
+// | 0      | 4    | Magic "MKHA"                              |
+// | 4      | 1    | Format version (2)                        |
+// | 5      | 1    | Record size                               |
+// | 6      | 2    | Reserved (zeros)                          |
+// | 8      | ...  | Records                                   |
+// +===========================================================+
+//
+// Records are sorted by time, oldest first. New records are normally
+// more recent than the archived ones and simply get appended to the
+// file, otherwise the whole file is rewritten.
+//
+// A partial record at the end of the file (e.g. after a crash) is ignored
+// and gets discarded by the next append. A file which can't be used at all
+// (bad header, unknown version or a different record size) is treated as
+// empty. Opening the archive never writes anything, it's the next append
+// that renames such a file to *.bad and starts from scratch.
+
+// ==========================================================================
+// TravelCardArchive::Private
+// ==========================================================================
+
+class TravelCardArchive::Private
+{
+public:
+    enum {
+        HEADER_SIZE = 8,
+        VERSION = 2
+    };
+
+    static const char MAGIC[4];
+    static const char ARCHIVE_DIR[];
+
+    Private(const QString&, const QString&, uint, RecordTime);
+    ~Private();
+
+    typedef QPair<quint64,int> SortKey;
+
+    static QString archiveDir();
+    static bool isEmptyRecord(const uchar*, uint);
+    static bool isEarlier(const SortKey&, const SortKey&);
+    static bool isLater(const SortKey&, const SortKey&);
+    static bool containsRecord(const QByteArray&, const uchar*, uint);
+    static QByteArray sorted(const QByteArray&, uint, RecordTime, bool);
+
+    const uchar* recordData(int) const;
+    quint64 timeAt(int) const;
+    bool contains(const uchar*) const;
+    QByteArray sorted(const QByteArray&) const;
+
+    void open();
+    void discard();
+    void close();
+    bool save(const QByteArray&);
+    bool appendToFile(const QByteArray&);
+
+public:
+    const uint iRecordSize;
+    const RecordTime iTime;
+    QString iPath;
+    QFile iFile;
+    const uchar* iMap;
+    int iCount;
+    bool iValid;
+    bool iBad;
+};
+
+const char TravelCardArchive::Private::MAGIC[4] = { 'M', 'K', 'H', 'A' };
+const char TravelCardArchive::Private::ARCHIVE_DIR[] = "archive";
+
+TravelCardArchive::Private::Private(
+    const QString& aCardType,
+    const QString& aCardNumber,
+    uint aRecordSize,
+    RecordTime aTime) :
+    iRecordSize(aRecordSize),
+    iTime(aTime),
+    iMap(Q_NULLPTR),
+    iCount(0),
+    iValid(false),
+    iBad(false)
+{
+    if (iRecordSize > 0 && iRecordSize < 0x100 && iTime &&
+        !aCardType.isEmpty() && !aCardNumber.isEmpty()) {
+        iPath = archiveDir() + QDir::separator() + aCardType.toLower() +
+            QLatin1Char('-') + aCardNumber.toLower();
+        iValid = true;
+        open();
+    }
+}
+
+TravelCardArchive::Private::~Private()
+{
+    close();
+}
+
+QString
+TravelCardArchive::Private::archiveDir()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) +
+        QDir::separator() + QLatin1String(ARCHIVE_DIR);
+}
+
+bool
+TravelCardArchive::Private::isEmptyRecord(
+    const uchar* aRecord,
+    uint aSize)
+{
+    for (uint i = 0; i < aSize; i++) {
+        if (aRecord[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool
+TravelCardArchive::Private::isEarlier(
+    const SortKey& aKey1,
+    const SortKey& aKey2)
+{
+    return aKey1.first < aKey2.first;
+}
+
+bool
+TravelCardArchive::Private::isLater(
+    const SortKey& aKey1,
+    const SortKey& aKey2)
+{
+    return aKey1.first > aKey2.first;
+}
+
+bool
+TravelCardArchive::Private::containsRecord(
+    const QByteArray& aRecords,
+    const uchar* aRecord,
+    uint aSize)
+{
+    const uchar* ptr = (const uchar*)aRecords.constData();
+    const int n = aRecords.size() / aSize;
+
+    for (int i = 0; i < n; i++) {
+        if (!memcmp(ptr + i * aSize, aRecord, aSize)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+inline
+const uchar*
+TravelCardArchive::Private::recordData(
+    int aIndex) const
+{
+    return iMap + aIndex * iRecordSize;
+}
+
+inline
+quint64
+TravelCardArchive::Private::timeAt(
+    int aIndex) const
+{
+    return iTime(recordData(aIndex));
+}
+
+bool
+TravelCardArchive::Private::contains(
+    const uchar* aRecord) const
+{
+    const quint64 time = iTime(aRecord);
+    int low = 0;
+    int high = iCount;
+
+    // Binary search for the first record which is not earlier
+    while (low < high) {
+        const int mid = (low + high) / 2;
+
+        if (timeAt(mid) < time) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    // And check all records with the same time
+    for (int i = low; i < iCount && timeAt(i) == time; i++) {
+        if (!memcmp(recordData(i), aRecord, iRecordSize)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+QByteArray
+TravelCardArchive::Private::sorted(
+    const QByteArray& aRecords,
+    uint aRecordSize,
+    RecordTime aTime,
+    bool aNewestFirst)
+{
+    const uchar* ptr = (const uchar*)aRecords.constData();
+    const int n = aRecords.size() / aRecordSize;
+    QVector<SortKey> keys;
+
+    keys.reserve(n);
+    for (int i = 0; i < n; i++) {
+        keys.append(SortKey(aTime(ptr + i * aRecordSize), i));
+    }
+    std::stable_sort(keys.begin(), keys.end(), aNewestFirst ?
+        isLater : isEarlier);
+
+    QByteArray result;
+
+    result.reserve(n * aRecordSize);
+    for (int i = 0; i < n; i++) {
+        result.append((const char*)ptr + keys.at(i).second * aRecordSize,
+            aRecordSize);
+    }
+    return result;
+}
+
+inline
+QByteArray
+TravelCardArchive::Private::sorted(
+    const QByteArray& aRecords) const
+{
+    return sorted(aRecords, iRecordSize, iTime, false);
+}
+
+void
+TravelCardArchive::Private::open()
+{
+    iFile.setFileName(iPath);
+    if (iFile.open(QIODevice::ReadOnly)) {
+        const QByteArray header(iFile.read(HEADER_SIZE));
+
+        if (header.size() == HEADER_SIZE &&
+            !memcmp(header.constData(), MAGIC, sizeof(MAGIC)) &&
+            header.at(4) == VERSION &&
+            (uchar)header.at(5) == iRecordSize) {
+            const int n = (int)((iFile.size() - HEADER_SIZE) / iRecordSize);
+
+            if (n > 0) {
+                iMap = iFile.map(HEADER_SIZE, (qint64)n * iRecordSize);
+                if (iMap) {
+                    iCount = n;
+                } else {
+                    HWARN("Failed to map" << qPrintable(iPath) <<
+                        iFile.errorString());
+                    iValid = false;
+                }
+            }
+            HDEBUG(qPrintable(iPath) << iCount << "record(s)");
+            return;
+        }
+        HWARN("Can't use" << qPrintable(iPath));
+        iFile.close();
+        iBad = true;
+    }
+}
+
+void
+TravelCardArchive::Private::discard()
+{
+    // The file is either corrupt or belongs to a different version of
+    // the app. Either way, there's no way to add anything to it. Move it
+    // out of the way (rather than deleting, just in case) and start over.
+    const QString badPath(iPath + QLatin1String(".bad"));
+
+    iBad = false;
+    QFile::remove(badPath);
+    if (QFile::rename(iPath, badPath)) {
+        HWARN("Moved" << qPrintable(iPath) << "to" << qPrintable(badPath));
+    } else if (QFile::remove(iPath)) {
+        HWARN("Removed" << qPrintable(iPath));
+    } else {
+        HWARN("Failed to discard" << qPrintable(iPath));
+        iValid = false;
+    }
+}
+
+void
+TravelCardArchive::Private::close()
+{
+    if (iMap) {
+        iFile.unmap((uchar*)iMap);
+        iMap = Q_NULLPTR;
+    }
+    iFile.close();
+    iCount = 0;
+}
+
+bool
+TravelCardArchive::Private::save(
+    const QByteArray& aRecords)
+{
+    QSaveFile file(iPath);
+    char header[HEADER_SIZE];
+
+    memset(header, 0, sizeof(header));
+    memcpy(header, MAGIC, sizeof(MAGIC));
+    header[4] = VERSION;
+    header[5] = (char)iRecordSize;
+
+    close();
+    QDir().mkpath(archiveDir());
+    if (file.open(QIODevice::WriteOnly) &&
+        file.write(header, sizeof(header)) == sizeof(header) &&
+        file.write(aRecords) == aRecords.size() &&
+        file.commit()) {
+        return true;
+    } else {
+        HWARN("Failed to write" << qPrintable(iPath) << file.errorString());
+        return false;
+    }
+}
+
+bool
+TravelCardArchive::Private::appendToFile(
+    const QByteArray& aRecords)
+{
+    if (iCount > 0) {
+        const qint64 validSize = HEADER_SIZE + (qint64)iCount * iRecordSize;
+
+        close();
+
+        QFile file(iPath);
+
+        if (file.open(QIODevice::ReadWrite) &&
+            (file.size() == validSize || file.resize(validSize)) &&
+            file.seek(validSize) &&
+            file.write(aRecords) == aRecords.size()) {
+            return true;
+        } else {
+            HWARN("Failed to write" << qPrintable(iPath) <<
+                file.errorString());
+            return false;
+        }
+    } else {
+        return save(aRecords);
+    }
+}
+
+// ==========================================================================
+// TravelCardArchive
+// ==========================================================================
+
+TravelCardArchive::TravelCardArchive(
+    const QString& aCardType,
+    const QString& aCardNumber,
+    uint aRecordSize,
+    RecordTime aTime) :
+    iPrivate(new Private(aCardType, aCardNumber, aRecordSize, aTime))
+{
+}
+
+TravelCardArchive::~TravelCardArchive()
+{
+    delete iPrivate;
+}
+
+bool
+TravelCardArchive::isValid() const
+{
+    return iPrivate->iValid;
+}
+
+uint
+TravelCardArchive::recordSize() const
+{
+    return iPrivate->iRecordSize;
+}
+
+int
+TravelCardArchive::count() const
+{
+    return iPrivate->iCount;
+}
+
+const uchar*
+TravelCardArchive::recordData(
+    int aIndex) const
+{
+    return (aIndex >= 0 && aIndex < iPrivate->iCount) ?
+        iPrivate->recordData(aIndex) : Q_NULLPTR;
+}
+
+QByteArray
+TravelCardArchive::recordAt(
+    int aIndex) const
+{
+    const uchar* data = recordData(aIndex);
+
+    return data ? QByteArray((const char*)data, iPrivate->iRecordSize) :
+        QByteArray();
+}
+
+bool
+TravelCardArchive::contains(
+    const uchar* aRecord) const
+{
+    return iPrivate->iValid && iPrivate->contains(aRecord);
+}
+
+bool
+TravelCardArchive::containsAll(
+    const QByteArray& aRecords) const
+{
+    if (iPrivate->iValid) {
+        const uint size = iPrivate->iRecordSize;
+        const uchar* ptr = (const uchar*)aRecords.constData();
+        const int n = aRecords.size() / size;
+
+        for (int i = 0; i < n; i++) {
+            const uchar* record = ptr + i * size;
+
+            if (!Private::isEmptyRecord(record, size) &&
+                !iPrivate->contains(record)) {
+                return false;
+            }
+        }
+        return true;
+    }
+    return false;
+}
+
+int
+TravelCardArchive::append(
+    const QByteArray& aRecords)
+{
+    int appended = 0;
+
+    if (iPrivate->iValid) {
+        const uint size = iPrivate->iRecordSize;
+        const uchar* ptr = (const uchar*)aRecords.constData();
+        const int n = aRecords.size() / size;
+        QByteArray data;
+
+        for (int i = 0; i < n; i++) {
+            const uchar* record = ptr + i * size;
+
+            if (!Private::isEmptyRecord(record, size) &&
+                !iPrivate->contains(record) &&
+                !Private::containsRecord(data, record, size)) {
+                data.append((const char*)record, size);
+                appended++;
+            }
+        }
+
+        if (appended && iPrivate->iBad) {
+            iPrivate->discard();
+        }
+
+        if (appended && iPrivate->iValid) {
+            const int count = iPrivate->iCount;
+            const QByteArray added(iPrivate->sorted(data));
+            bool ok;
+
+            if (!count || iPrivate->iTime((const uchar*)added.constData()) >=
+                iPrivate->timeAt(count - 1)) {
+                // The usual case - everything new is more recent
+                ok = iPrivate->appendToFile(added);
+            } else {
+                // Something from the past, the order has to be restored
+                QByteArray all((const char*)iPrivate->iMap, count * size);
+
+                all.append(added);
+                ok = iPrivate->save(iPrivate->sorted(all));
+            }
+
+            // Map the updated file
+            iPrivate->close();
+            iPrivate->open();
+            if (ok) {
+                HDEBUG(appended << "record(s) added to" <<
+                    qPrintable(iPrivate->iPath));
+            } else {
+                appended = 0;
+            }
+        }
+    }
+    return appended;
+}
+
+QByteArray
+TravelCardArchive::newestFirst(
+    const QByteArray& aRecords,
+    uint aRecordSize,
+    RecordTime aTime)
+{
+    const uchar* ptr = (const uchar*)aRecords.constData();
+    const int n = aRecords.size() / aRecordSize;
+    QByteArray records;
+
+    records.reserve(n * aRecordSize);
+    for (int i = 0; i < n; i++) {
+        const uchar* record = ptr + i * aRecordSize;
+
+        if (!Private::isEmptyRecord(record, aRecordSize)) {
+            records.append((const char*)record, aRecordSize);
+        }
+    }
+    return Private::sorted(records, aRecordSize, aTime, true);
+}
+
+int
+TravelCardArchive::store(
+    const QString& aCardType,
+    const QString& aCardNumber,
+    uint aRecordSize,
+    RecordTime aTime,
+    const QByteArray& aRecords)
+{
+    return TravelCardArchive(aCardType, aCardNumber, aRecordSize, aTime).
+        append(aRecords);
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#ifndef TRAVEL_CARD_ARCHIVE_H
+#define TRAVEL_CARD_ARCHIVE_H
+
+#include <QtCore/QByteArray>
+#include <QtCore/QString>
+
+// Archive of fixed size history records, one file per card. The card
+// type and number determine the file name, so opening the archive for
+// one card doesn't touch the records of any other card.
+//
+// Records are kept sorted by time (oldest first) and the file is mapped
+// into memory read-only, so opening the archive costs the same no matter
+// how many records it contains and the records can be accessed directly
+// without copying them anywhere.
+class TravelCardArchive
+{
+    Q_DISABLE_COPY(TravelCardArchive)
+
+public:
+    // Sort key of a record, provided by the card specific code
+    typedef quint64 (*RecordTime)(const uchar*);
+
+    TravelCardArchive(const QString& aCardType, const QString& aCardNumber,
+        uint aRecordSize, RecordTime aTime);
+    ~TravelCardArchive();
+
+    bool isValid() const;
+    uint recordSize() const;
+    int count() const;
+    const uchar* recordData(int) const; // Points to the mapped file
+    QByteArray recordAt(int) const;
+    bool contains(const uchar*) const;
+    bool containsAll(const QByteArray&) const; // Ignores empty records
+
+    // Inserts the records which aren't in the archive yet,
+    // returns the number of records actually added.
+    int append(const QByteArray&);
+
+    // Non-empty records sorted by time, the most recent first. That's
+    // the order in which the card models show the history, whether it
+    // comes from the archive or straight from the card.
+    static QByteArray newestFirst(const QByteArray& aRecords,
+        uint aRecordSize, RecordTime aTime);
+
+    // Convenience shortcut for card drivers
+    static int store(const QString& aCardType, const QString& aCardNumber,
+        uint aRecordSize, RecordTime aTime, const QByteArray& aRecords);
+
+private:
+    class Private;
+    Private* iPrivate;
+};
+
+#endif // TRAVEL_CARD_ARCHIVE_H
@@ -0,0 +1,360 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "TravelCardDump.h"
+#include "Util.h"
+
+#include "HarbourDebug.h"
+#include "HarbourUtil.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QSaveFile>
+#include <QtCore/QStringList>
+#include <QtCore/QtEndian>
+
+#include <string.h>
+
+#ifndef APP_VERSION
+#  define APP_VERSION ""
+#endif
+
+// All numbers are little-endian, strings are ASCII prefixed with
+// one byte length:
+//
+//   Magic               "MKDP"
+//   Format version      1 byte
+//   Reserved            1 byte (zero)
+//   Timestamp           8 bytes (milliseconds since 1970-01-01 UTC)
+//   Card type           string
+//   App version         string
+//   Number of blocks    2 bytes
+//
+// followed by the blocks:
+//
+//   Name                string
+//   Number of SWs       1 byte
+//   Status words        2 bytes each
+//   Data size           4 bytes
+//   Data                Data size bytes
+
+namespace {
+    const char MAGIC[4] = { 'M', 'K', 'D', 'P' };
+    const uchar VERSION = 1;
+    const int FIXED_HEADER_SIZE = 14;
+    const QString DATA_SUFFIX("Data");
+    const QString STATUS_SUFFIX("Status");
+}
+
+const char TravelCardDump::SUFFIX[] = ".mkd";
+const char TravelCardDump::DIR_ENV[] = "MATKAKORTTI_DUMP_DIR";
+
+TravelCardDump::TravelCardDump()
+{
+}
+
+TravelCardDump::TravelCardDump(
+    const QString& aCardType) :
+    iCardType(aCardType),
+    iTimestamp(QDateTime::currentDateTimeUtc()),
+    iAppVersion(QLatin1String(APP_VERSION))
+{
+}
+
+void
+TravelCardDump::addBlock(
+    const QString& aName,
+    const QByteArray& aData)
+{
+    Block block;
+
+    block.iName = aName;
+    block.iData = aData;
+    iBlocks.append(block);
+}
+
+void
+TravelCardDump::addBlock(
+    const QString& aName,
+    const QByteArray& aData,
+    uint aSw1,
+    uint aSw2)
+{
+    Block block;
+
+    block.iName = aName;
+    block.iStatus.append(aSw1);
+    block.iStatus.append(aSw2);
+    block.iData = aData;
+    iBlocks.append(block);
+}
+
+const TravelCardDump::Block*
+TravelCardDump::block(
+    const QString& aName) const
+{
+    for (int i = 0; i < iBlocks.count(); i++) {
+        if (iBlocks.at(i).iName == aName) {
+            return &iBlocks.at(i);
+        }
+    }
+    return Q_NULLPTR;
+}
+
+QVariantMap
+TravelCardDump::cardInfo() const
+{
+    QVariantMap info;
+
+    info.insert(Util::CARD_TYPE_KEY, iCardType);
+    for (int i = 0; i < iBlocks.count(); i++) {
+        const Block& block = iBlocks.at(i);
+
+        if (block.iStatus.isEmpty()) {
+            info.insert(block.iName, HarbourUtil::toHex(block.iData));
+        } else {
+            info.insert(block.iName + DATA_SUFFIX,
+                HarbourUtil::toHex(block.iData));
+            for (int k = 0; k < block.iStatus.count(); k++) {
+                info.insert(block.iName + STATUS_SUFFIX + QString::number(k + 1),
+                    QString::asprintf("%04x", block.iStatus.at(k)));
+            }
+        }
+    }
+    return info;
+}
+
+TravelCardDump
+TravelCardDump::fromCardInfo(
+    const QVariantMap& aCardInfo)
+{
+    TravelCardDump dump;
+    const QStringList keys(aCardInfo.keys());
+
+    dump.iCardType = aCardInfo.value(Util::CARD_TYPE_KEY).toString();
+    for (int i = 0; i < keys.count(); i++) {
+        const QString& key = keys.at(i);
+        const QVariant value(aCardInfo.value(key));
+
+        // Skip cardType, debug info and the status keys
+        if (value.userType() != QMetaType::QString ||
+            key == Util::CARD_TYPE_KEY || key.contains(STATUS_SUFFIX)) {
+            continue;
+        }
+
+        Block block;
+
+        block.iData = QByteArray::fromHex(value.toString().toLatin1());
+        if (key.endsWith(DATA_SUFFIX)) {
+            const QString name(key.left(key.length() - DATA_SUFFIX.length()));
+            const QString status(name + STATUS_SUFFIX);
+            bool ok = true;
+
+            for (int k = 1; ok; k++) {
+                const QString sw(aCardInfo.value(status + QString::number(k)).
+                    toString());
+
+                if (!sw.isEmpty()) {
+                    block.iStatus.append(sw.toUInt(&ok, 16));
+                } else {
+                    ok = false;
+                }
+            }
+            if (!block.iStatus.isEmpty()) {
+                block.iName = name;
+            }
+        }
+        if (block.iName.isEmpty()) {
+            block.iName = key;
+        }
+        dump.iBlocks.append(block);
+    }
+    return dump;
+}
+
+QByteArray
+TravelCardDump::toByteArray() const
+{
+    const QByteArray type(iCardType.toLatin1().left(255));
+    const QByteArray version(iAppVersion.toLatin1().left(255));
+    uchar num[8];
+    QByteArray out;
+
+    out.append(MAGIC, sizeof(MAGIC));
+    out.append((char)VERSION);
+    out.append((char)0);
+    qToLittleEndian<qint64>(iTimestamp.isValid() ?
+        iTimestamp.toMSecsSinceEpoch() : 0, num);
+    out.append((const char*)num, 8);
+    out.append((char)type.size());
+    out.append(type);
+    out.append((char)version.size());
+    out.append(version);
+    qToLittleEndian<quint16>(iBlocks.count(), num);
+    out.append((const char*)num, 2);
+    for (int i = 0; i < iBlocks.count(); i++) {
+        const Block& block = iBlocks.at(i);
+        const QByteArray name(block.iName.toLatin1().left(255));
+        const int nsw = qMin(block.iStatus.count(), 255);
+
+        out.append((char)name.size());
+        out.append(name);
+        out.append((char)nsw);
+        for (int k = 0; k < nsw; k++) {
+            qToLittleEndian<quint16>(block.iStatus.at(k), num);
+            out.append((const char*)num, 2);
+        }
+        qToLittleEndian<quint32>(block.iData.size(), num);
+        out.append((const char*)num, 4);
+        out.append(block.iData);
+    }
+    return out;
+}
+
+QString
+TravelCardDump::defaultFileName() const
+{
+    return iCardType + QLatin1Char('-') + iTimestamp.toUTC().
+        toString(QStringLiteral("yyyyMMdd-hhmmsszzz")) +
+        QLatin1String(SUFFIX);
+}
+
+bool
+TravelCardDump::save(
+    const QString& aFileName) const
+{
+    QSaveFile file(aFileName);
+
+    if (file.open(QIODevice::WriteOnly) &&
+        file.write(toByteArray()) >= 0 &&
+        file.commit()) {
+        HDEBUG("Saved" << qPrintable(aFileName));
+        return true;
+    }
+    HWARN("Failed to write" << qPrintable(aFileName));
+    return false;
+}
+
+bool
+TravelCardDump::isDump(
+    const QByteArray& aData)
+{
+    return aData.size() >= FIXED_HEADER_SIZE &&
+        !memcmp(aData.constData(), MAGIC, sizeof(MAGIC));
+}
+
+bool
+TravelCardDump::parse(
+    const QByteArray& aData,
+    int* aOffset,
+    TravelCardDump* aDump)
+{
+    const uchar* start = (const uchar*)aData.constData() + *aOffset;
+    const uchar* end = (const uchar*)aData.constData() + aData.size();
+    const uchar* ptr = start;
+    TravelCardDump dump;
+
+    #define NEED(n) if ((end - ptr) < (n)) return false
+    #define STRING(s) NEED(1); NEED(1 + ptr[0]); \
+        s = QString::fromLatin1((const char*)ptr + 1, ptr[0]); ptr += 1 + ptr[0]
+    NEED(FIXED_HEADER_SIZE);
+    if (memcmp(ptr, MAGIC, sizeof(MAGIC)) || ptr[4] != VERSION) {
+        HWARN("Not a dump or unsupported version");
+        return false;
+    }
+    dump.iTimestamp = QDateTime::fromMSecsSinceEpoch(qFromLittleEndian<qint64>
+        (ptr + 6), Qt::UTC);
+    ptr += FIXED_HEADER_SIZE;
+    STRING(dump.iCardType);
+    STRING(dump.iAppVersion);
+    NEED(2);
+    const int n = qFromLittleEndian<quint16>(ptr);
+    ptr += 2;
+    for (int i = 0; i < n; i++) {
+        Block block;
+
+        STRING(block.iName);
+        NEED(1);
+        const int nsw = *ptr++;
+        NEED(2 * nsw);
+        for (int k = 0; k < nsw; k++, ptr += 2) {
+            block.iStatus.append(qFromLittleEndian<quint16>(ptr));
+        }
+        NEED(4);
+        const quint32 size = qFromLittleEndian<quint32>(ptr);
+        ptr += 4;
+        NEED((qint64)size);
+        block.iData = QByteArray((const char*)ptr, size);
+        ptr += size;
+        dump.iBlocks.append(block);
+    }
+    #undef STRING
+    #undef NEED
+
+    *aOffset += (int)(ptr - start);
+    *aDump = dump;
+    return true;
+}
+
+bool
+TravelCardDump::load(
+    const QString& aFileName,
+    QList<TravelCardDump>* aDumps)
+{
+    QFile file(aFileName);
+
+    if (file.open(QIODevice::ReadOnly)) {
+        const QByteArray data(file.readAll());
+        int offset = 0;
+
+        if (isDump(data)) {
+            while (offset < data.size()) {
+                TravelCardDump dump;
+
+                if (parse(data, &offset, &dump)) {
+                    aDumps->append(dump);
+                } else {
+                    HWARN("Garbage at offset" << offset << "in" <<
+                        qPrintable(aFileName));
+                    break;
+                }
+            }
+            return offset == data.size();
+        }
+    }
+    return false;
+}
@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#ifndef TRAVEL_CARD_DUMP_H
+#define TRAVEL_CARD_DUMP_H
+
+#include <QtCore/QByteArray>
+#include <QtCore/QDateTime>
+#include <QtCore/QList>
+#include <QtCore/QString>
+#include <QtCore/QVariantMap>
+
+// Raw contents of a card, as read by the card driver. The binary
+// form (see TravelCardDump.cpp for the layout) is what gets saved to
+// MATKAKORTTI_DUMP_DIR after each successful read (if the variable is
+// set and the build has CONFIG+=transports, i.e. not by the app itself)
+// and what the replay transport and the batch decoder read
+// without going through hex strings. Several dumps can be simply
+// concatenated into one file.
+//
+// Blocks without status words turn into "<name>" card info keys,
+// blocks with status words into "<name>Data" and "<name>StatusN",
+// which is what the HSL and Nysse pages respectively expect.
+class TravelCardDump
+{
+public:
+    struct Block {
+        QString iName;
+        QList<uint> iStatus;    // Only if the driver keeps track of them
+        QByteArray iData;
+    };
+
+    static const char SUFFIX[];     // ".mkd"
+    static const char DIR_ENV[];    // "MATKAKORTTI_DUMP_DIR"
+
+    TravelCardDump();
+    TravelCardDump(const QString& aCardType); // Timestamped now
+
+    void addBlock(const QString&, const QByteArray&);
+    void addBlock(const QString&, const QByteArray&, uint aSw1, uint aSw2);
+    const Block* block(const QString&) const;
+
+    QVariantMap cardInfo() const;
+    static TravelCardDump fromCardInfo(const QVariantMap&);
+
+    QByteArray toByteArray() const;
+    QString defaultFileName() const;
+    bool save(const QString& aFileName) const;
+
+    // Parses the dump at the offset and moves the offset past it
+    static bool parse(const QByteArray&, int* aOffset, TravelCardDump*);
+    static bool isDump(const QByteArray&);
+    static bool load(const QString& aFileName, QList<TravelCardDump>*);
+
+public:
+    QString iCardType;
+    QDateTime iTimestamp;
+    QString iAppVersion;
+    QList<Block> iBlocks;
+};
+
+#endif // TRAVEL_CARD_DUMP_H
@@ -0,0 +1,623 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "TravelCardDump.h"
+#include "TravelCardEmulator.h"
+#include "Util.h"
+
+#include "hsl/HslCard.h"
+#include "nysse/NysseCard.h"
+
+#include "HarbourDebug.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QStringList>
+
+// Text config syntax (one statement per line, # starts a comment):
+//
+//   frame <size>                       Max data bytes per response
+//   delay <ms>                         Delay of each response
+//   fail <n>                           APDU #n (0-based) and later fail
+//   app <aid>                          Starts a new application
+//   data <file> <hex>                  Standard data file
+//   record <file> <size> <hex>         Cyclic record file
+//   value <file> <hex>                 Value file (4 bytes LE)
+//
+// File numbers and AIDs are hex, sizes and numbers are decimal.
+// Records are listed in the order ReadRecords returns them, i.e.
+// the most recent one first.
+
+// ==========================================================================
+// TravelCardEmulator::Private
+// ==========================================================================
+
+class TravelCardEmulator::Private
+{
+public:
+    enum {
+        CLA = 0x90,
+        INS_SELECT = 0x5a,
+        INS_READ_DATA = 0xbd,
+        INS_READ_RECORDS = 0xbb,
+        INS_GET_FILE_SETTINGS = 0xf5,
+        INS_GET_VALUE = 0x6c,
+        INS_MORE = 0xaf
+    };
+
+    static const uint SW_OK = NFC_ISODEP_SW(0x91, 0x00);
+    static const uint SW_MORE = NFC_ISODEP_SW(0x91, 0xaf);
+    static const uint SW_ILLEGAL_COMMAND = NFC_ISODEP_SW(0x91, 0x1c);
+    static const uint SW_LENGTH_ERROR = NFC_ISODEP_SW(0x91, 0x7e);
+    static const uint SW_PARAMETER_ERROR = NFC_ISODEP_SW(0x91, 0x9e);
+    static const uint SW_APP_NOT_FOUND = NFC_ISODEP_SW(0x91, 0xa0);
+    static const uint SW_BOUNDARY_ERROR = NFC_ISODEP_SW(0x91, 0xbe);
+    static const uint SW_COMMAND_ABORTED = NFC_ISODEP_SW(0x91, 0xca);
+    static const uint SW_FILE_NOT_FOUND = NFC_ISODEP_SW(0x91, 0xf0);
+    static const uint SW_CLA_NOT_SUPPORTED = NFC_ISODEP_SW(0x6e, 0x00);
+
+    Private(const Config&);
+
+    static uint uint24le(const guint8*);
+    static void appendUint24le(QByteArray*, uint);
+    static void appendUint32le(QByteArray*, guint32);
+    static bool parseLine(const QStringList&, Config*);
+
+    const File* findFile(uint) const;
+    uint process(const NfcIsoDepApdu*, QByteArray*);
+    uint readData(const GUtilData*, QByteArray*) const;
+    uint readRecords(const GUtilData*, QByteArray*) const;
+    uint getFileSettings(const GUtilData*, QByteArray*) const;
+    uint getValue(const GUtilData*, QByteArray*) const;
+    uint frame(const QByteArray&, QByteArray*);
+
+public:
+    const Config iConfig;
+    const Application* iSelectedApp;
+    QByteArray iMoreData;
+    int iCount;
+};
+
+TravelCardEmulator::Private::Private(
+    const Config& aConfig) :
+    iConfig(aConfig),
+    iSelectedApp(Q_NULLPTR),
+    iCount(0)
+{
+}
+
+inline
+uint
+TravelCardEmulator::Private::uint24le(
+    const guint8* aBytes)
+{
+    return aBytes[0] | ((uint)aBytes[1] << 8) | ((uint)aBytes[2] << 16);
+}
+
+void
+TravelCardEmulator::Private::appendUint24le(
+    QByteArray* aBytes,
+    uint aValue)
+{
+    aBytes->append((char)aValue);
+    aBytes->append((char)(aValue >> 8));
+    aBytes->append((char)(aValue >> 16));
+}
+
+void
+TravelCardEmulator::Private::appendUint32le(
+    QByteArray* aBytes,
+    guint32 aValue)
+{
+    appendUint24le(aBytes, aValue);
+    aBytes->append((char)(aValue >> 24));
+}
+
+const TravelCardEmulator::File*
+TravelCardEmulator::Private::findFile(
+    uint aNo) const
+{
+    if (iSelectedApp) {
+        const QList<File>& files = iSelectedApp->iFiles;
+        const int n = files.count();
+
+        for (int i = 0; i < n; i++) {
+            const File* file = &files.at(i);
+
+            if (file->iNo == aNo) {
+                return file;
+            }
+        }
+    }
+    return Q_NULLPTR;
+}
+
+uint
+TravelCardEmulator::Private::frame(
+    const QByteArray& aData,
+    QByteArray* aResponse)
+{
+    if (aData.size() > iConfig.iFrameSize) {
+        *aResponse = aData.left(iConfig.iFrameSize);
+        iMoreData = aData.mid(iConfig.iFrameSize);
+        return SW_MORE;
+    } else {
+        *aResponse = aData;
+        return SW_OK;
+    }
+}
+
+uint
+TravelCardEmulator::Private::readData(
+    const GUtilData* aData,
+    QByteArray* aResponse) const
+{
+    // File number, offset (3 bytes LE), length (3 bytes LE)
+    if (aData->size == 7) {
+        const File* file = findFile(aData->bytes[0]);
+
+        if (!file) {
+            return SW_FILE_NOT_FOUND;
+        } else if (file->iType != DataFile) {
+            return SW_PARAMETER_ERROR;
+        } else {
+            const uint size = file->iData.size();
+            const uint offset = uint24le(aData->bytes + 1);
+            const uint length = uint24le(aData->bytes + 4);
+
+            // Zero length means everything up to the end of the file
+            if (offset > size || (length && (offset + length) > size)) {
+                return SW_BOUNDARY_ERROR;
+            }
+            *aResponse = file->iData.mid(offset, length ? length : -1);
+            return SW_OK;
+        }
+    }
+    return SW_LENGTH_ERROR;
+}
+
+uint
+TravelCardEmulator::Private::readRecords(
+    const GUtilData* aData,
+    QByteArray* aResponse) const
+{
+    // File number, record offset (3 bytes LE), count (3 bytes LE)
+    if (aData->size == 7) {
+        const File* file = findFile(aData->bytes[0]);
+
+        if (!file) {
+            return SW_FILE_NOT_FOUND;
+        } else if (file->iType != RecordFile || !file->iRecordSize) {
+            return SW_PARAMETER_ERROR;
+        } else {
+            const uint size = file->iRecordSize;
+            const uint total = file->iData.size() / size;
+            const uint offset = uint24le(aData->bytes + 1);
+            const uint count = uint24le(aData->bytes + 4);
+
+            // Zero count means all records starting from the offset
+            if (offset >= total || (count && (offset + count) > total)) {
+                return SW_BOUNDARY_ERROR;
+            }
+            *aResponse = file->iData.mid(offset * size,
+                (count ? count : (total - offset)) * size);
+            return SW_OK;
+        }
+    }
+    return SW_LENGTH_ERROR;
+}
+
+uint
+TravelCardEmulator::Private::getFileSettings(
+    const GUtilData* aData,
+    QByteArray* aResponse) const
+{
+    if (aData->size == 1) {
+        const File* file = findFile(aData->bytes[0]);
+
+        if (file) {
+            const uint size = file->iData.size();
+            QByteArray settings;
+
+            // File type, communication mode (plain), access rights (free)
+            settings.append((char)(file->iType == DataFile ? 0x00 :
+                file->iType == ValueFile ? 0x02 : 0x04));
+            settings.append((char)0x00);
+            settings.append((char)0xee);
+            settings.append((char)0xee);
+            switch (file->iType) {
+            case DataFile:
+                appendUint24le(&settings, size);
+                break;
+            case ValueFile:
+                appendUint32le(&settings, 0);           // Lower limit
+                appendUint32le(&settings, 0x7fffffff);  // Upper limit
+                appendUint32le(&settings, 0);           // Limited credit
+                settings.append((char)0x00);            // Not enabled
+                break;
+            case RecordFile:
+                appendUint24le(&settings, file->iRecordSize);
+                appendUint24le(&settings, file->iRecordSize ?
+                    (size / file->iRecordSize) : 0);    // Max records
+                appendUint24le(&settings, file->iRecordSize ?
+                    (size / file->iRecordSize) : 0);    // Current records
+                break;
+            }
+            *aResponse = settings;
+            return SW_OK;
+        }
+        return SW_FILE_NOT_FOUND;
+    }
+    return SW_LENGTH_ERROR;
+}
+
+uint
+TravelCardEmulator::Private::getValue(
+    const GUtilData* aData,
+    QByteArray* aResponse) const
+{
+    if (aData->size == 1) {
+        const File* file = findFile(aData->bytes[0]);
+
+        if (!file) {
+            return SW_FILE_NOT_FOUND;
+        } else if (file->iType != ValueFile || file->iData.size() != 4) {
+            return SW_PARAMETER_ERROR;
+        } else {
+            *aResponse = file->iData;
+            return SW_OK;
+        }
+    }
+    return SW_LENGTH_ERROR;
+}
+
+uint
+TravelCardEmulator::Private::process(
+    const NfcIsoDepApdu* aApdu,
+    QByteArray* aResponse)
+{
+    if (aApdu->cla != CLA) {
+        iMoreData.clear();
+        return SW_CLA_NOT_SUPPORTED;
+    }
+
+    if (aApdu->ins == INS_MORE) {
+        if (iMoreData.isEmpty()) {
+            return SW_COMMAND_ABORTED;
+        } else {
+            const QByteArray data(iMoreData);
+
+            iMoreData.clear();
+            return frame(data, aResponse);
+        }
+    }
+
+    // Any other command cancels the pending transfer
+    iMoreData.clear();
+
+    QByteArray data;
+    uint sw;
+
+    switch (aApdu->ins) {
+    case INS_SELECT:
+        if (aApdu->data.size == 3) {
+            const QByteArray aid((const char*)aApdu->data.bytes, 3);
+            const int n = iConfig.iApps.count();
+
+            sw = SW_APP_NOT_FOUND;
+            iSelectedApp = Q_NULLPTR;
+            for (int i = 0; i < n; i++) {
+                const Application* app = &iConfig.iApps.at(i);
+
+                if (app->iAid == aid) {
+                    iSelectedApp = app;
+                    sw = SW_OK;
+                    break;
+                }
+            }
+        } else {
+            sw = SW_LENGTH_ERROR;
+        }
+        return sw;
+    case INS_READ_DATA:
+        sw = readData(&aApdu->data, &data);
+        break;
+    case INS_READ_RECORDS:
+        sw = readRecords(&aApdu->data, &data);
+        break;
+    case INS_GET_FILE_SETTINGS:
+        sw = getFileSettings(&aApdu->data, &data);
+        break;
+    case INS_GET_VALUE:
+        sw = getValue(&aApdu->data, &data);
+        break;
+    default:
+        return SW_ILLEGAL_COMMAND;
+    }
+    return (sw == SW_OK) ? frame(data, aResponse) : sw;
+}
+
+bool
+TravelCardEmulator::Private::parseLine(
+    const QStringList& aTokens,
+    Config* aConfig)
+{
+    const QString& keyword = aTokens.first();
+    const int n = aTokens.count();
+    bool ok = false;
+
+    if (keyword == QLatin1String("frame") && n == 2) {
+        aConfig->iFrameSize = aTokens.at(1).toInt(&ok);
+        ok = ok && aConfig->iFrameSize > 0;
+    } else if (keyword == QLatin1String("delay") && n == 2) {
+        aConfig->iDelay = aTokens.at(1).toUInt(&ok);
+    } else if (keyword == QLatin1String("fail") && n == 2) {
+        aConfig->iFailAt = aTokens.at(1).toInt(&ok);
+    } else if (keyword == QLatin1String("app") && n == 2) {
+        Application app;
+
+        app.iAid = QByteArray::fromHex(aTokens.at(1).toLatin1());
+        if (app.iAid.size() == 3) {
+            aConfig->iApps.append(app);
+            ok = true;
+        }
+    } else if (!aConfig->iApps.isEmpty() && n >= 2) {
+        // The contents may be missing (empty file)
+        File file;
+
+        file.iNo = aTokens.at(1).toUInt(&ok, 16);
+        file.iRecordSize = 0;
+        if (ok) {
+            if (keyword == QLatin1String("data") && n <= 3) {
+                file.iType = DataFile;
+            } else if (keyword == QLatin1String("value") && n == 3) {
+                file.iType = ValueFile;
+            } else if (keyword == QLatin1String("record") &&
+                (n == 3 || n == 4)) {
+                file.iType = RecordFile;
+                file.iRecordSize = aTokens.at(2).toUInt(&ok);
+                ok = ok && file.iRecordSize > 0;
+            } else {
+                ok = false;
+            }
+        }
+        if (ok) {
+            const int dataIndex = (file.iType == RecordFile) ? 3 : 2;
+
+            if (dataIndex < n) {
+                const QString& hex = aTokens.at(dataIndex);
+
+                file.iData = QByteArray::fromHex(hex.toLatin1());
+                ok = (file.iData.size() * 2 == hex.length());
+            }
+            if (ok) {
+                aConfig->iApps.last().iFiles.append(file);
+            }
+        }
+    }
+    return ok;
+}
+
+// ==========================================================================
+// TravelCardEmulator::Config
+// ==========================================================================
+
+TravelCardEmulator::Config::Config() :
+    iFrameSize(DEFAULT_FRAME_SIZE),
+    iDelay(0),
+    iFailAt(-1)
+{
+}
+
+// ==========================================================================
+// TravelCardEmulator
+// ==========================================================================
+
+const char TravelCardEmulator::PATH_PREFIX[] = "emulator:";
+
+TravelCardEmulator::TravelCardEmulator(
+    const Config& aConfig) :
+    iPrivate(new Private(aConfig))
+{
+}
+
+TravelCardEmulator::~TravelCardEmulator()
+{
+    delete iPrivate;
+}
+
+int
+TravelCardEmulator::transmitCount() const
+{
+    return iPrivate->iCount;
+}
+
+bool
+TravelCardEmulator::parse(
+    const QString& aText,
+    Config* aConfig)
+{
+    const QStringList lines(aText.split('\n'));
+    const int n = lines.count();
+    Config config;
+
+    for (int i = 0; i < n; i++) {
+        QString line(lines.at(i));
+        const int comment = line.indexOf('#');
+
+        if (comment >= 0) {
+            line.truncate(comment);
+        }
+
+        const QStringList tokens(line.split(' ', QString::SkipEmptyParts));
+
+        if (!tokens.isEmpty() && !Private::parseLine(tokens, &config)) {
+            HWARN("Syntax error at line" << (i + 1));
+            return false;
+        }
+    }
+    *aConfig = config;
+    return true;
+}
+
+bool
+TravelCardEmulator::load(
+    const QString& aFileName,
+    Config* aConfig)
+{
+    QFile file(aFileName);
+
+    if (file.open(QIODevice::ReadOnly)) {
+        return parse(QString::fromLatin1(file.readAll()), aConfig);
+    }
+    return false;
+}
+
+bool
+TravelCardEmulator::fromCardInfo(
+    const QVariantMap& aCardInfo,
+    Config* aConfig)
+{
+    return fromDump(TravelCardDump::fromCardInfo(aCardInfo), aConfig);
+}
+
+bool
+TravelCardEmulator::fromDump(
+    const TravelCardDump& aDump,
+    Config* aConfig)
+{
+    const QString& type = aDump.iCardType;
+    Config config;
+    Application app;
+
+    if (type == HslCard::Desc.iName) {
+        static const uchar aid[] = { 0x14, 0x20, 0xef };
+        static const struct {
+            uint iNo;
+            FileType iType;
+            uint iRecordSize;
+            const char* iKey;
+        } files[] = {
+            { 0x08, DataFile, 0, "appInfo" },
+            { 0x01, DataFile, 0, "periodPass" },
+            { 0x02, DataFile, 0, "storedValue" },
+            { 0x03, DataFile, 0, "eTicket" },
+            { 0x04, RecordFile, 12, "history" }
+        };
+
+        app.iAid = QByteArray((const char*)aid, sizeof(aid));
+        for (uint i = 0; i < G_N_ELEMENTS(files); i++) {
+            const TravelCardDump::Block* block =
+                aDump.block(QLatin1String(files[i].iKey));
+
+            if (block) {
+                File file;
+
+                file.iNo = files[i].iNo;
+                file.iType = files[i].iType;
+                file.iRecordSize = files[i].iRecordSize;
+                file.iData = block->iData;
+                app.iFiles.append(file);
+            }
+        }
+    } else if (type == NysseCard::Desc.iName) {
+        static const uchar aid[] = { 0x01, 0x21, 0xef };
+        static const struct {
+            uint iNo;
+            FileType iType;
+            uint iRecordSize;
+            const char* iKey;
+        } files[] = {
+            { 0x07, DataFile, 0, "appInfo" },
+            { 0x04, DataFile, 0, "ownerInfo" },
+            { 0x02, DataFile, 0, "ticketInfo" },
+            { 0x03, RecordFile, 16, "history" },
+            { 0x01, ValueFile, 0, "balance" }
+        };
+
+        app.iAid = QByteArray((const char*)aid, sizeof(aid));
+        for (uint i = 0; i < G_N_ELEMENTS(files); i++) {
+            const TravelCardDump::Block* block =
+                aDump.block(QLatin1String(files[i].iKey));
+
+            // The first status word is the GetFileSettings status,
+            // which tells whether the file exists at all
+            if (block && !block->iStatus.isEmpty() &&
+                block->iStatus.first() == 0x9100) {
+                File file;
+
+                file.iNo = files[i].iNo;
+                file.iType = files[i].iType;
+                file.iRecordSize = files[i].iRecordSize;
+                file.iData = block->iData;
+                app.iFiles.append(file);
+            }
+        }
+    } else {
+        HWARN("Unsupported card type" << type);
+        return false;
+    }
+
+    config.iApps.append(app);
+    *aConfig = config;
+    return true;
+}
+
+bool
+TravelCardEmulator::transmit(
+    const NfcIsoDepApdu* aApdu,
+    GCancellable* aCancel,
+    NfcIsoDepClientTransmitFunc aCallback,
+    void* aUserData,
+    GDestroyNotify aDestroy)
+{
+    const int index = iPrivate->iCount++;
+    const Config& config = iPrivate->iConfig;
+
+    if (config.iFailAt >= 0 && index >= config.iFailAt) {
+        HDEBUG("APDU #" << index << "fails");
+        complete(aCancel, aCallback, aUserData, aDestroy, QByteArray(), 0,
+            "Tag is gone", config.iDelay);
+    } else {
+        QByteArray response;
+        const uint sw = iPrivate->process(aApdu, &response);
+
+        complete(aCancel, aCallback, aUserData, aDestroy, response, sw,
+            Q_NULLPTR, config.iDelay);
+    }
+    return true;
+}
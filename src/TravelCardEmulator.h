@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#ifndef TRAVEL_CARD_EMULATOR_H
+#define TRAVEL_CARD_EMULATOR_H
+
+#include "TravelCardTransport.h"
+
+#include <QtCore/QByteArray>
+#include <QtCore/QList>
+#include <QtCore/QVariantMap>
+
+class TravelCardDump;
+
+// Virtual DESFire card, answering the native (ISO 7816-4 wrapped)
+// commands which HslCard and NysseCard are using:
+//
+//   0x5a SelectApplication
+//   0xbd ReadData
+//   0xbb ReadRecords
+//   0xf5 GetFileSettings
+//   0x6c GetValue
+//   0xaf AdditionalFrame
+//
+// Responses longer than the frame size are split into frames, same
+// way as the real card does that. Each response can be delayed and
+// the card can be "removed" after a certain number of exchanges, in
+// which case this and all subsequent transmissions fail.
+class TravelCardEmulator :
+    public TravelCardTransport
+{
+public:
+    enum FileType {
+        DataFile,
+        RecordFile,
+        ValueFile
+    };
+
+    struct File {
+        uint iNo;
+        FileType iType;
+        uint iRecordSize;       // RecordFile only
+        QByteArray iData;       // Value files contain 4 bytes LE
+    };
+
+    struct Application {
+        QByteArray iAid;        // 3 bytes, as they appear in the APDU
+        QList<File> iFiles;
+    };
+
+    struct Config {
+        QList<Application> iApps;
+        int iFrameSize;         // Max number of data bytes per response
+        uint iDelay;            // Per-APDU delay, milliseconds
+        int iFailAt;            // Index of the first failing APDU or -1
+
+        Config();
+    };
+
+    static const char PATH_PREFIX[]; // "emulator:"
+    static const int DEFAULT_FRAME_SIZE = 59;
+
+    TravelCardEmulator(const Config&);
+    ~TravelCardEmulator();
+
+    // Number of APDUs transmitted so far
+    int transmitCount() const;
+
+    // Text config, see TravelCardEmulator.cpp for the syntax
+    static bool parse(const QString&, Config*);
+    static bool load(const QString& aFileName, Config*);
+
+    // Layout of HSL or Nysse card built from the card info produced
+    // by the card driver (i.e. what TravelCard::cardInfo returns)
+    static bool fromCardInfo(const QVariantMap&, Config*);
+    static bool fromDump(const TravelCardDump&, Config*);
+
+    bool transmit(const NfcIsoDepApdu*, GCancellable*,
+        NfcIsoDepClientTransmitFunc, void*, GDestroyNotify) Q_DECL_OVERRIDE;
+
+private:
+    class Private;
+    Private* iPrivate;
+};
+
+#endif // TRAVEL_CARD_EMULATOR_H
@@ -0,0 +1,649 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "gutil_types.h"
+
+#include "TravelCardHistoryFilter.h"
+
+#include "HarbourDebug.h"
+
+#include <algorithm>
+
+// ==========================================================================
+// TravelCardHistoryFilter::Private
+// ==========================================================================
+
+class TravelCardHistoryFilter::Private :
+    public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Entry {
+        int iType;
+        qint64 iDay;    // Julian day
+        qint64 iTime;   // Milliseconds since epoch
+    };
+
+    typedef QVector<Entry> Entries;
+    typedef QVector<int> Rows;
+
+    // Orders source rows chronologically. Entries with the same
+    // timestamp are ordered so that descending order matches the
+    // order of the source model (which has the most recent entry
+    // first)
+    class TimeOrder {
+    public:
+        TimeOrder(const Entries& aEntries) : iEntries(aEntries) {}
+        bool operator()(int aRow1, int aRow2) const {
+            const qint64 t1 = iEntries.at(aRow1).iTime;
+            const qint64 t2 = iEntries.at(aRow2).iTime;
+            return (t1 == t2) ? (aRow1 > aRow2) : (t1 < t2);
+        }
+    private:
+        const Entries& iEntries;
+    };
+
+    // Binary search helpers for the day index
+    class DayOrder {
+    public:
+        DayOrder(const Entries& aEntries) : iEntries(aEntries) {}
+        bool operator()(int aRow, qint64 aDay) const
+            { return iEntries.at(aRow).iDay < aDay; }
+        bool operator()(qint64 aDay, int aRow) const
+            { return aDay < iEntries.at(aRow).iDay; }
+    private:
+        const Entries& iEntries;
+    };
+
+    static const char* const DEFAULT_TIME_ROLES[];
+
+    static void shiftRows(Rows*, int, int);
+
+    Private(TravelCardHistoryFilter*);
+
+    TravelCardHistoryFilter* parentModel() const;
+    void setSourceModel(QAbstractItemModel*);
+    void resolveRoles();
+    void readEntry(int, Entry*) const;
+    void buildIndex();
+    void insertIndex(int, int);
+    Rows filter() const;
+    void updateRows(bool);
+
+private Q_SLOTS:
+    void onSourceChanged();
+    void onSourceRowsInserted(const QModelIndex&, int, int);
+    void onSourceDataChanged(const QModelIndex&, const QModelIndex&, const QVector<int>&);
+    void onSourceDestroyed();
+
+public:
+    QAbstractItemModel* iSource;
+    QString iTypeRoleName;
+    QString iTimeRoleName;
+    int iTypeRole;
+    int iTimeRole;
+    int iTransactionType;
+    QDate iFromDate;
+    QDate iToDate;
+    Qt::SortOrder iSortOrder;
+    Entries iEntries;           // Indexed by the source row
+    Rows iByTime;               // Source rows in chronological order
+    QHash<int,Rows> iByType;    // Same as iByTime, grouped by type
+    Rows iRows;                 // Filtered (and sorted) source rows
+};
+
+// Time roles of HslCardHistory and NysseCardHistory
+const char* const TravelCardHistoryFilter::Private::DEFAULT_TIME_ROLES[] = {
+    "boardingTime",
+    "transactionTime"
+};
+
+TravelCardHistoryFilter::Private::Private(
+    TravelCardHistoryFilter* aParent) :
+    QObject(aParent),
+    iSource(Q_NULLPTR),
+    iTypeRoleName("transactionType"),
+    iTypeRole(-1),
+    iTimeRole(-1),
+    iTransactionType(AnyTransaction),
+    iSortOrder(Qt::DescendingOrder)
+{
+}
+
+void
+TravelCardHistoryFilter::Private::shiftRows(
+    Rows* aRows,
+    int aFirst,
+    int aCount)
+{
+    const int n = aRows->count();
+    int* rows = aRows->data();
+
+    for (int i = 0; i < n; i++) {
+        if (rows[i] >= aFirst) {
+            rows[i] += aCount;
+        }
+    }
+}
+
+inline
+TravelCardHistoryFilter*
+TravelCardHistoryFilter::Private::parentModel() const
+{
+    return qobject_cast<TravelCardHistoryFilter*>(parent());
+}
+
+void
+TravelCardHistoryFilter::Private::setSourceModel(
+    QAbstractItemModel* aModel)
+{
+    if (iSource) {
+        iSource->disconnect(this);
+    }
+    iSource = aModel;
+    if (iSource) {
+        connect(iSource, SIGNAL(modelReset()), SLOT(onSourceChanged()));
+        connect(iSource, SIGNAL(layoutChanged()), SLOT(onSourceChanged()));
+        connect(iSource, SIGNAL(rowsInserted(QModelIndex,int,int)),
+            SLOT(onSourceRowsInserted(QModelIndex,int,int)));
+        connect(iSource, SIGNAL(rowsRemoved(QModelIndex,int,int)),
+            SLOT(onSourceChanged()));
+        connect(iSource, SIGNAL(rowsMoved(QModelIndex,int,int,QModelIndex,int)),
+            SLOT(onSourceChanged()));
+        connect(iSource, SIGNAL(dataChanged(QModelIndex,QModelIndex,QVector<int>)),
+            SLOT(onSourceDataChanged(QModelIndex,QModelIndex,QVector<int>)));
+        connect(iSource, SIGNAL(destroyed(QObject*)),
+            SLOT(onSourceDestroyed()));
+    }
+    resolveRoles();
+    buildIndex();
+}
+
+void
+TravelCardHistoryFilter::Private::resolveRoles()
+{
+    iTypeRole = iTimeRole = -1;
+    if (iSource) {
+        const QByteArray typeRole(iTypeRoleName.toUtf8());
+        const QByteArray timeRole(iTimeRoleName.toUtf8());
+        const QHash<int,QByteArray> roles(iSource->roleNames());
+        QHashIterator<int,QByteArray> it(roles);
+
+        while (it.hasNext()) {
+            it.next();
+            if (it.value() == typeRole) {
+                iTypeRole = it.key();
+            } else if (it.value() == timeRole) {
+                iTimeRole = it.key();
+            }
+        }
+        if (timeRole.isEmpty()) {
+            // Use the time role of the history model
+            const int n = G_N_ELEMENTS(DEFAULT_TIME_ROLES);
+
+            for (int i = 0; i < n && iTimeRole < 0; i++) {
+                iTimeRole = roles.key(DEFAULT_TIME_ROLES[i], -1);
+            }
+        }
+        HDEBUG(typeRole << iTypeRole << timeRole << iTimeRole);
+    }
+}
+
+void
+TravelCardHistoryFilter::Private::readEntry(
+    int aRow,
+    Entry* aEntry) const
+{
+    const QModelIndex index(iSource->index(aRow, 0));
+
+    aEntry->iType = (iTypeRole >= 0) ?
+        iSource->data(index, iTypeRole).toInt() : 0;
+    if (iTimeRole >= 0) {
+        const QDateTime time(iSource->data(index, iTimeRole).toDateTime());
+
+        aEntry->iDay = time.date().toJulianDay();
+        aEntry->iTime = time.toMSecsSinceEpoch();
+    } else {
+        aEntry->iDay = aEntry->iTime = 0;
+    }
+}
+
+void
+TravelCardHistoryFilter::Private::buildIndex()
+{
+    const int n = iSource ? iSource->rowCount() : 0;
+
+    iEntries.resize(n);
+    iByTime.resize(n);
+    iByType.clear();
+    for (int i = 0; i < n; i++) {
+        readEntry(i, iEntries.data() + i);
+        iByTime[i] = i;
+    }
+
+    std::sort(iByTime.begin(), iByTime.end(), TimeOrder(iEntries));
+    for (int i = 0; i < n; i++) {
+        const int row = iByTime.at(i);
+
+        iByType[iEntries.at(row).iType].append(row);
+    }
+    HDEBUG(n << "entries," << iByType.count() << "type(s)");
+}
+
+void
+TravelCardHistoryFilter::Private::insertIndex(
+    int aFirst,
+    int aLast)
+{
+    // Only the inserted rows are read from the source model. The rows
+    // below them get shifted, which doesn't change their relative order,
+    // and the (sorted) new rows are merged into the existing indices.
+    const int count = aLast - aFirst + 1;
+    Rows added;
+
+    iEntries.insert(aFirst, count, Entry());
+    added.reserve(count);
+    for (int i = aFirst; i <= aLast; i++) {
+        readEntry(i, iEntries.data() + i);
+        added.append(i);
+    }
+    std::sort(added.begin(), added.end(), TimeOrder(iEntries));
+
+    QHash<int,Rows> addedByType;
+
+    for (int i = 0; i < count; i++) {
+        const int row = added.at(i);
+
+        addedByType[iEntries.at(row).iType].append(row);
+    }
+
+    // Shift the existing rows
+    shiftRows(&iByTime, aFirst, count);
+    for (QHash<int,Rows>::iterator it = iByType.begin();
+         it != iByType.end(); ++it) {
+        shiftRows(&it.value(), aFirst, count);
+    }
+
+    // And merge the new ones in
+    Rows merged(iByTime.count() + count);
+
+    std::merge(iByTime.constBegin(), iByTime.constEnd(), added.constBegin(),
+        added.constEnd(), merged.begin(), TimeOrder(iEntries));
+    iByTime = merged;
+
+    QHashIterator<int,Rows> it(addedByType);
+
+    while (it.hasNext()) {
+        it.next();
+        const Rows& newRows = it.value();
+        Rows& rows = iByType[it.key()];
+
+        merged.resize(rows.count() + newRows.count());
+        std::merge(rows.constBegin(), rows.constEnd(), newRows.constBegin(),
+            newRows.constEnd(), merged.begin(), TimeOrder(iEntries));
+        rows = merged;
+    }
+    HDEBUG(count << "entries added," << iEntries.count() << "total");
+}
+
+TravelCardHistoryFilter::Private::Rows
+TravelCardHistoryFilter::Private::filter() const
+{
+    static const Rows EMPTY;
+    const Rows* rows = &iByTime;
+
+    if (iTransactionType != AnyTransaction) {
+        QHash<int,Rows>::const_iterator it = iByType.constFind(iTransactionType);
+
+        rows = (it == iByType.constEnd()) ? &EMPTY : &it.value();
+    }
+
+    // Both indices are sorted chronologically and therefore by day
+    Rows::const_iterator first = rows->constBegin();
+    Rows::const_iterator last = rows->constEnd();
+
+    if (iTimeRole >= 0) {
+        if (iFromDate.isValid()) {
+            first = std::lower_bound(first, last, iFromDate.toJulianDay(),
+                DayOrder(iEntries));
+        }
+        if (iToDate.isValid()) {
+            last = std::upper_bound(first, last, iToDate.toJulianDay(),
+                DayOrder(iEntries));
+        }
+    }
+
+    Rows result;
+
+    result.reserve(last - first);
+    if (iSortOrder == Qt::AscendingOrder) {
+        while (first != last) {
+            result.append(*first++);
+        }
+    } else {
+        while (last != first) {
+            result.append(*--last);
+        }
+    }
+    return result;
+}
+
+void
+TravelCardHistoryFilter::Private::updateRows(
+    bool aSourceDataChanged)
+{
+    TravelCardHistoryFilter* model = parentModel();
+    const int prevCount = iRows.count();
+    const Rows rows(filter());
+
+    if (iRows != rows) {
+        model->beginResetModel();
+        iRows = rows;
+        model->endResetModel();
+    } else if (aSourceDataChanged && !iRows.isEmpty()) {
+        Q_EMIT model->dataChanged(model->index(0),
+            model->index(iRows.count() - 1));
+    }
+    if (prevCount != iRows.count()) {
+        Q_EMIT model->countChanged();
+    }
+}
+
+void
+TravelCardHistoryFilter::Private::onSourceChanged()
+{
+    buildIndex();
+    updateRows(true);
+}
+
+void
+TravelCardHistoryFilter::Private::onSourceRowsInserted(
+    const QModelIndex& aParent,
+    int aFirst,
+    int aLast)
+{
+    if (!aParent.isValid() && aFirst >= 0 && aFirst <= iEntries.count() &&
+        aLast >= aFirst && iSource->rowCount() ==
+        iEntries.count() + aLast - aFirst + 1) {
+        // Typically, the next page fetched by the source model
+        insertIndex(aFirst, aLast);
+        updateRows(false);
+    } else {
+        onSourceChanged();
+    }
+}
+
+void
+TravelCardHistoryFilter::Private::onSourceDataChanged(
+    const QModelIndex&,
+    const QModelIndex&,
+    const QVector<int>& aRoles)
+{
+    if (aRoles.isEmpty() ||
+        aRoles.contains(iTypeRole) ||
+        aRoles.contains(iTimeRole)) {
+        // The index needs to be rebuilt
+        buildIndex();
+        updateRows(true);
+    } else if (!iRows.isEmpty()) {
+        // Filtering is not affected
+        TravelCardHistoryFilter* model = parentModel();
+
+        Q_EMIT model->dataChanged(model->index(0),
+            model->index(iRows.count() - 1), aRoles);
+    }
+}
+
+void
+TravelCardHistoryFilter::Private::onSourceDestroyed()
+{
+    iSource = Q_NULLPTR;
+    buildIndex();
+    updateRows(false);
+    Q_EMIT parentModel()->sourceModelChanged();
+}
+
+// ==========================================================================
+// TravelCardHistoryFilter
+// ==========================================================================
+
+TravelCardHistoryFilter::TravelCardHistoryFilter(
+    QObject* aParent) :
+    QAbstractListModel(aParent),
+    iPrivate(new Private(this))
+{
+}
+
+TravelCardHistoryFilter::~TravelCardHistoryFilter()
+{
+    if (iPrivate->iSource) {
+        iPrivate->iSource->disconnect(iPrivate);
+    }
+}
+
+QObject*
+TravelCardHistoryFilter::sourceModel() const
+{
+    return iPrivate->iSource;
+}
+
+void
+TravelCardHistoryFilter::setSourceModel(
+    QObject* aObject)
+{
+    QAbstractItemModel* model = qobject_cast<QAbstractItemModel*>(aObject);
+
+    if (iPrivate->iSource != model) {
+        const int prevCount = iPrivate->iRows.count();
+
+        beginResetModel();
+        iPrivate->setSourceModel(model);
+        iPrivate->iRows = iPrivate->filter();
+        endResetModel();
+        if (prevCount != iPrivate->iRows.count()) {
+            Q_EMIT countChanged();
+        }
+        Q_EMIT sourceModelChanged();
+    }
+}
+
+QString
+TravelCardHistoryFilter::typeRole() const
+{
+    return iPrivate->iTypeRoleName;
+}
+
+void
+TravelCardHistoryFilter::setTypeRole(
+    QString aRole)
+{
+    if (iPrivate->iTypeRoleName != aRole) {
+        iPrivate->iTypeRoleName = aRole;
+        iPrivate->resolveRoles();
+        iPrivate->buildIndex();
+        iPrivate->updateRows(false);
+        Q_EMIT typeRoleChanged();
+    }
+}
+
+QString
+TravelCardHistoryFilter::timeRole() const
+{
+    return iPrivate->iTimeRoleName;
+}
+
+void
+TravelCardHistoryFilter::setTimeRole(
+    QString aRole)
+{
+    if (iPrivate->iTimeRoleName != aRole) {
+        iPrivate->iTimeRoleName = aRole;
+        iPrivate->resolveRoles();
+        iPrivate->buildIndex();
+        iPrivate->updateRows(false);
+        Q_EMIT timeRoleChanged();
+    }
+}
+
+int
+TravelCardHistoryFilter::transactionType() const
+{
+    return iPrivate->iTransactionType;
+}
+
+void
+TravelCardHistoryFilter::setTransactionType(
+    int aType)
+{
+    if (iPrivate->iTransactionType != aType) {
+        iPrivate->iTransactionType = aType;
+        iPrivate->updateRows(false);
+        Q_EMIT transactionTypeChanged();
+    }
+}
+
+QDate
+TravelCardHistoryFilter::fromDate() const
+{
+    return iPrivate->iFromDate;
+}
+
+void
+TravelCardHistoryFilter::setFromDate(
+    QDate aDate)
+{
+    if (iPrivate->iFromDate != aDate) {
+        iPrivate->iFromDate = aDate;
+        iPrivate->updateRows(false);
+        Q_EMIT fromDateChanged();
+    }
+}
+
+QDate
+TravelCardHistoryFilter::toDate() const
+{
+    return iPrivate->iToDate;
+}
+
+void
+TravelCardHistoryFilter::setToDate(
+    QDate aDate)
+{
+    if (iPrivate->iToDate != aDate) {
+        iPrivate->iToDate = aDate;
+        iPrivate->updateRows(false);
+        Q_EMIT toDateChanged();
+    }
+}
+
+Qt::SortOrder
+TravelCardHistoryFilter::sortOrder() const
+{
+    return iPrivate->iSortOrder;
+}
+
+void
+TravelCardHistoryFilter::setSortOrder(
+    Qt::SortOrder aOrder)
+{
+    if (iPrivate->iSortOrder != aOrder) {
+        iPrivate->iSortOrder = aOrder;
+        iPrivate->updateRows(false);
+        Q_EMIT sortOrderChanged();
+    }
+}
+
+int
+TravelCardHistoryFilter::count() const
+{
+    return iPrivate->iRows.count();
+}
+
+int
+TravelCardHistoryFilter::sourceRow(
+    int aRow) const
+{
+    return (aRow >= 0 && aRow < iPrivate->iRows.count()) ?
+        iPrivate->iRows.at(aRow) : -1;
+}
+
+QHash<int,QByteArray>
+TravelCardHistoryFilter::roleNames() const
+{
+    return iPrivate->iSource ? iPrivate->iSource->roleNames() :
+        QHash<int,QByteArray>();
+}
+
+int
+TravelCardHistoryFilter::rowCount(
+    const QModelIndex&) const
+{
+    return iPrivate->iRows.count();
+}
+
+bool
+TravelCardHistoryFilter::canFetchMore(
+    const QModelIndex&) const
+{
+    return iPrivate->iSource && iPrivate->iSource->canFetchMore(QModelIndex());
+}
+
+void
+TravelCardHistoryFilter::fetchMore(
+    const QModelIndex&)
+{
+    // The source model rebuilds the index when new rows get inserted
+    if (iPrivate->iSource) {
+        iPrivate->iSource->fetchMore(QModelIndex());
+    }
+}
+
+QVariant
+TravelCardHistoryFilter::data(
+    const QModelIndex& aIndex,
+    int aRole) const
+{
+    const int row = sourceRow(aIndex.row());
+
+    return (row >= 0) ?
+        iPrivate->iSource->data(iPrivate->iSource->index(row, 0), aRole) :
+        QVariant();
+}
+
+#include "TravelCardHistoryFilter.moc"
@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#ifndef TRAVEL_CARD_HISTORY_FILTER_H
+#define TRAVEL_CARD_HISTORY_FILTER_H
+
+#include <QtQml>
+
+// Filters and sorts HslCardHistory or NysseCardHistory by transaction
+// type and/or date range. The index is updated only when the source
+// model changes (inserted rows are merged into the existing index, other
+// changes rebuild it), changing the filter doesn't touch the source model.
+// Unless timeRole is set, the time role of the history model is used.
+// Fetching more rows is passed through to the source model.
+class TravelCardHistoryFilter :
+    public QAbstractListModel
+{
+    Q_OBJECT
+    Q_DISABLE_COPY(TravelCardHistoryFilter)
+    Q_PROPERTY(QObject* sourceModel READ sourceModel WRITE setSourceModel NOTIFY sourceModelChanged)
+    Q_PROPERTY(QString typeRole READ typeRole WRITE setTypeRole NOTIFY typeRoleChanged)
+    Q_PROPERTY(QString timeRole READ timeRole WRITE setTimeRole NOTIFY timeRoleChanged)
+    Q_PROPERTY(int transactionType READ transactionType WRITE setTransactionType NOTIFY transactionTypeChanged)
+    Q_PROPERTY(QDate fromDate READ fromDate WRITE setFromDate NOTIFY fromDateChanged)
+    Q_PROPERTY(QDate toDate READ toDate WRITE setToDate NOTIFY toDateChanged)
+    Q_PROPERTY(Qt::SortOrder sortOrder READ sortOrder WRITE setSortOrder NOTIFY sortOrderChanged)
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+    Q_ENUMS(Constants)
+
+public:
+    enum Constants {
+        AnyTransaction = -1
+    };
+
+    TravelCardHistoryFilter(QObject* aParent = Q_NULLPTR);
+    ~TravelCardHistoryFilter();
+
+    QObject* sourceModel() const;
+    void setSourceModel(QObject*);
+
+    QString typeRole() const;
+    void setTypeRole(QString);
+
+    QString timeRole() const;
+    void setTimeRole(QString);
+
+    int transactionType() const;
+    void setTransactionType(int);
+
+    QDate fromDate() const;
+    void setFromDate(QDate);
+
+    QDate toDate() const;
+    void setToDate(QDate);
+
+    Qt::SortOrder sortOrder() const;
+    void setSortOrder(Qt::SortOrder);
+
+    int count() const;
+
+    Q_INVOKABLE int sourceRow(int) const;
+
+    // QAbstractItemModel
+    QHash<int,QByteArray> roleNames() const Q_DECL_OVERRIDE;
+    int rowCount(const QModelIndex& aParent = QModelIndex()) const Q_DECL_OVERRIDE;
+    QVariant data(const QModelIndex&, int) const Q_DECL_OVERRIDE;
+    bool canFetchMore(const QModelIndex&) const Q_DECL_OVERRIDE;
+    void fetchMore(const QModelIndex&) Q_DECL_OVERRIDE;
+
+Q_SIGNALS:
+    void sourceModelChanged();
+    void typeRoleChanged();
+    void timeRoleChanged();
+    void transactionTypeChanged();
+    void fromDateChanged();
+    void toDateChanged();
+    void sortOrderChanged();
+    void countChanged();
+
+private:
+    class Private;
+    Private* iPrivate;
+};
+
+QML_DECLARE_TYPE(TravelCardHistoryFilter)
+
+#endif // TRAVEL_CARD_HISTORY_FILTER_H
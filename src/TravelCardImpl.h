@@ -45,6 +45,9 @@
 #include <QObject>
 #include <QUrl>
 
+class TravelCardSession;
+class TravelCardSummary;
+
 class TravelCardImpl :
     public QObject
 {
@@ -55,10 +58,20 @@ protected:
     TravelCardImpl(QObject* aParent) : QObject(aParent) {}
 
 public:
+    // nfcd technology bits
+    enum NfcTech {
+        NfcTechA = 0x01,
+        NfcTechB = 0x02,
+        NfcTechF = 0x04
+    };
+
     struct CardDesc {
         const QString iName;
-        TravelCardImpl* (*iNewCard)(QString, QObject*);
+        const QString iPageUrl;
+        TravelCardImpl* (*iNewCard)(TravelCardSession*, QObject*);
         void (*iRegisterTypes)(const char*, int, int);
+        TravelCardSummary* (*iNewSummary)(QObject*);
+        uint iNfcTechs;
     };
 
 public:
@@ -66,6 +79,7 @@ public:
 
 Q_SIGNALS:
     void readFailed();
+    void tagLost();
     void readDone(QString url, QVariantMap info);
 };
 
@@ -37,18 +37,22 @@
  */
 
 #include "nfcdc_isodep.h"
-#include "nfcdc_tag.h"
 
+#include "TravelCardAllocStats.h"
+#include "TravelCardApduLog.h"
+#include "TravelCardDump.h"
 #include "TravelCardIsoDep.h"
+#include "TravelCardSession.h"
+#include "TravelCardTrace.h"
+
+#ifdef MATKAKORTTI_TRANSPORTS
+#include "TravelCardTransport.h"
+#include <QtCore/QDir>
+#endif
 
 #include "HarbourDebug.h"
-#include "HarbourUtil.h"
 
-enum tag_events {
-    TAG_EVENT_VALID,
-    TAG_EVENT_PRESENT,
-    TAG_EVENT_COUNT
-};
+#include <QtCore/QPointer>
 
 // ==========================================================================
 // TravelCardIsoDep::Private
@@ -61,6 +65,9 @@ public:
         Private* iPrivate;
         QObject* iObject;
         char* iMethod;
+#ifdef MATKAKORTTI_TRACE
+        const qint64 iTraceStart;
+#endif
 
         Transmit(Private*, QObject*, const char*);
         ~Transmit();
@@ -69,174 +76,125 @@ public:
         static void free(gpointer);
     };
 
-    Private(const QString&, TravelCardIsoDep*);
+    Private(TravelCardSession*, TravelCardIsoDep*);
     ~Private();
 
-    void logCommand(const NfcIsoDepApdu*);
-    void logResponse(const GUtilData*, uint);
-
     void startReadingIfReady();
     void readDone();
 
-    static void tagEventHandler(NfcTagClient*, NFC_TAG_PROPERTY, void*);
-    static void isoDepEventHandler(NfcIsoDepClient*, NFC_ISODEP_PROPERTY, void*);
-    static void tagLockResp(NfcTagClient*, NfcTagClientLock*, const GError*, void*);
+    static gboolean startIo(gpointer);
 
 public:
     TravelCardIsoDep* iCard;
-    NfcTagClient* iTag;
-    NfcTagClientLock* iLock;
+    QPointer<TravelCardSession> iSession;
+#ifdef MATKAKORTTI_TRANSPORTS
+    TravelCardTransport* iTransport;
+#endif
     NfcIsoDepClient* iIsoDep;
-    gulong iTagEventId[TAG_EVENT_COUNT];
-    gulong iIsoDepEventId[TAG_EVENT_COUNT];
+    QMetaObject::Connection iSessionConnection;
+    guint iStartId;
     GCancellable* iCancel;
-    QString iDebugLog;
+    TravelCardApduLog* iLog;
 };
 
 TravelCardIsoDep::Private::Private(
-    const QString& aPath,
+    TravelCardSession* aSession,
     TravelCardIsoDep* aCard) :
     iCard(aCard),
-    iTag(Q_NULLPTR),
-    iLock(Q_NULLPTR),
+    iSession(aSession),
+#ifdef MATKAKORTTI_TRANSPORTS
+    iTransport(TravelCardTransport::create(aSession->path())),
+#endif
     iIsoDep(Q_NULLPTR),
-    iCancel(Q_NULLPTR)
+    iStartId(0),
+    iCancel(Q_NULLPTR),
+    iLog(new TravelCardApduLog)
 {
-    memset(iTagEventId, 0, sizeof(iTagEventId));
-    memset(iIsoDepEventId, 0, sizeof(iIsoDepEventId));
-
-    QByteArray bytes(aPath.toLatin1());
-    const char* path = bytes.constData();
-
-    iTag = nfc_tag_client_new(path);
-    iTagEventId[TAG_EVENT_VALID] =
-        nfc_tag_client_add_property_handler(iTag,
-            NFC_TAG_PROPERTY_VALID, tagEventHandler, this);
-    iTagEventId[TAG_EVENT_PRESENT] =
-        nfc_tag_client_add_property_handler(iTag,
-            NFC_TAG_PROPERTY_PRESENT, tagEventHandler, this);
-
-    iIsoDep = nfc_isodep_client_new(path);
-    iIsoDepEventId[TAG_EVENT_VALID] =
-        nfc_isodep_client_add_property_handler(iIsoDep,
-            NFC_ISODEP_PROPERTY_VALID, isoDepEventHandler, this);
-    iIsoDepEventId[TAG_EVENT_PRESENT] =
-        nfc_isodep_client_add_property_handler(iIsoDep,
-            NFC_ISODEP_PROPERTY_PRESENT, isoDepEventHandler, this);
+#ifdef MATKAKORTTI_TRANSPORTS
+    if (iTransport) {
+        // No nfcd involved
+        HDEBUG("Using in-process transport for" << qPrintable(aSession->path()));
+        return;
+    }
+#endif
+    // Our own reference, the session may go away first
+    iIsoDep = nfc_isodep_client_ref(aSession->isoDep());
 }
 
-
 TravelCardIsoDep::Private::~Private()
 {
     readDone();
+    delete iLog;
+#ifdef MATKAKORTTI_TRANSPORTS
+    delete iTransport;
+#endif
     nfc_isodep_client_unref(iIsoDep);
-    nfc_tag_client_unref(iTag);
 }
 
 void
 TravelCardIsoDep::Private::readDone()
 {
-    nfc_isodep_client_remove_all_handlers(iIsoDep, iIsoDepEventId);
-    nfc_tag_client_remove_all_handlers(iTag, iTagEventId);
+    if (iSessionConnection) {
+        QObject::disconnect(iSessionConnection);
+        iSessionConnection = QMetaObject::Connection();
+    }
+    if (iStartId) {
+        g_source_remove(iStartId);
+        iStartId = 0;
+    }
     if (iCancel) {
         g_cancellable_cancel(iCancel);
         g_object_unref(iCancel);
         iCancel = Q_NULLPTR;
     }
-    if (iLock) {
-        nfc_tag_client_lock_unref(iLock);
-        iLock = Q_NULLPTR;
-    }
 }
 
 void
 TravelCardIsoDep::Private::startReadingIfReady()
 {
-    if (iIsoDep->valid && iTag->valid) {
-        if (iTag->present && iIsoDep->present && !iCancel) {
-            iCancel = g_cancellable_new();
-            nfc_tag_client_acquire_lock(iTag, TRUE, iCancel, tagLockResp,
-                this, Q_NULLPTR);
-        } else if (!iIsoDep->present) {
-            // Not an ISO-DEP card
-            iCard->failure(UnsupportedCard);
+    if (iCancel) {
+        // I/O is in progress. If the tag is gone, there's no point
+        // in waiting for the pending transmission to fail.
+        if (iSession && iSession->state() == TravelCardSession::TagLost) {
+            iCard->failure(TagLost);
         }
+    } else if (!iStartId && iSession &&
+        iSession->state() != TravelCardSession::Waiting) {
+        // The session may be ready (or have failed) by the time the
+        // reading starts, e.g. if another driver has already tried the
+        // tag. Either way, startIo() or failure() is invoked later.
+        iStartId = g_idle_add(startIo, this);
     }
 }
 
 /* static */
-void
-TravelCardIsoDep::Private::tagLockResp(
-    NfcTagClient*,
-    NfcTagClientLock* aLock,
-    const GError* aError,
-    void* aPrivate)
+gboolean
+TravelCardIsoDep::Private::startIo(
+    gpointer aPrivate)
 {
     Private* self = (Private*)aPrivate;
     TravelCardIsoDep* card = self->iCard;
 
-    HASSERT(!self->iLock);
-    if (aLock) {
-        self->iLock = nfc_tag_client_lock_ref(aLock);
+    self->iStartId = 0;
+    switch (self->iSession ? self->iSession->state() :
+        TravelCardSession::LockFailed) {
+    case TravelCardSession::Ready:
+        self->iCancel = g_cancellable_new();
         card->startIo();
-    } else {
-        HWARN("Failed to lock the tag:" << aError->message);
+        break;
+    case TravelCardSession::NotIsoDep:
+        card->failure(UnsupportedCard);
+        break;
+    case TravelCardSession::LockFailed:
         card->failure(LockFailure);
+        break;
+    case TravelCardSession::TagLost:
+        card->failure(TagLost);
+        break;
+    case TravelCardSession::Waiting:
+        break;
     }
-}
-
-/* static */
-void
-TravelCardIsoDep::Private::isoDepEventHandler(
-    NfcIsoDepClient*,
-    NFC_ISODEP_PROPERTY,
-    void* aPrivate)
-{
-    ((Private*)aPrivate)->startReadingIfReady();
-}
-
-/* static */
-void
-TravelCardIsoDep::Private::tagEventHandler(
-    NfcTagClient*,
-    NFC_TAG_PROPERTY,
-    void* aPrivate)
-{
-    ((Private*)aPrivate)->startReadingIfReady();
-}
-
-void
-TravelCardIsoDep::Private::logCommand(
-    const NfcIsoDepApdu* aApdu)
-{
-    if (!iDebugLog.isEmpty()) {
-        iDebugLog.append('\n');
-    }
-    iDebugLog.append(QString::asprintf("%02x %02x %02x %02x ",
-        aApdu->cla, aApdu->ins, aApdu->p1, aApdu->p1));
-    if (aApdu->data.size) {
-        iDebugLog.append(HarbourUtil::toHex(aApdu->data.bytes, aApdu->data.size));
-    } else {
-        iDebugLog.append('-');
-    }
-    if (aApdu->le > 255) {
-        iDebugLog.append(QString::asprintf(" %04x", aApdu->le));
-    } else {
-        iDebugLog.append(QString::asprintf(" %02x", aApdu->le));
-    }
-    iDebugLog.append('\n');
-}
-
-void
-TravelCardIsoDep::Private::logResponse(
-    const GUtilData* aData,
-    uint aSw)
-{
-    if (aData && aData->size) {
-        iDebugLog.append(HarbourUtil::toHex(aData->bytes, aData->size));
-        iDebugLog.append(' ');
-    }
-    iDebugLog.append(QString::asprintf("%02x%02x\n", aSw >> 8, aSw & 0xff));
+    return G_SOURCE_REMOVE;
 }
 
 // ==========================================================================
@@ -250,6 +208,9 @@ TravelCardIsoDep::Private::Transmit::Transmit(
     iPrivate(aPrivate),
     iObject(aObject),
     iMethod(g_strdup(aMethod))
+#ifdef MATKAKORTTI_TRACE
+    , iTraceStart(TravelCardTrace::now())
+#endif
 {
 }
 
@@ -269,8 +230,11 @@ TravelCardIsoDep::Private::Transmit::response(
 {
     Transmit* self = (Transmit*)aTransmitData;
 
+#ifdef MATKAKORTTI_TRACE
+    TravelCardTrace::complete("apdu", self->iTraceStart);
+#endif
     if (!aError) {
-        self->iPrivate->logResponse(aData, aSw);
+        self->iPrivate->iLog->logResponse(aData, aSw);
     }
     QMetaObject::invokeMethod(self->iObject, self->iMethod,
                               Q_ARG(const GUtilData*, aData),
@@ -291,10 +255,10 @@ TravelCardIsoDep::Private::Transmit::free(
 // ==========================================================================
 
 TravelCardIsoDep::TravelCardIsoDep(
-    QString aPath,
+    TravelCardSession* aSession,
     QObject* aParent) :
     TravelCardImpl(aParent),
-    iPrivate(new Private(aPath, this))
+    iPrivate(new Private(aSession, this))
 {
 }
 
@@ -310,7 +274,13 @@ TravelCardIsoDep::transmit(
     const char* aMethod)
 {
     Private::Transmit* tx = new Private::Transmit(iPrivate, aObject, aMethod);
-    iPrivate->logCommand(aApdu);
+    iPrivate->iLog->logCommand(aApdu);
+#ifdef MATKAKORTTI_TRANSPORTS
+    if (iPrivate->iTransport) {
+        return iPrivate->iTransport->transmit(aApdu, iPrivate->iCancel,
+            Private::Transmit::response, tx, Private::Transmit::free);
+    }
+#endif
     return nfc_isodep_client_transmit(iPrivate->iIsoDep, aApdu, iPrivate->iCancel,
         Private::Transmit::response, tx, Private::Transmit::free);
 }
@@ -318,28 +288,66 @@ TravelCardIsoDep::transmit(
 void
 TravelCardIsoDep::success(
     QString aUrl,
-    QVariantMap aInfo)
+    const TravelCardDump& aDump)
 {
     HDEBUG("Read done");
+    ALLOC_STATS_END(Transport);
     iPrivate->readDone();
-    // Add ISO-DEP transaction log to the card info
+
+#ifdef MATKAKORTTI_TRANSPORTS
+    // Raw dump is only saved on request
+    const QString dumpDir(qgetenv(TravelCardDump::DIR_ENV));
+    if (!dumpDir.isEmpty()) {
+        aDump.save(QDir(dumpDir).filePath(aDump.defaultFileName()));
+    }
+#endif
+
+    // Add ISO-DEP transaction log to the card info. The log outlives
+    // this object, TravelCard takes care of it from now on.
+    TravelCardApduLog* log = iPrivate->iLog;
+    iPrivate->iLog = new TravelCardApduLog;
+    log->setParent(parent());
+
+    QVariantMap info(aDump.cardInfo());
     QVariantMap debug;
-    debug.insert("log", iPrivate->iDebugLog);
-    aInfo.insert("debug", debug);
-    Q_EMIT readDone(aUrl, aInfo);
+    debug.insert("log", QVariant::fromValue<QObject*>(log));
+#ifdef MATKAKORTTI_TRACE
+    debug.insert("trace", QVariant::fromValue<QObject*>
+        (TravelCardTrace::instance()));
+#endif
+#ifdef MATKAKORTTI_ALLOC_STATS
+    debug.insert("alloc", QVariant::fromValue<QObject*>
+        (TravelCardAllocStats::instance()));
+#endif
+    info.insert("debug", debug);
+    Q_EMIT readDone(aUrl, info);
 }
 
 void
-TravelCardIsoDep::failure(Failure)
+TravelCardIsoDep::failure(
+    Failure aFailure)
 {
-    HDEBUG("Read failed");
-    iPrivate->readDone();
-    Q_EMIT readFailed();
+    HDEBUG("Read failed" << aFailure);
+    ALLOC_STATS_END(Transport);
+    iPrivate->readDone();   // Cancels the pending I/O
+    if (aFailure == TagLost) {
+        Q_EMIT tagLost();
+    } else {
+        Q_EMIT readFailed();
+    }
 }
 
 void
 TravelCardIsoDep::startReading()
 {
-    iPrivate->iDebugLog.clear();
+    TRACE_INSTANT("startReading");
+    ALLOC_STATS_BEGIN(Transport);
+    iPrivate->iLog->clear();
+    if (iPrivate->iSession && !iPrivate->iSessionConnection) {
+        Private* priv = iPrivate;
+        iPrivate->iSessionConnection = connect(iPrivate->iSession.data(),
+            &TravelCardSession::stateChanged, this,
+            [priv]() { priv->startReadingIfReady(); });
+    }
     iPrivate->startReadingIfReady();
 }
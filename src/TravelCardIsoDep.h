@@ -43,6 +43,9 @@
 
 #include "TravelCardImpl.h"
 
+class TravelCardDump;
+class TravelCardSession;
+
 class TravelCardIsoDep :
     public TravelCardImpl
 {
@@ -52,10 +55,11 @@ protected:
     enum Failure {
         IoError,
         LockFailure,
-        UnsupportedCard
+        UnsupportedCard,
+        TagLost
     };
 
-    TravelCardIsoDep(QString, QObject*);
+    TravelCardIsoDep(TravelCardSession*, QObject*);
     ~TravelCardIsoDep();
 
     // The completion method (the last parameter) is invoked with the
@@ -68,8 +72,8 @@ protected:
     bool transmit(const NfcIsoDepApdu*, QObject*, const char*);
 
     virtual void startIo() = 0;
-    virtual void success(QString, QVariantMap); // emits readDone
-    virtual void failure(Failure);              // emits readFailed
+    virtual void success(QString, const TravelCardDump&); // emits readDone
+    virtual void failure(Failure);              // emits readFailed or tagLost
 
 public:
     void startReading() Q_DECL_OVERRIDE;
@@ -0,0 +1,174 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "TravelCardPolling.h"
+#include "TravelCard.h"
+#include "TravelCardImpl.h"
+#include "TravelCardTrace.h"
+
+#ifdef MATKAKORTTI_TECH_REQUEST
+#include <nfcdc_daemon.h>
+#endif
+
+#include "HarbourDebug.h"
+
+const char TravelCardPolling::ALL_TECHS_ENV[] = "MATKAKORTTI_POLL_ALL_TECHS";
+
+// ==========================================================================
+// TravelCardPolling::Private
+// ==========================================================================
+
+class TravelCardPolling::Private
+{
+public:
+    static const uint ALL_TECHS = TravelCardImpl::NfcTechA |
+        TravelCardImpl::NfcTechB | TravelCardImpl::NfcTechF;
+
+    Private();
+    ~Private();
+
+    void request();
+    void release();
+
+public:
+#ifdef MATKAKORTTI_TECH_REQUEST
+    NfcDaemonClient* iDaemon;
+    NfcTechRequest* iRequest;
+#endif
+    const bool iAllTechs;
+    bool iActive;
+};
+
+TravelCardPolling::Private::Private() :
+#ifdef MATKAKORTTI_TECH_REQUEST
+    iDaemon(nfc_daemon_client_new()),
+    iRequest(Q_NULLPTR),
+#endif
+    iAllTechs(!qgetenv(ALL_TECHS_ENV).isEmpty()),
+    iActive(false)
+{
+    if (iAllTechs) {
+        HDEBUG("Polling for all techs");
+    }
+}
+
+TravelCardPolling::Private::~Private()
+{
+    release();
+#ifdef MATKAKORTTI_TECH_REQUEST
+    nfc_daemon_client_unref(iDaemon);
+#endif
+}
+
+#ifdef MATKAKORTTI_TECH_REQUEST
+
+void
+TravelCardPolling::Private::request()
+{
+    if (!iRequest && !iAllTechs) {
+        // The technology bits are the same as nfcd's
+        const uint allow = TravelCard::nfcTechs();
+
+        HDEBUG("Allowing techs" << allow);
+        iRequest = nfc_tech_request_new(iDaemon, (NFC_TECH)allow,
+            (NFC_TECH)(ALL_TECHS & ~allow));
+        TRACE_INSTANT("techsRequested");
+    }
+}
+
+void
+TravelCardPolling::Private::release()
+{
+    if (iRequest) {
+        HDEBUG("Releasing techs request");
+        nfc_tech_request_free(iRequest);
+        iRequest = Q_NULLPTR;
+        TRACE_INSTANT("techsReleased");
+    }
+}
+
+#else // !MATKAKORTTI_TECH_REQUEST
+
+void
+TravelCardPolling::Private::request()
+{
+    HDEBUG("Tech requests aren't supported by this libgnfcdc");
+}
+
+void
+TravelCardPolling::Private::release()
+{
+}
+
+#endif // MATKAKORTTI_TECH_REQUEST
+
+// ==========================================================================
+// TravelCardPolling
+// ==========================================================================
+
+TravelCardPolling::TravelCardPolling(
+    QObject* aParent) :
+    QObject(aParent),
+    iPrivate(new Private)
+{}
+
+TravelCardPolling::~TravelCardPolling()
+{
+    delete iPrivate;
+}
+
+bool
+TravelCardPolling::active() const
+{
+    return iPrivate->iActive;
+}
+
+void
+TravelCardPolling::setActive(
+    bool aActive)
+{
+    if (iPrivate->iActive != aActive) {
+        iPrivate->iActive = aActive;
+        if (aActive) {
+            iPrivate->request();
+        } else {
+            iPrivate->release();
+        }
+        Q_EMIT activeChanged();
+    }
+}
@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#ifndef TRAVEL_CARD_POLLING_H
+#define TRAVEL_CARD_POLLING_H
+
+#include <QtQml>
+
+// While active, asks nfcd to poll only for the NFC technologies that
+// the supported cards use (see TravelCard::nfcTechs), which shortens
+// the polling loop and therefore the tag detection time. Complements
+// NfcMode which selects the mode (reader/writer) but not the techs.
+// The request goes through the same libgnfcdc daemon client as the
+// rest of the NFC stuff, which re-submits it if nfcd gets restarted.
+// Has no effect if nfcd doesn't support technology requests, or if
+// the app is built with libgnfcdc which can't make them.
+//
+// If MATKAKORTTI_POLL_ALL_TECHS environment variable is set, nothing
+// is requested. Comparing the setPath events in the trace with and
+// without it is how the effect on the detection time can be checked
+// on a device.
+class TravelCardPolling :
+    public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY(TravelCardPolling)
+    Q_PROPERTY(bool active READ active WRITE setActive NOTIFY activeChanged)
+
+public:
+    static const char ALL_TECHS_ENV[];  // "MATKAKORTTI_POLL_ALL_TECHS"
+
+    TravelCardPolling(QObject* aParent = Q_NULLPTR);
+    ~TravelCardPolling();
+
+    bool active() const;
+    void setActive(bool);
+
+Q_SIGNALS:
+    void activeChanged();
+
+private:
+    class Private;
+    Private* iPrivate;
+};
+
+QML_DECLARE_TYPE(TravelCardPolling)
+
+#endif // TRAVEL_CARD_POLLING_H
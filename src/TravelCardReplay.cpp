@@ -0,0 +1,248 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "TravelCardReplay.h"
+
+#include "HarbourDebug.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QStringList>
+
+// ==========================================================================
+// TravelCardReplay::Private
+// ==========================================================================
+
+class TravelCardReplay::Private
+{
+public:
+    Private(const Transcript&);
+
+    static bool parseCommand(const QString&, Exchange*);
+    static bool parseResponse(const QString&, Exchange*);
+    static QByteArray commandBytes(const NfcIsoDepApdu*);
+
+public:
+    const Transcript iTranscript;
+    int iNext;
+};
+
+TravelCardReplay::Private::Private(
+    const Transcript& aTranscript) :
+    iTranscript(aTranscript),
+    iNext(0)
+{
+}
+
+bool
+TravelCardReplay::Private::parseCommand(
+    const QString& aLine,
+    Exchange* aExchange)
+{
+    // CLA INS P1 P2 Data|- Le
+    const QStringList tokens(aLine.split(' ', QString::SkipEmptyParts));
+
+    if (tokens.count() == 6) {
+        QByteArray command;
+        bool ok = true;
+
+        for (int i = 0; i < 4 && ok; i++) {
+            const QString& token = tokens.at(i);
+
+            command.append((char)token.toUInt(&ok, 16));
+            ok = ok && token.length() == 2;
+        }
+        if (ok) {
+            const QString& data = tokens.at(4);
+
+            if (data != QLatin1String("-")) {
+                const QByteArray bytes(QByteArray::fromHex(data.toLatin1()));
+
+                ok = (bytes.size() * 2 == data.length());
+                command.append(bytes);
+            }
+            if (ok) {
+                aExchange->iLe = tokens.at(5).toUInt(&ok, 16);
+                aExchange->iCommand = command;
+                return ok;
+            }
+        }
+    }
+    return false;
+}
+
+bool
+TravelCardReplay::Private::parseResponse(
+    const QString& aLine,
+    Exchange* aExchange)
+{
+    // [Data] SW1SW2
+    const QStringList tokens(aLine.split(' ', QString::SkipEmptyParts));
+    const int n = tokens.count();
+
+    if (n == 1 || n == 2) {
+        const QString& sw = tokens.last();
+        bool ok;
+
+        aExchange->iSw = sw.toUInt(&ok, 16);
+        if (ok && sw.length() == 4) {
+            if (n == 2) {
+                const QString& data = tokens.first();
+
+                aExchange->iResponse = QByteArray::fromHex(data.toLatin1());
+                return aExchange->iResponse.size() * 2 == data.length();
+            } else {
+                aExchange->iResponse.clear();
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+QByteArray
+TravelCardReplay::Private::commandBytes(
+    const NfcIsoDepApdu* aApdu)
+{
+    QByteArray bytes;
+
+    bytes.reserve(4 + aApdu->data.size);
+    bytes.append((char)aApdu->cla);
+    bytes.append((char)aApdu->ins);
+    bytes.append((char)aApdu->p1);
+    bytes.append((char)aApdu->p2);
+    bytes.append((const char*)aApdu->data.bytes, aApdu->data.size);
+    return bytes;
+}
+
+// ==========================================================================
+// TravelCardReplay
+// ==========================================================================
+
+const char TravelCardReplay::PATH_PREFIX[] = "replay:";
+
+TravelCardReplay::TravelCardReplay(
+    const Transcript& aTranscript) :
+    iPrivate(new Private(aTranscript))
+{
+}
+
+TravelCardReplay::~TravelCardReplay()
+{
+    delete iPrivate;
+}
+
+bool
+TravelCardReplay::parse(
+    const QString& aText,
+    Transcript* aTranscript)
+{
+    const QStringList lines(aText.split('\n'));
+    const int n = lines.count();
+    Transcript transcript;
+    Exchange exchange;
+    bool command = true;
+
+    for (int i = 0; i < n; i++) {
+        const QString line(lines.at(i).trimmed());
+
+        if (!line.isEmpty()) {
+            if (command) {
+                if (!Private::parseCommand(line, &exchange)) {
+                    HWARN("Invalid command at line" << (i + 1));
+                    return false;
+                }
+            } else {
+                if (!Private::parseResponse(line, &exchange)) {
+                    HWARN("Invalid response at line" << (i + 1));
+                    return false;
+                }
+                transcript.append(exchange);
+            }
+            command = !command;
+        }
+    }
+
+    // A command without a response at the end of the transcript is
+    // what a tag removed in the middle of the exchange looks like.
+    // The transcript stops right before that command.
+    HDEBUG(transcript.count() << "exchange(s)");
+    *aTranscript = transcript;
+    return true;
+}
+
+bool
+TravelCardReplay::load(
+    const QString& aFileName,
+    Transcript* aTranscript)
+{
+    QFile file(aFileName);
+
+    if (file.open(QIODevice::ReadOnly)) {
+        return parse(QString::fromLatin1(file.readAll()), aTranscript);
+    }
+    return false;
+}
+
+bool
+TravelCardReplay::transmit(
+    const NfcIsoDepApdu* aApdu,
+    GCancellable* aCancel,
+    NfcIsoDepClientTransmitFunc aCallback,
+    void* aUserData,
+    GDestroyNotify aDestroy)
+{
+    const int index = iPrivate->iNext;
+
+    if (index < iPrivate->iTranscript.count()) {
+        const Exchange& exchange = iPrivate->iTranscript.at(index);
+
+        if (exchange.iCommand == Private::commandBytes(aApdu) &&
+            exchange.iLe == aApdu->le) {
+            iPrivate->iNext++;
+            complete(aCancel, aCallback, aUserData, aDestroy,
+                exchange.iResponse, exchange.iSw, Q_NULLPTR);
+            return true;
+        }
+        HWARN("Unexpected APDU, exchange #" << (index + 1));
+    } else {
+        HWARN("End of transcript");
+    }
+    complete(aCancel, aCallback, aUserData, aDestroy, QByteArray(), 0,
+        "Unexpected APDU");
+    return true;
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#ifndef TRAVEL_CARD_REPLAY_H
+#define TRAVEL_CARD_REPLAY_H
+
+#include "TravelCardTransport.h"
+
+#include <QtCore/QByteArray>
+#include <QtCore/QList>
+
+// Replays a transcript of an ISO-DEP session in the format produced by
+// TravelCardApduLog (which ends up in the "debug" section of the card info
+// and can be exported from the debug page). Each exchange looks like this:
+//
+//   90 5a 00 00 1420ef 0100
+//   9100
+//
+// i.e. CLA INS P1 P2, command data (or "-" if there's none) and Le on
+// the first line, response data (if any) and SW1SW2 on the second one.
+// Exchanges are separated by empty lines.
+//
+// Commands must arrive in the recorded order, anything unexpected
+// fails with an I/O error.
+class TravelCardReplay :
+    public TravelCardTransport
+{
+public:
+    struct Exchange {
+        QByteArray iCommand;    // CLA INS P1 P2 followed by the data
+        uint iLe;
+        QByteArray iResponse;   // Without SW1SW2
+        uint iSw;
+    };
+
+    typedef QList<Exchange> Transcript;
+
+    static const char PATH_PREFIX[]; // "replay:"
+
+    TravelCardReplay(const Transcript&);
+    ~TravelCardReplay();
+
+    static bool parse(const QString&, Transcript*);
+    static bool load(const QString& aFileName, Transcript*);
+
+    bool transmit(const NfcIsoDepApdu*, GCancellable*,
+        NfcIsoDepClientTransmitFunc, void*, GDestroyNotify) Q_DECL_OVERRIDE;
+
+private:
+    class Private;
+    Private* iPrivate;
+};
+
+#endif // TRAVEL_CARD_REPLAY_H
@@ -0,0 +1,263 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "nfcdc_isodep.h"
+#include "nfcdc_tag.h"
+
+#include "TravelCardSession.h"
+#include "TravelCardTrace.h"
+#ifdef MATKAKORTTI_TRANSPORTS
+#include "TravelCardTransport.h"
+#endif
+
+#include "HarbourDebug.h"
+
+enum tag_events {
+    TAG_EVENT_VALID,
+    TAG_EVENT_PRESENT,
+    TAG_EVENT_COUNT
+};
+
+// ==========================================================================
+// TravelCardSession::Private
+// ==========================================================================
+
+class TravelCardSession::Private
+{
+public:
+    Private(const QString&, TravelCardSession*);
+    ~Private();
+
+    void update();
+    void setState(State);
+
+    static void tagEventHandler(NfcTagClient*, NFC_TAG_PROPERTY, void*);
+    static void isoDepEventHandler(NfcIsoDepClient*, NFC_ISODEP_PROPERTY, void*);
+    static void tagLockResp(NfcTagClient*, NfcTagClientLock*, const GError*, void*);
+
+public:
+    TravelCardSession* iSession;
+    const QString iPath;
+    State iState;
+    NfcTagClient* iTag;
+    NfcTagClientLock* iLock;
+    NfcIsoDepClient* iIsoDep;
+    gulong iTagEventId[TAG_EVENT_COUNT];
+    gulong iIsoDepEventId[TAG_EVENT_COUNT];
+    GCancellable* iCancel;
+};
+
+TravelCardSession::Private::Private(
+    const QString& aPath,
+    TravelCardSession* aSession) :
+    iSession(aSession),
+    iPath(aPath),
+    iState(Waiting),
+    iTag(Q_NULLPTR),
+    iLock(Q_NULLPTR),
+    iIsoDep(Q_NULLPTR),
+    iCancel(Q_NULLPTR)
+{
+    memset(iTagEventId, 0, sizeof(iTagEventId));
+    memset(iIsoDepEventId, 0, sizeof(iIsoDepEventId));
+#ifdef MATKAKORTTI_TRANSPORTS
+    if (TravelCardTransport::isTransportPath(aPath)) {
+        // No nfcd involved
+        iState = Ready;
+        return;
+    }
+#endif
+
+    QByteArray bytes(aPath.toLatin1());
+    const char* path = bytes.constData();
+
+    // Both clients are initialized in parallel, and the lock is
+    // requested as soon as the tag client is ready
+    iTag = nfc_tag_client_new(path);
+    iTagEventId[TAG_EVENT_VALID] =
+        nfc_tag_client_add_property_handler(iTag,
+            NFC_TAG_PROPERTY_VALID, tagEventHandler, this);
+    iTagEventId[TAG_EVENT_PRESENT] =
+        nfc_tag_client_add_property_handler(iTag,
+            NFC_TAG_PROPERTY_PRESENT, tagEventHandler, this);
+
+    iIsoDep = nfc_isodep_client_new(path);
+    iIsoDepEventId[TAG_EVENT_VALID] =
+        nfc_isodep_client_add_property_handler(iIsoDep,
+            NFC_ISODEP_PROPERTY_VALID, isoDepEventHandler, this);
+    iIsoDepEventId[TAG_EVENT_PRESENT] =
+        nfc_isodep_client_add_property_handler(iIsoDep,
+            NFC_ISODEP_PROPERTY_PRESENT, isoDepEventHandler, this);
+
+    // Either of them may already be known
+    update();
+}
+
+TravelCardSession::Private::~Private()
+{
+    if (iCancel) {
+        g_cancellable_cancel(iCancel);
+        g_object_unref(iCancel);
+    }
+    if (iLock) {
+        nfc_tag_client_lock_unref(iLock);
+    }
+    if (iIsoDep) {
+        nfc_isodep_client_remove_all_handlers(iIsoDep, iIsoDepEventId);
+        nfc_isodep_client_unref(iIsoDep);
+    }
+    if (iTag) {
+        nfc_tag_client_remove_all_handlers(iTag, iTagEventId);
+        nfc_tag_client_unref(iTag);
+    }
+}
+
+void
+TravelCardSession::Private::setState(
+    State aState)
+{
+    if (iState != aState) {
+        HDEBUG(iPath << aState);
+        iState = aState;
+        Q_EMIT iSession->stateChanged();
+    }
+}
+
+void
+TravelCardSession::Private::update()
+{
+    if (iTag->valid && !iTag->present) {
+        // The lock request (if any) is pointless now
+        if (iCancel) {
+            g_cancellable_cancel(iCancel);
+        }
+        setState(TagLost);
+    } else if (iState == Waiting) {
+        if (iTag->valid && iTag->present && !iCancel) {
+            iCancel = g_cancellable_new();
+            nfc_tag_client_acquire_lock(iTag, TRUE, iCancel, tagLockResp,
+                this, Q_NULLPTR);
+        }
+        if (iIsoDep->valid) {
+            if (!iIsoDep->present) {
+                // Not an ISO-DEP card
+                setState(NotIsoDep);
+            } else if (iLock) {
+                setState(Ready);
+            }
+        }
+    }
+}
+
+/* static */
+void
+TravelCardSession::Private::tagLockResp(
+    NfcTagClient*,
+    NfcTagClientLock* aLock,
+    const GError* aError,
+    void* aPrivate)
+{
+    Private* self = (Private*)aPrivate;
+
+    HASSERT(!self->iLock);
+    if (aLock) {
+        self->iLock = nfc_tag_client_lock_ref(aLock);
+        TRACE_INSTANT("tagLocked");
+        self->update();
+    } else {
+        HWARN("Failed to lock the tag:" << aError->message);
+        self->setState(LockFailed);
+    }
+}
+
+/* static */
+void
+TravelCardSession::Private::isoDepEventHandler(
+    NfcIsoDepClient*,
+    NFC_ISODEP_PROPERTY,
+    void* aPrivate)
+{
+    ((Private*)aPrivate)->update();
+}
+
+/* static */
+void
+TravelCardSession::Private::tagEventHandler(
+    NfcTagClient*,
+    NFC_TAG_PROPERTY aProperty,
+    void* aPrivate)
+{
+    TRACE_INSTANT(aProperty == NFC_TAG_PROPERTY_PRESENT ?
+        "tagPresentChanged" : "tagValidChanged");
+    ((Private*)aPrivate)->update();
+}
+
+// ==========================================================================
+// TravelCardSession
+// ==========================================================================
+
+TravelCardSession::TravelCardSession(
+    const QString& aPath,
+    QObject* aParent) :
+    QObject(aParent),
+    iPrivate(new Private(aPath, this))
+{
+}
+
+TravelCardSession::~TravelCardSession()
+{
+    delete iPrivate;
+}
+
+QString
+TravelCardSession::path() const
+{
+    return iPrivate->iPath;
+}
+
+TravelCardSession::State
+TravelCardSession::state() const
+{
+    return iPrivate->iState;
+}
+
+NfcIsoDepClient*
+TravelCardSession::isoDep() const
+{
+    return iPrivate->iIsoDep;
+}
@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#ifndef TRAVEL_CARD_SESSION_H
+#define TRAVEL_CARD_SESSION_H
+
+#include "nfcdc_types.h"
+
+#include <QtCore/QObject>
+#include <QtCore/QString>
+
+// Access to the tag shared by all the card drivers which get to try
+// it. Owned by TravelCard, created as soon as the tag shows up. The
+// tag gets locked as soon as it's present, while the ISO-DEP client
+// is still being initialized, and stays locked until the session is
+// destroyed. Removal of the tag is noticed right away, whatever state
+// the session is in. Paths handled by TravelCardTransport (only in the
+// builds with CONFIG+=transports) don't involve nfcd, such a session is
+// ready right away.
+class TravelCardSession :
+    public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY(TravelCardSession)
+
+public:
+    enum State {
+        Waiting,
+        Ready,          // Tag is locked and supports ISO-DEP
+        NotIsoDep,
+        LockFailed,
+        TagLost
+    };
+
+    TravelCardSession(const QString& aPath, QObject* aParent);
+    ~TravelCardSession();
+
+    QString path() const;
+    State state() const;
+
+    // NULL if the path is handled by TravelCardTransport
+    NfcIsoDepClient* isoDep() const;
+
+Q_SIGNALS:
+    void stateChanged();
+
+private:
+    class Private;
+    Private* iPrivate;
+};
+
+#endif // TRAVEL_CARD_SESSION_H
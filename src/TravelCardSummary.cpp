@@ -0,0 +1,175 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "TravelCardSummary.h"
+
+// ==========================================================================
+// TravelCardSummary::Private
+// ==========================================================================
+
+class TravelCardSummary::Private
+{
+public:
+    Private(const QString&);
+
+    bool valid() const;
+
+public:
+    const QString iCardType;
+    int iBalance;
+    int iTicketSecondsRemaining;
+    int iPeriodPassDaysRemaining;
+    QDateTime iPeriodPassEndDate;
+};
+
+TravelCardSummary::Private::Private(
+    const QString& aCardType) :
+    iCardType(aCardType),
+    iBalance(0),
+    iTicketSecondsRemaining(0),
+    iPeriodPassDaysRemaining(0)
+{}
+
+inline
+bool
+TravelCardSummary::Private::valid() const
+{
+    return iTicketSecondsRemaining > 0 || iPeriodPassDaysRemaining > 0;
+}
+
+// ==========================================================================
+// TravelCardSummary
+// ==========================================================================
+
+TravelCardSummary::TravelCardSummary(
+    const QString& aCardType,
+    QObject* aParent) :
+    QObject(aParent),
+    iPrivate(new Private(aCardType))
+{}
+
+TravelCardSummary::~TravelCardSummary()
+{
+    delete iPrivate;
+}
+
+QString
+TravelCardSummary::cardType() const
+{
+    return iPrivate->iCardType;
+}
+
+int
+TravelCardSummary::balance() const
+{
+    return iPrivate->iBalance;
+}
+
+int
+TravelCardSummary::ticketSecondsRemaining() const
+{
+    return iPrivate->iTicketSecondsRemaining;
+}
+
+int
+TravelCardSummary::periodPassDaysRemaining() const
+{
+    return iPrivate->iPeriodPassDaysRemaining;
+}
+
+QDateTime
+TravelCardSummary::periodPassEndDate() const
+{
+    return iPrivate->iPeriodPassEndDate;
+}
+
+bool
+TravelCardSummary::valid() const
+{
+    return iPrivate->valid();
+}
+
+void
+TravelCardSummary::setBalance(
+    int aBalance)
+{
+    if (iPrivate->iBalance != aBalance) {
+        iPrivate->iBalance = aBalance;
+        Q_EMIT balanceChanged();
+    }
+}
+
+void
+TravelCardSummary::setTicketSecondsRemaining(
+    int aSeconds)
+{
+    if (iPrivate->iTicketSecondsRemaining != aSeconds) {
+        const bool wasValid = iPrivate->valid();
+
+        iPrivate->iTicketSecondsRemaining = aSeconds;
+        Q_EMIT ticketSecondsRemainingChanged();
+        if (wasValid != iPrivate->valid()) {
+            Q_EMIT validChanged();
+        }
+    }
+}
+
+void
+TravelCardSummary::setPeriodPassDaysRemaining(
+    int aDays)
+{
+    if (iPrivate->iPeriodPassDaysRemaining != aDays) {
+        const bool wasValid = iPrivate->valid();
+
+        iPrivate->iPeriodPassDaysRemaining = aDays;
+        Q_EMIT periodPassDaysRemainingChanged();
+        if (wasValid != iPrivate->valid()) {
+            Q_EMIT validChanged();
+        }
+    }
+}
+
+void
+TravelCardSummary::setPeriodPassEndDate(
+    const QDateTime& aDate)
+{
+    if (iPrivate->iPeriodPassEndDate != aDate) {
+        iPrivate->iPeriodPassEndDate = aDate;
+        Q_EMIT periodPassEndDateChanged();
+    }
+}
@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#ifndef TRAVEL_CARD_SUMMARY_H
+#define TRAVEL_CARD_SUMMARY_H
+
+#include <QtCore/QDateTime>
+#include <QtCore/QObject>
+#include <QtCore/QVariantMap>
+
+// What the cover shows: the balance and the nearest expiry. Owned by
+// TravelCard and fed by the card specific subclass from the card info,
+// with its own (minimal) set of parsers, so it doesn't depend on the
+// card page being alive. The parsers take care of updating the time
+// dependent values when the deadlines come.
+class TravelCardSummary :
+    public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY(TravelCardSummary)
+    Q_PROPERTY(QString cardType READ cardType CONSTANT)
+    Q_PROPERTY(int balance READ balance NOTIFY balanceChanged)
+    Q_PROPERTY(int ticketSecondsRemaining READ ticketSecondsRemaining NOTIFY ticketSecondsRemainingChanged)
+    Q_PROPERTY(int periodPassDaysRemaining READ periodPassDaysRemaining NOTIFY periodPassDaysRemainingChanged)
+    Q_PROPERTY(QDateTime periodPassEndDate READ periodPassEndDate NOTIFY periodPassEndDateChanged)
+    Q_PROPERTY(bool valid READ valid NOTIFY validChanged)
+
+protected:
+    TravelCardSummary(const QString& aCardType, QObject* aParent);
+
+public:
+    ~TravelCardSummary();
+
+    virtual void setCardInfo(const QVariantMap&) = 0;
+
+    QString cardType() const;
+    int balance() const;                    // Cents
+    int ticketSecondsRemaining() const;
+    int periodPassDaysRemaining() const;
+    QDateTime periodPassEndDate() const;
+    bool valid() const;                     // Ticket or period is valid
+
+protected:
+    void setBalance(int);
+    void setTicketSecondsRemaining(int);
+    void setPeriodPassDaysRemaining(int);
+    void setPeriodPassEndDate(const QDateTime&);
+
+Q_SIGNALS:
+    void balanceChanged();
+    void ticketSecondsRemainingChanged();
+    void periodPassDaysRemainingChanged();
+    void periodPassEndDateChanged();
+    void validChanged();
+
+private:
+    class Private;
+    Private* iPrivate;
+};
+
+#endif // TRAVEL_CARD_SUMMARY_H
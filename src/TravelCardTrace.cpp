@@ -0,0 +1,251 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "TravelCardTrace.h"
+
+#include "HarbourDebug.h"
+
+#include <QtCore/QHash>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QMutex>
+#include <QtCore/QSaveFile>
+#include <QtQml/QQmlEngine>
+
+#include <atomic>
+
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+// Must be a power of two
+#define TRACE_RING_SIZE (4096)
+
+// Each slot is a tiny seqlock. The sequence number is zero while the
+// slot is being written, and the number of the event plus one when
+// it's complete. The reader only takes the slots which have the same
+// (expected) sequence number before and after copying the contents.
+typedef struct trace_event {
+    std::atomic<quint64> seq;
+    std::atomic<const char*> name;
+    std::atomic<qint64> ts;
+    std::atomic<qint64> dur;    // Negative for instant events
+    std::atomic<int> tid;
+} TraceEvent;
+
+// Zero-initialized, no constructors involved
+static TraceEvent trace_ring[TRACE_RING_SIZE];
+static std::atomic<quint64> trace_next(0);
+static std::atomic<bool> trace_expect_frame(false);
+
+static
+int
+trace_tid()
+{
+    static thread_local int tid = 0;
+
+    if (!tid) {
+        tid = (int) syscall(SYS_gettid);
+    }
+    return tid;
+}
+
+static
+void
+trace_record(
+    const char* aName,
+    qint64 aTs,
+    qint64 aDur)
+{
+    const quint64 seq = trace_next.fetch_add(1, std::memory_order_relaxed);
+    TraceEvent* event = trace_ring + (seq & (TRACE_RING_SIZE - 1));
+
+    event->seq.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    event->name.store(aName, std::memory_order_relaxed);
+    event->ts.store(aTs, std::memory_order_relaxed);
+    event->dur.store(aDur, std::memory_order_relaxed);
+    event->tid.store(trace_tid(), std::memory_order_relaxed);
+    event->seq.store(seq + 1, std::memory_order_release);
+}
+
+// ==========================================================================
+// TravelCardTrace
+// ==========================================================================
+
+const char TravelCardTrace::FILE_ENV[] = "MATKAKORTTI_TRACE_FILE";
+
+TravelCardTrace::TravelCardTrace()
+{
+    // QML must not delete it
+    QQmlEngine::setObjectOwnership(this, QQmlEngine::CppOwnership);
+}
+
+TravelCardTrace*
+TravelCardTrace::instance()
+{
+    static TravelCardTrace* gInstance = Q_NULLPTR;
+
+    if (!gInstance) {
+        gInstance = new TravelCardTrace;
+    }
+    return gInstance;
+}
+
+qint64
+TravelCardTrace::now()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * Q_INT64_C(1000000000) + ts.tv_nsec;
+}
+
+void
+TravelCardTrace::instant(
+    const char* aName)
+{
+    trace_record(aName, now(), -1);
+}
+
+void
+TravelCardTrace::complete(
+    const char* aName,
+    qint64 aStart)
+{
+    trace_record(aName, aStart, now() - aStart);
+}
+
+void
+TravelCardTrace::expectFrame()
+{
+    trace_expect_frame.store(true, std::memory_order_relaxed);
+}
+
+void
+TravelCardTrace::frameSwapped()
+{
+    // Typically invoked on the render thread
+    if (trace_expect_frame.exchange(false, std::memory_order_relaxed)) {
+        instant("frameSwapped");
+    }
+}
+
+QByteArray
+TravelCardTrace::toJson()
+{
+    const quint64 end = trace_next.load(std::memory_order_acquire);
+    const quint64 start = (end > TRACE_RING_SIZE) ? (end - TRACE_RING_SIZE) : 0;
+    const qint64 pid = getpid();
+    QJsonArray events;
+
+    for (quint64 seq = start; seq < end; seq++) {
+        const TraceEvent* event = trace_ring + (seq & (TRACE_RING_SIZE - 1));
+
+        if (event->seq.load(std::memory_order_acquire) == seq + 1) {
+            const char* name = event->name.load(std::memory_order_relaxed);
+            const qint64 ts = event->ts.load(std::memory_order_relaxed);
+            const qint64 dur = event->dur.load(std::memory_order_relaxed);
+            const int tid = event->tid.load(std::memory_order_relaxed);
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (event->seq.load(std::memory_order_relaxed) == seq + 1) {
+                QJsonObject obj;
+
+                // Timestamps are in microseconds
+                obj.insert("name", QString::fromUtf8(name));
+                obj.insert("cat", QStringLiteral("matkakortti"));
+                obj.insert("ts", ts / 1e3);
+                obj.insert("pid", pid);
+                obj.insert("tid", tid);
+                if (dur < 0) {
+                    obj.insert("ph", QStringLiteral("i"));
+                    obj.insert("s", QStringLiteral("t"));
+                } else {
+                    obj.insert("ph", QStringLiteral("X"));
+                    obj.insert("dur", dur / 1e3);
+                }
+                events.append(obj);
+            }
+        }
+    }
+
+    QJsonObject trace;
+    trace.insert("traceEvents", events);
+    trace.insert("displayTimeUnit", QStringLiteral("ms"));
+    return QJsonDocument(trace).toJson(QJsonDocument::Compact);
+}
+
+bool
+TravelCardTrace::save(
+    const QString& aFileName)
+{
+    QSaveFile file(aFileName);
+
+    if (file.open(QIODevice::WriteOnly) &&
+        file.write(toJson()) >= 0 &&
+        file.commit()) {
+        HDEBUG("Trace saved to" << qPrintable(aFileName));
+        return true;
+    }
+    HWARN("Failed to save" << qPrintable(aFileName));
+    return false;
+}
+
+void
+TravelCardTrace::mark(
+    const QString& aName)
+{
+    // The ring stores plain pointers, those have to stay valid
+    static QMutex gMutex;
+    static QHash<QString,QByteArray> gNames;
+    QMutexLocker lock(&gMutex);
+    QHash<QString,QByteArray>::const_iterator it = gNames.constFind(aName);
+
+    if (it == gNames.constEnd()) {
+        it = gNames.insert(aName, aName.toUtf8());
+    }
+    instant(it.value().constData());
+}
+
+QString
+TravelCardTrace::json() const
+{
+    return QString::fromUtf8(toJson());
+}
@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#ifndef TRAVEL_CARD_TRACE_H
+#define TRAVEL_CARD_TRACE_H
+
+// Timeline of a tap in Trace Event format, which chrome://tracing
+// and Perfetto (ui.perfetto.dev) can open. Events are kept in a fixed
+// size lock-free ring, so recording one costs a few atomic stores and
+// the oldest events are silently overwritten.
+//
+// Only compiled in with CONFIG+=trace, otherwise the macros at the
+// bottom expand to nothing. The trace can be copied from the debug
+// page (where it's available as debug.trace object), saved to the
+// file specified by MATKAKORTTI_TRACE_FILE on exit or written by
+// matkakortti-cli --trace FILE.
+
+#ifdef MATKAKORTTI_TRACE
+
+#include <QtCore/QObject>
+#include <QtCore/QString>
+
+class TravelCardTrace :
+    public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY(TravelCardTrace)
+
+public:
+    static const char FILE_ENV[];   // "MATKAKORTTI_TRACE_FILE"
+
+    class Scope {
+        Q_DISABLE_COPY(Scope)
+    public:
+        Scope(const char* aName) : iName(aName), iStart(now()) {}
+        ~Scope() { complete(iName, iStart); }
+    private:
+        const char* iName;
+        const qint64 iStart;
+    };
+
+    static TravelCardTrace* instance();
+
+    // Names must be string literals (or otherwise stay around forever)
+    static qint64 now();
+    static void instant(const char* aName);
+    static void complete(const char* aName, qint64 aStart);
+
+    // Only the first frame after expectFrame() gets recorded
+    static void expectFrame();
+    static void frameSwapped();
+
+    static QByteArray toJson();
+    static bool save(const QString& aFileName);
+
+    // For QML, which has no string literals
+    Q_INVOKABLE void mark(const QString& aName);
+    Q_INVOKABLE QString json() const;
+
+private:
+    TravelCardTrace();
+};
+
+#  define TRACE_SCOPE(name) TravelCardTrace::Scope traceScope(name)
+#  define TRACE_INSTANT(name) TravelCardTrace::instant(name)
+#  define TRACE_EXPECT_FRAME() TravelCardTrace::expectFrame()
+#else
+#  define TRACE_SCOPE(name) ((void)0)
+#  define TRACE_INSTANT(name) ((void)0)
+#  define TRACE_EXPECT_FRAME() ((void)0)
+#endif // MATKAKORTTI_TRACE
+
+#endif // TRAVEL_CARD_TRACE_H
@@ -0,0 +1,220 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "TravelCardDump.h"
+#include "TravelCardEmulator.h"
+#include "TravelCardReplay.h"
+#include "TravelCardTransport.h"
+
+#include "HarbourDebug.h"
+
+#include <QtCore/QList>
+
+#include <gio/gio.h>
+
+// ==========================================================================
+// TravelCardTransport::Private
+// ==========================================================================
+
+class TravelCardTransport::Private
+{
+public:
+    struct Pending {
+        Private* iPrivate;
+        guint iId;
+        GCancellable* iCancel;
+        NfcIsoDepClientTransmitFunc iCallback;
+        void* iUserData;
+        GDestroyNotify iDestroy;
+        QByteArray iResponse;
+        uint iSw;
+        const char* iErrorMessage;
+    };
+
+    ~Private();
+
+    static gboolean deliver(gpointer);
+    static void finish(gpointer);
+
+public:
+    QList<Pending*> iPending;
+};
+
+TravelCardTransport::Private::~Private()
+{
+    // finish() removes the entry from the list
+    while (!iPending.isEmpty()) {
+        g_source_remove(iPending.first()->iId);
+    }
+}
+
+/* static */
+gboolean
+TravelCardTransport::Private::deliver(
+    gpointer aPending)
+{
+    Pending* pending = (Pending*)aPending;
+
+    if (!pending->iCancel || !g_cancellable_is_cancelled(pending->iCancel)) {
+        if (!pending->iErrorMessage) {
+            GUtilData response;
+
+            response.bytes = (const guint8*)pending->iResponse.constData();
+            response.size = pending->iResponse.size();
+            pending->iCallback(Q_NULLPTR, &response, pending->iSw, Q_NULLPTR,
+                pending->iUserData);
+        } else {
+            GError* error = g_error_new_literal(G_IO_ERROR, G_IO_ERROR_FAILED,
+                pending->iErrorMessage);
+
+            pending->iCallback(Q_NULLPTR, Q_NULLPTR, 0, error,
+                pending->iUserData);
+            g_error_free(error);
+        }
+    }
+    return G_SOURCE_REMOVE;
+}
+
+/* static */
+void
+TravelCardTransport::Private::finish(
+    gpointer aPending)
+{
+    Pending* pending = (Pending*)aPending;
+
+    pending->iPrivate->iPending.removeOne(pending);
+    if (pending->iDestroy) {
+        pending->iDestroy(pending->iUserData);
+    }
+    if (pending->iCancel) {
+        g_object_unref(pending->iCancel);
+    }
+    delete pending;
+}
+
+// ==========================================================================
+// TravelCardTransport
+// ==========================================================================
+
+TravelCardTransport::TravelCardTransport() :
+    iPrivate(new Private)
+{
+}
+
+TravelCardTransport::~TravelCardTransport()
+{
+    delete iPrivate;
+}
+
+void
+TravelCardTransport::complete(
+    GCancellable* aCancel,
+    NfcIsoDepClientTransmitFunc aCallback,
+    void* aUserData,
+    GDestroyNotify aDestroy,
+    const QByteArray& aResponse,
+    uint aSw,
+    const char* aErrorMessage,
+    uint aDelay)
+{
+    Private::Pending* pending = new Private::Pending;
+
+    pending->iPrivate = iPrivate;
+    pending->iCancel = aCancel ? (GCancellable*)g_object_ref(aCancel) :
+        Q_NULLPTR;
+    pending->iCallback = aCallback;
+    pending->iUserData = aUserData;
+    pending->iDestroy = aDestroy;
+    pending->iResponse = aResponse;
+    pending->iSw = aSw;
+    pending->iErrorMessage = aErrorMessage;
+    pending->iId = aDelay ?
+        g_timeout_add_full(G_PRIORITY_DEFAULT, aDelay, Private::deliver,
+            pending, Private::finish) :
+        g_idle_add_full(G_PRIORITY_DEFAULT_IDLE, Private::deliver,
+            pending, Private::finish);
+    iPrivate->iPending.append(pending);
+}
+
+TravelCardTransport*
+TravelCardTransport::create(
+    const QString& aPath)
+{
+    const QString replayPrefix(QLatin1String(TravelCardReplay::PATH_PREFIX));
+    const QString emulatorPrefix(QLatin1String(TravelCardEmulator::PATH_PREFIX));
+
+    if (aPath.startsWith(replayPrefix)) {
+        const QString file(aPath.mid(replayPrefix.length()));
+        TravelCardReplay::Transcript transcript;
+        QList<TravelCardDump> dumps;
+
+        if (TravelCardDump::load(file, &dumps) && !dumps.isEmpty()) {
+            // A binary dump has no APDUs in it, the emulated card
+            // answers whatever the driver asks based on its contents
+            TravelCardEmulator::Config config;
+
+            TravelCardEmulator::fromDump(dumps.first(), &config);
+            return new TravelCardEmulator(config);
+        }
+
+        // With an empty transcript every transmission fails,
+        // which is what a tag without the right files would do
+        if (!TravelCardReplay::load(file, &transcript)) {
+            HWARN("Failed to load" << qPrintable(file));
+        }
+        return new TravelCardReplay(transcript);
+    } else if (aPath.startsWith(emulatorPrefix)) {
+        const QString file(aPath.mid(emulatorPrefix.length()));
+        TravelCardEmulator::Config config;
+
+        // Default config is a card without any applications
+        if (!TravelCardEmulator::load(file, &config)) {
+            HWARN("Failed to load" << qPrintable(file));
+        }
+        return new TravelCardEmulator(config);
+    }
+    return Q_NULLPTR;
+}
+
+bool
+TravelCardTransport::isTransportPath(
+    const QString& aPath)
+{
+    return aPath.startsWith(QLatin1String(TravelCardReplay::PATH_PREFIX)) ||
+        aPath.startsWith(QLatin1String(TravelCardEmulator::PATH_PREFIX));
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#ifndef TRAVEL_CARD_TRANSPORT_H
+#define TRAVEL_CARD_TRANSPORT_H
+
+#include "nfcdc_isodep.h"
+
+#include <QtCore/QByteArray>
+#include <QtCore/QString>
+
+// In-process replacement for the nfcd ISO-DEP client. Such transports
+// are selected by the tag path (see create()) and follow the semantics
+// of nfc_isodep_client_transmit() except that the client pointer passed
+// to the completion callback is NULL. The callback is never invoked
+// synchronously (from within transmit() call) and isn't invoked at all
+// if the cancellable gets cancelled before the response is delivered.
+// The destroy notification is always invoked, sooner or later.
+//
+// Only compiled in with CONFIG+=transports (the tools), the app always
+// talks to nfcd.
+class TravelCardTransport
+{
+    Q_DISABLE_COPY(TravelCardTransport)
+
+protected:
+    TravelCardTransport();
+
+    // Schedules the completion callback. NULL error message (which
+    // otherwise must be a static string) means success. The response
+    // is delivered after the specified delay (in milliseconds) or at
+    // idle time if there's no delay.
+    void complete(GCancellable*, NfcIsoDepClientTransmitFunc, void*,
+        GDestroyNotify, const QByteArray& aResponse, uint aSw,
+        const char* aErrorMessage, uint aDelay = 0);
+
+public:
+    virtual ~TravelCardTransport();
+    virtual bool transmit(const NfcIsoDepApdu*, GCancellable*,
+        NfcIsoDepClientTransmitFunc, void*, GDestroyNotify) = 0;
+
+    // Returns NULL for nfcd tag paths
+    static TravelCardTransport* create(const QString& aPath);
+    static bool isTransportPath(const QString& aPath);
+
+private:
+    class Private;
+    Private* iPrivate;
+};
+
+#endif // TRAVEL_CARD_TRANSPORT_H
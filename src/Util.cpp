@@ -39,6 +39,8 @@
 
 #include "Util.h"
 
+#include <QtCore/QLocale>
+
 const QString Util::CARD_TYPE_KEY("cardType");
 const QTimeZone Util::FINLAND_TIMEZONE("Europe/Helsinki");
 
@@ -95,3 +97,23 @@ Util::toData(
     data.bytes = (guint8*)bytes.constData();
     return data;
 }
+
+// Same as moneyString() in qml/components/Utils.js
+QString
+Util::moneyString(
+    int aCents)
+{
+    static const QString EURO(QStringLiteral(" \u20ac"));
+    return aCents ? (QString::number(aCents/100.0, 'f', 2) + EURO) : QString();
+}
+
+// Same as dateTimeString() in qml/components/Utils.js
+QString
+Util::dateTimeString(
+    const QDateTime& aDateTime)
+{
+    static const QString FORMAT("dd.MM.yyyy hh:mm");
+    return aDateTime.isValid() ?
+        QLocale().toString(aDateTime.toLocalTime(), FORMAT) :
+        QString();
+}
@@ -58,6 +58,8 @@ namespace Util {
     guint16 uint16be(const guint8*);
 
     GUtilData toData(const QByteArray&);
+    QString moneyString(int);                 // Empty string for zero
+    QString dateTimeString(const QDateTime&); // In local time
     inline QByteArray toByteArray(const GUtilData* aData)
         { return QByteArray((const char*)aData->bytes, (int)aData->size); }
     inline QDateTime finnishTime(const QDateTime aDateTime)
@@ -44,8 +44,14 @@
 #include "HslCardEticket.h"
 #include "HslCardHistory.h"
 #include "HslCardPeriodPass.h"
+#include "HslCardStatistics.h"
 #include "HslCardStoredValue.h"
 #include "HslData.h"
+#include "TravelCardAllocStats.h"
+#include "TravelCardArchive.h"
+#include "TravelCardDump.h"
+#include "TravelCardSummary.h"
+#include "TravelCardTrace.h"
 #include "Util.h"
 
 #include <QtQml/QtQml>
@@ -77,10 +83,9 @@ public:
     void readFailed();
     void readSucceeded();
 
-    static TravelCardImpl* newTravelCard(QString, QObject*);
+    static TravelCardImpl* newTravelCard(TravelCardSession*, QObject*);
     static void registerTypes(const char*, int, int);
-
-    static const QString PAGE_URL;
+    static TravelCardSummary* newSummary(QObject*);
 
     static const QString APP_INFO_KEY;
     static const QString PERIOD_PASS_KEY;
@@ -107,6 +112,7 @@ public:
     static const uint PERIODPASS_SIZE = 35;
     static const uint STOREDVALUE_SIZE = 13;
     static const uint ETICKET_SIZE = 45;
+    static const uint HISTORY_ENTRY_SIZE = 12;
 
     static const uint SW_OK = NFC_ISODEP_SW(0x91, 0x00);
     static const uint SW_MORE = NFC_ISODEP_SW(0x91, 0xaf);
@@ -127,8 +133,6 @@ public:
     QByteArray iHistoryData;
 };
 
-const QString HslCard::Private::PAGE_URL("hsl/HslPage.qml");
-
 const QString HslCard::Private::APP_INFO_KEY("appInfo");
 const QString HslCard::Private::PERIOD_PASS_KEY("periodPass");
 const QString HslCard::Private::STORED_VALUE_KEY("storedValue");
@@ -220,14 +224,22 @@ HslCard::Private::transmit(
 void
 HslCard::Private::readSucceeded()
 {
-    QVariantMap cardInfo;
-    cardInfo.insert(Util::CARD_TYPE_KEY, Desc.iName);
-    cardInfo.insert(APP_INFO_KEY, HarbourUtil::toHex(iAppInfoData));
-    cardInfo.insert(PERIOD_PASS_KEY, HarbourUtil::toHex(iPeriodPassData));
-    cardInfo.insert(STORED_VALUE_KEY, HarbourUtil::toHex(iStoredValueData));
-    cardInfo.insert(ETICKET_KEY, HarbourUtil::toHex(iEticketData));
-    cardInfo.insert(HISTORY_KEY, HarbourUtil::toHex(iHistoryData));
-    parentObject()->success(PAGE_URL, cardInfo);
+    TRACE_SCOPE("HslCard::readSucceeded");
+    ALLOC_STATS_SCOPE(ReadSucceeded);
+
+    // Card number is BCD encoded in bytes 1-9 of the application info.
+    // Save the history before the card forgets it.
+    TravelCardArchive::store(Desc.iName,
+        HarbourUtil::toHex(iAppInfoData.mid(1, 9)),
+        HISTORY_ENTRY_SIZE, HslCardHistory::entryTime, iHistoryData);
+
+    TravelCardDump dump(Desc.iName);
+    dump.addBlock(APP_INFO_KEY, iAppInfoData);
+    dump.addBlock(PERIOD_PASS_KEY, iPeriodPassData);
+    dump.addBlock(STORED_VALUE_KEY, iStoredValueData);
+    dump.addBlock(ETICKET_KEY, iEticketData);
+    dump.addBlock(HISTORY_KEY, iHistoryData);
+    parentObject()->success(Desc.iPageUrl, dump);
 }
 
 void
@@ -395,9 +407,9 @@ HslCard::Private::SELECT_RESPONSE_SLOT(
 // ==========================================================================
 
 HslCard::HslCard(
-    QString aPath,
+    TravelCardSession* aSession,
     QObject* aParent) :
-    TravelCardIsoDep(aPath, aParent),
+    TravelCardIsoDep(aSession, aParent),
     iPrivate(new Private(this))
 {}
 
@@ -408,6 +420,77 @@ HslCard::startIo()
     transmit(&Private::SELECT_CMD, iPrivate, QT_STRINGIFY(SELECT_RESPONSE_SLOT));
 }
 
+// ==========================================================================
+// HslCard::Summary
+// ==========================================================================
+
+class HslCard::Summary :
+    public TravelCardSummary
+{
+    Q_OBJECT
+
+public:
+    Summary(QObject*);
+
+    void setCardInfo(const QVariantMap&) Q_DECL_OVERRIDE;
+
+private Q_SLOTS:
+    void updateBalance();
+    void updateTicket();
+    void updatePeriodPass();
+
+private:
+    HslCardEticket* iEticket;
+    HslCardPeriodPass* iPeriodPass;
+    HslCardStoredValue* iStoredValue;
+};
+
+HslCard::Summary::Summary(
+    QObject* aParent) :
+    TravelCardSummary(Desc.iName, aParent),
+    iEticket(new HslCardEticket(this)),
+    iPeriodPass(new HslCardPeriodPass(this)),
+    iStoredValue(new HslCardStoredValue(this))
+{
+    // The parsers keep the remaining time up to date
+    connect(iEticket, SIGNAL(secondsRemainingChanged()),
+        SLOT(updateTicket()));
+    connect(iPeriodPass, SIGNAL(effectiveDaysRemainingChanged()),
+        SLOT(updatePeriodPass()));
+    connect(iPeriodPass, SIGNAL(effectiveEndDateChanged()),
+        SLOT(updatePeriodPass()));
+    connect(iStoredValue, SIGNAL(moneyValueChanged()),
+        SLOT(updateBalance()));
+}
+
+void
+HslCard::Summary::setCardInfo(
+    const QVariantMap& aCardInfo)
+{
+    iEticket->setData(aCardInfo.value(Private::ETICKET_KEY).toString());
+    iPeriodPass->setData(aCardInfo.value(Private::PERIOD_PASS_KEY).toString());
+    iStoredValue->setData(aCardInfo.value(Private::STORED_VALUE_KEY).toString());
+}
+
+void
+HslCard::Summary::updateBalance()
+{
+    setBalance(iStoredValue->moneyValue());
+}
+
+void
+HslCard::Summary::updateTicket()
+{
+    setTicketSecondsRemaining(iEticket->secondsRemaining());
+}
+
+void
+HslCard::Summary::updatePeriodPass()
+{
+    setPeriodPassEndDate(iPeriodPass->effectiveEndDate());
+    setPeriodPassDaysRemaining(iPeriodPass->effectiveDaysRemaining());
+}
+
 // ==========================================================================
 // HslCard::Desc
 // ==========================================================================
@@ -419,10 +502,10 @@ HslCard::startIo()
 
 TravelCardImpl*
 HslCard::Private::newTravelCard(
-    QString aPath,
+    TravelCardSession* aSession,
     QObject* aParent)
 {
-    return new HslCard(aPath, aParent);
+    return new HslCard(aSession, aParent);
 }
 
 void
@@ -436,14 +519,25 @@ HslCard::Private::registerTypes(
     REGISTER_TYPE(HslCardEticket, aUri, v1, v2);
     REGISTER_TYPE(HslCardHistory, aUri, v1, v2);
     REGISTER_TYPE(HslCardPeriodPass, aUri, v1, v2);
+    REGISTER_TYPE(HslCardStatistics, aUri, v1, v2);
     REGISTER_TYPE(HslCardStoredValue, aUri, v1, v2);
     REGISTER_SINGLETON_TYPE(HslData, aUri, v1, v2);
 }
 
+TravelCardSummary*
+HslCard::Private::newSummary(
+    QObject* aParent)
+{
+    return new Summary(aParent);
+}
+
 const TravelCardImpl::CardDesc HslCard::Desc = {
     QStringLiteral("HSL"),
+    QStringLiteral("hsl/HslPage.qml"),
     HslCard::Private::newTravelCard,
-    HslCard::Private::registerTypes
+    HslCard::Private::registerTypes,
+    HslCard::Private::newSummary,
+    NfcTechA // DESFire
 };
 
 #include "HslCard.moc"
@@ -47,7 +47,7 @@ class HslCard :
 {
     Q_OBJECT
     Q_DISABLE_COPY(HslCard)
-    HslCard(QString, QObject*);
+    HslCard(TravelCardSession*, QObject*);
 
 public:
     static const CardDesc Desc;
@@ -57,6 +57,7 @@ protected:
 
 private:
     class Private;
+    class Summary;
     Private* iPrivate;
 };
 
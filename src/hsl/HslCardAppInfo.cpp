@@ -39,6 +39,8 @@
 
 #include "HslCardAppInfo.h"
 #include "HslData.h"
+#include "TravelCardAllocStats.h"
+#include "TravelCardTrace.h"
 
 #include "HarbourDebug.h"
 #include "Util.h"
@@ -55,29 +57,52 @@ public:
     void setHexData(const QString&);
 
 public:
-    int iAppVersion;
     QString iHexData;
-    QString iCardNumber;
+    Info iInfo;
 };
 
-HslCardAppInfo::Private::Private() :
-    iAppVersion(0)
-{}
+HslCardAppInfo::Private::Private()
+{
+    decode(QByteArray(), &iInfo);
+}
 
 void
 HslCardAppInfo::Private::setHexData(
     const QString& aHexData)
 {
     QByteArray hexData(aHexData.toLatin1());
-    const QByteArray bytes(QByteArray::fromHex(hexData));
 
     HDEBUG(hexData.constData());
     iHexData = aHexData;
-    iCardNumber.clear();
-    iAppVersion = 0;
+    decode(QByteArray::fromHex(hexData), &iInfo);
+}
+
+// ==========================================================================
+// HslCardAppInfo
+// ==========================================================================
+
+HslCardAppInfo::HslCardAppInfo(
+    QObject* aParent) :
+    QObject(aParent),
+    iPrivate(new Private)
+{
+}
 
-    if (!bytes.isEmpty()) {
-        const GUtilData data = Util::toData(bytes);
+HslCardAppInfo::~HslCardAppInfo()
+{
+    delete iPrivate;
+}
+
+void
+HslCardAppInfo::decode(
+    const QByteArray& aBytes,
+    Info* aInfo)
+{
+    aInfo->iAppVersion = 0;
+    aInfo->iCardNumber.clear();
+
+    if (!aBytes.isEmpty()) {
+        const GUtilData data = Util::toData(aBytes);
 
         // ApplicationInformation
         //
@@ -91,31 +116,15 @@ HslCardAppInfo::Private::setHexData(
         // | 10/0     | 3     | uint  | Platform type             |
         // | 10/3     | 1     | uint  | Security level            |
         // +======================================================+
-        iAppVersion = HslData::getInt(&data, 0, 4);
-        HDEBUG("  ApplicationVersion =" << iAppVersion);
-        iCardNumber = iHexData.mid(2, 18);
-        HDEBUG("  CardNumber =" << iCardNumber);
+        aInfo->iAppVersion = HslData::getInt(&data, 0, 4);
+        HDEBUG("  ApplicationVersion =" << aInfo->iAppVersion);
+        aInfo->iCardNumber = QString::fromLatin1(aBytes.mid(1, 9).toHex());
+        HDEBUG("  CardNumber =" << aInfo->iCardNumber);
         HDEBUG("  PlatformType =" << HslData::getInt(&data, 10, 0, 3));
         HDEBUG("  SecurityLevel =" << HslData::getInt(&data, 10, 3, 1));
     }
 }
 
-// ==========================================================================
-// HslCardAppInfo
-// ==========================================================================
-
-HslCardAppInfo::HslCardAppInfo(
-    QObject* aParent) :
-    QObject(aParent),
-    iPrivate(new Private)
-{
-}
-
-HslCardAppInfo::~HslCardAppInfo()
-{
-    delete iPrivate;
-}
-
 QString
 HslCardAppInfo::data() const
 {
@@ -126,16 +135,18 @@ void
 HslCardAppInfo::setData(
     QString aData)
 {
+    TRACE_SCOPE("HslCardAppInfo::setData");
+    ALLOC_STATS_SCOPE(Parse);
+
     const QString data(aData.toLower());
     if (iPrivate->iHexData != data) {
-        const int appVersion(iPrivate->iAppVersion);
-        const QString cardNumber(iPrivate->iCardNumber);
+        const Info prev(iPrivate->iInfo);
 
         iPrivate->setHexData(data);
-        if (appVersion != iPrivate->iAppVersion) {
+        if (prev.iAppVersion != iPrivate->iInfo.iAppVersion) {
             Q_EMIT appVersionChanged();
         }
-        if (cardNumber != iPrivate->iCardNumber) {
+        if (prev.iCardNumber != iPrivate->iInfo.iCardNumber) {
             Q_EMIT cardNumberChanged();
         }
         Q_EMIT dataChanged();
@@ -145,11 +156,11 @@ HslCardAppInfo::setData(
 int
 HslCardAppInfo::appVersion() const
 {
-    return iPrivate->iAppVersion;
+    return iPrivate->iInfo.iAppVersion;
 }
 
 QString
 HslCardAppInfo::cardNumber() const
 {
-    return iPrivate->iCardNumber;
+    return iPrivate->iInfo.iCardNumber;
 }
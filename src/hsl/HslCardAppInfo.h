@@ -51,9 +51,18 @@ class HslCardAppInfo :
     Q_PROPERTY(QString cardNumber READ cardNumber NOTIFY cardNumberChanged)
 
 public:
+    // Decoded application info, for C++ code which doesn't need
+    // a QObject (e.g. running in a worker thread)
+    struct Info {
+        int iAppVersion;
+        QString iCardNumber;
+    };
+
     HslCardAppInfo(QObject* aParent = Q_NULLPTR);
     ~HslCardAppInfo();
 
+    static void decode(const QByteArray&, Info*);
+
     QString data() const;
     void setData(QString);
 
@@ -39,10 +39,14 @@
 
 #include "HslCardEticket.h"
 #include "TravelCard.h"
+#include "TravelCardAllocStats.h"
+#include "TravelCardTrace.h"
 #include "Util.h"
 
 #include <gutil_timenotify.h>
 
+#include <QtCore/QTimer>
+
 #include "HarbourDebug.h"
 
 // ==========================================================================
@@ -63,21 +67,9 @@ public:
 public:
     HslCardEticket* iTicket;
     QString iHexData;
-    HslData::Language iLanguage;
-    HslData::ValidityLengthType iValidityLengthType;
-    int iValidityLength;
-    HslArea iValidityArea;
-    int iTicketPrice;
-    int iGroupSize;
-    bool iExtraZone;
-    int iExtensionFare;
-    QDateTime iValidityStartTime;
-    QDateTime iValidityEndTime;
-    QDateTime iValidityEndTimeGroup;
-    QDateTime iBoardingTime;
-    int iBoardingVehicle;
-    HslArea iBoardingArea;
+    Info iInfo;
     int iSecondsRemaining;
+    QTimer* iUpdateTimer;
     GUtilTimeNotify* iTimeNotify;
     gulong iTimeNotifyId;
 };
@@ -85,19 +77,18 @@ public:
 HslCardEticket::Private::Private(
     HslCardEticket* aTicket) :
     iTicket(aTicket),
-    iLanguage(LanguageUnknown),
-    iValidityLengthType(ValidityLengthUnknown),
-    iValidityLength(0),
-    iTicketPrice(0),
-    iGroupSize(0),
-    iExtraZone(false),
-    iExtensionFare(0),
-    iBoardingVehicle(0),
     iSecondsRemaining(0),
+    iUpdateTimer(new QTimer(aTicket)),
     iTimeNotify(gutil_time_notify_new()),
     iTimeNotifyId(gutil_time_notify_add_handler(iTimeNotify,
         systemTimeChanged, aTicket))
 {
+    decode(QByteArray(), &iInfo);
+
+    // Restarted rather than re-created on every update
+    iUpdateTimer->setSingleShot(true);
+    QObject::connect(iUpdateTimer, SIGNAL(timeout()),
+        aTicket, SLOT(updateSecondsRemaining()));
 }
 
 HslCardEticket::Private::~Private()
@@ -115,23 +106,85 @@ HslCardEticket::Private::setHexData(
 
     HDEBUG(hexData.constData());
     iHexData = aHexData;
-    iLanguage = LanguageUnknown;
-    iValidityLengthType = ValidityLengthUnknown;
-    iValidityLength = 0;
-    iValidityArea = HslArea();
-    iTicketPrice = 0;
-    iGroupSize = 0;
-    iExtraZone = false;
-    iExtensionFare = 0;
-    iValidityStartTime = QDateTime();
-    iValidityEndTime = QDateTime();
-    iValidityEndTimeGroup = QDateTime();
-    iBoardingTime = QDateTime();
-    iBoardingVehicle = 0;
-    iBoardingArea = HslArea();
-
+    decode(bytes, &iInfo);
     if (!bytes.isEmpty()) {
-        const GUtilData data = Util::toData(bytes);
+        updateSecondsRemaining();
+    }
+}
+
+void
+HslCardEticket::Private::systemTimeChanged(
+    GUtilTimeNotify*,
+    void* aTicket)
+{
+    HDEBUG("System time changed");
+    QTimer::singleShot(0, (HslCardEticket*) aTicket, SLOT(updateSecondsRemaining()));
+}
+
+void
+HslCardEticket::Private::updateSecondsRemaining()
+{
+    if (HslData::isValidTimePeriod(iInfo.iValidityStartTime,
+        iInfo.iValidityEndTime)) {
+        const QDateTime now = Util::currentTimeInFinland();
+        if (now < iInfo.iValidityStartTime) {
+            iSecondsRemaining = TravelCard::PeriodNotYetStarted;
+            iUpdateTimer->stop();
+        } else if (now > iInfo.iValidityEndTime) {
+            iSecondsRemaining = TravelCard::PeriodEnded;
+            iUpdateTimer->stop();
+        } else {
+            qint64 msecsRemaining = now.msecsTo(iInfo.iValidityEndTime);
+            iSecondsRemaining = (int)(msecsRemaining/1000) + 1;
+            int nextInterval = (msecsRemaining % 1000);
+            if (!nextInterval) nextInterval = 1000;
+            HDEBUG(nextInterval << "ms until next update");
+            iUpdateTimer->start(nextInterval);
+        }
+    } else {
+        iSecondsRemaining = TravelCard::PeriodInvalid;
+        iUpdateTimer->stop();
+    }
+}
+
+// ==========================================================================
+// HslCardEticket
+// ==========================================================================
+
+HslCardEticket::HslCardEticket(
+    QObject* aParent) :
+    HslData(aParent),
+    iPrivate(new Private(this))
+{
+}
+
+HslCardEticket::~HslCardEticket()
+{
+    delete iPrivate;
+}
+
+void
+HslCardEticket::decode(
+    const QByteArray& aBytes,
+    Info* aInfo)
+{
+    aInfo->iLanguage = LanguageUnknown;
+    aInfo->iValidityLengthType = ValidityLengthUnknown;
+    aInfo->iValidityLength = 0;
+    aInfo->iValidityArea = HslArea();
+    aInfo->iTicketPrice = 0;
+    aInfo->iGroupSize = 0;
+    aInfo->iExtraZone = false;
+    aInfo->iExtensionFare = 0;
+    aInfo->iValidityStartTime = QDateTime();
+    aInfo->iValidityEndTime = QDateTime();
+    aInfo->iValidityEndTimeGroup = QDateTime();
+    aInfo->iBoardingTime = QDateTime();
+    aInfo->iBoardingVehicle = 0;
+    aInfo->iBoardingArea = HslArea();
+
+    if (!aBytes.isEmpty()) {
+        const GUtilData data = Util::toData(aBytes);
 
         HDEBUG("  ProductCodeType =" << getInt(&data, 0, 1));
         HDEBUG("  ProductCode =" << getInt(&data, 0, 14));
@@ -142,134 +195,86 @@ HslCardEticket::Private::setHexData(
         HDEBUG("  LanguageCode =" << languageCode);
         int validityLengthType = getInt(&data, 5, 1, 2);
         HDEBUG("  ValidityLengthType =" << validityLengthType);
-        iValidityLength = getInt(&data, 5, 3, 8);
-        HDEBUG("  ValidityLength =" << iValidityLength);
+        aInfo->iValidityLength = getInt(&data, 5, 3, 8);
+        HDEBUG("  ValidityLength =" << aInfo->iValidityLength);
         HDEBUG("  ValidityLengthTypeGroup =" << getInt(&data, 6, 3, 2));
         HDEBUG("  ValidityLengthGroup =" << getInt(&data, 6, 5, 8));
-        iValidityArea = getArea(&data, 7, 5, 7, 7);
+        aInfo->iValidityArea = getArea(&data, 7, 5, 7, 7);
         HDEBUG("  ValidityAreaType =" << getInt(&data, 7, 5, 2));
-        HDEBUG("  ValidityArea =" << getInt(&data, 7, 7, 6) << iValidityArea);
+        HDEBUG("  ValidityArea =" << getInt(&data, 7, 7, 6) << aInfo->iValidityArea);
         HDEBUG("  SaleDate =" << getInt(&data, 8, 5, DATE_BITS) << getDate(&data, 8, 5));
         HDEBUG("  SaleTime =" << getInt(&data, 10, 3, 5) <<
             START_TIME.addSecs(getInt(&data, 10, 3, 5) * 60));
         HDEBUG("  SaleDeviceType =" << getInt(&data, 11, 0, 3));
         HDEBUG("  SaleDeviceNumber =" << getInt(&data, 11, 3, 14));
-        iTicketPrice = getInt(&data, 13, 1, 14);
-        HDEBUG("  TicketFare =" << iTicketPrice);
+        aInfo->iTicketPrice = getInt(&data, 13, 1, 14);
+        HDEBUG("  TicketFare =" << aInfo->iTicketPrice);
         const int groupFare = getInt(&data, 14, 7, 14);
         HDEBUG("  TicketFareGroup =" << groupFare);
-        iGroupSize = getInt(&data, 16, 5, 6);
-        if (iGroupSize > 1) {
-            iTicketPrice += groupFare;
+        aInfo->iGroupSize = getInt(&data, 16, 5, 6);
+        if (aInfo->iGroupSize > 1) {
+            aInfo->iTicketPrice += groupFare;
         }
-        HDEBUG("  GroupSize =" << iGroupSize);
-        iExtraZone = (getInt(&data, 17, 3, 1) != 0);
-        HDEBUG("  ExtraZone =" << iExtraZone);
+        HDEBUG("  GroupSize =" << aInfo->iGroupSize);
+        aInfo->iExtraZone = (getInt(&data, 17, 3, 1) != 0);
+        HDEBUG("  ExtraZone =" << aInfo->iExtraZone);
         HDEBUG("  PeriodPassValidityArea =" << getInt(&data, 17, 4, 6));
         HDEBUG("  ExtensionProductCode =" << getInt(&data, 18, 2, 14));
         HDEBUG("  Extension1ValidityArea =" << getInt(&data, 20, 0, 6));
-        iExtensionFare = getInt(&data, 20, 6, 14);
-        HDEBUG("  Extension1Fare =" << iExtensionFare);
+        aInfo->iExtensionFare = getInt(&data, 20, 6, 14);
+        HDEBUG("  Extension1Fare =" << aInfo->iExtensionFare);
         HDEBUG("  Extension2ValidityArea =" << getInt(&data, 22, 4, 6));
         HDEBUG("  Extension2Fare =" << getInt(&data, 23, 2, 14));
         HDEBUG("  SaleStatus =" << getInt(&data, 25, 0, 1));
         const QDate validityStartDate(getDate(&data, 25, 5));
         const QTime validityStartTime(getTime(&data, 27, 3));
-        iValidityStartTime = QDateTime(validityStartDate, validityStartTime, Util::FINLAND_TIMEZONE);
+        aInfo->iValidityStartTime = QDateTime(validityStartDate, validityStartTime, Util::FINLAND_TIMEZONE);
         HDEBUG("  ValidityStartDate =" << getInt(&data, 25, 5, DATE_BITS) << validityStartDate);
         HDEBUG("  ValidityStartTime =" << getInt(&data, 27, 3, TIME_BITS) << validityStartTime);
         const QDate validityEndDate(getDate(&data, 28, 6));
         const QTime validityEndTime(getTime(&data, 30, 4));
-        iValidityEndTime = QDateTime(validityEndDate, validityEndTime, Util::FINLAND_TIMEZONE);
+        aInfo->iValidityEndTime = QDateTime(validityEndDate, validityEndTime, Util::FINLAND_TIMEZONE);
         HDEBUG("  ValidityEndDate =" << getInt(&data, 28, 6, DATE_BITS) << validityEndDate);
         HDEBUG("  ValidityEndTime =" << getInt(&data, 30, 4, TIME_BITS) << validityEndTime);
         const QDate validityEndDateGroup(getDate(&data, 31, 7));
         const QTime validityEndTimeGroup(getTime(&data, 33, 5));
-        iValidityEndTimeGroup = QDateTime(validityEndDateGroup, validityEndTimeGroup, Util::FINLAND_TIMEZONE);
+        aInfo->iValidityEndTimeGroup = QDateTime(validityEndDateGroup, validityEndTimeGroup, Util::FINLAND_TIMEZONE);
         HDEBUG("  ValidityEndDateGroup =" << getInt(&data, 31, 7, DATE_BITS) << validityEndDateGroup);
         HDEBUG("  ValidityEndTimeGroup =" << getInt(&data, 33, 5, TIME_BITS) << validityEndTimeGroup);
         HDEBUG("  ValidityStatus =" << getInt(&data, 35, 5, 1));
         const QDate boardingDate(getDate(&data, 35, 6));
         const QTime boardingTime(getTime(&data, 37, 4));
-        iBoardingTime = QDateTime(boardingDate, boardingTime, Util::FINLAND_TIMEZONE);
+        aInfo->iBoardingTime = QDateTime(boardingDate, boardingTime, Util::FINLAND_TIMEZONE);
         HDEBUG("  BoardingDate =" << getInt(&data, 35, 6, DATE_BITS) << boardingDate);
         HDEBUG("  BoardingTime =" << getInt(&data, 37, 4, TIME_BITS) << boardingTime);
-        iBoardingVehicle = getInt(&data, 38, 7, 14);
-        HDEBUG("  BoardingVehicle =" << iBoardingVehicle);
+        aInfo->iBoardingVehicle = getInt(&data, 38, 7, 14);
+        HDEBUG("  BoardingVehicle =" << aInfo->iBoardingVehicle);
         HDEBUG("  BoardingLocationNumberType =" << getInt(&data, 40, 5, 2));
         HDEBUG("  BoardingLocationNumber =" << getInt(&data, 40, 7, 14));
         HDEBUG("  BoardingDirection =" << getInt(&data, 42, 5, 1));
-        iBoardingArea = getArea(&data, 42, 6, 43, 0);
+        aInfo->iBoardingArea = getArea(&data, 42, 6, 43, 0);
         HDEBUG("  BoardingAreaType =" << getInt(&data, 42, 6, 2));
-        HDEBUG("  BoardingArea =" << getInt(&data, 43, 0, 6) << iBoardingArea);
+        HDEBUG("  BoardingArea =" << getInt(&data, 43, 0, 6) << aInfo->iBoardingArea);
 
         // Kielikoodi: 0=Suomi, 1=Ruotsi, 2=Englanti
         switch (languageCode) {
-        case 0: iLanguage = LanguageFinnish; break;
-        case 1: iLanguage = LanguageSwedish; break;
-        case 2: iLanguage = LanguageEnglish; break;
+        case 0: aInfo->iLanguage = LanguageFinnish; break;
+        case 1: aInfo->iLanguage = LanguageSwedish; break;
+        case 2: aInfo->iLanguage = LanguageEnglish; break;
         }
 
         // Voimassaolon pituuden tyyppi:
         // 0=Minuutteja, 1=Tunteja,
         // 2=Vuorokausia, 3=Päiviä
         switch (validityLengthType) {
-        case 0: iValidityLengthType = ValidityLengthMinute; break;
-        case 1: iValidityLengthType = ValidityLengthHour; break;
-        case 2: iValidityLengthType = ValidityLength24Hours; break;
-        case 3: iValidityLengthType = ValidityLengthDay; break;
+        case 0: aInfo->iValidityLengthType = ValidityLengthMinute; break;
+        case 1: aInfo->iValidityLengthType = ValidityLengthHour; break;
+        case 2: aInfo->iValidityLengthType = ValidityLength24Hours; break;
+        case 3: aInfo->iValidityLengthType = ValidityLengthDay; break;
         }
-        updateSecondsRemaining();
     }
 }
 
-void
-HslCardEticket::Private::systemTimeChanged(
-    GUtilTimeNotify*,
-    void* aTicket)
-{
-    HDEBUG("System time changed");
-    QTimer::singleShot(0, (HslCardEticket*) aTicket, SLOT(updateSecondsRemaining()));
-}
-
-void
-HslCardEticket::Private::updateSecondsRemaining()
-{
-    if (HslData::isValidTimePeriod(iValidityStartTime, iValidityEndTime)) {
-        const QDateTime now = Util::currentTimeInFinland();
-        if (now < iValidityStartTime) {
-            iSecondsRemaining = TravelCard::PeriodNotYetStarted;
-        } else if (now > iValidityEndTime) {
-            iSecondsRemaining = TravelCard::PeriodEnded;
-        } else {
-            qint64 msecsRemaining = now.msecsTo(iValidityEndTime);
-            iSecondsRemaining = (int)(msecsRemaining/1000) + 1;
-            int nextInterval = (msecsRemaining % 1000);
-            if (!nextInterval) nextInterval = 1000;
-            HDEBUG(nextInterval << "ms until next update");
-            QTimer::singleShot(nextInterval, iTicket, SLOT(updateSecondsRemaining()));
-        }
-    } else {
-        iSecondsRemaining = TravelCard::PeriodInvalid;
-    }
-}
-
-// ==========================================================================
-// HslCardEticket
-// ==========================================================================
-
-HslCardEticket::HslCardEticket(
-    QObject* aParent) :
-    HslData(aParent),
-    iPrivate(new Private(this))
-{
-}
-
-HslCardEticket::~HslCardEticket()
-{
-    delete iPrivate;
-}
-
 QString
 HslCardEticket::data() const
 {
@@ -280,65 +285,55 @@ void
 HslCardEticket::setData(
     QString aData)
 {
+    TRACE_SCOPE("HslCardEticket::setData");
+    ALLOC_STATS_SCOPE(Parse);
+
     const QString data(aData.toLower());
 
     if (iPrivate->iHexData != data) {
-        const Language prevLanguage = iPrivate->iLanguage;
-        const ValidityLengthType prevValidityLengthType = iPrivate->iValidityLengthType;
-        const int prevValidityLength = iPrivate->iValidityLength;
-        const HslArea prevValidityArea = iPrivate->iValidityArea;
-        const int prevTicketPrice = iPrivate->iTicketPrice;
-        const int prevGroupSize = iPrivate->iGroupSize;
-        const bool prevExtraZone = iPrivate->iExtraZone;
-        const int prevExtensionFare = iPrivate->iExtensionFare;
-        const QDateTime prevValidityStartTime(iPrivate->iValidityStartTime);
-        const QDateTime prevValidityEndTime(iPrivate->iValidityEndTime);
-        const QDateTime prevValidityEndTimeGroup(iPrivate->iValidityEndTimeGroup);
-        const QDateTime prevBoardingTime(iPrivate->iBoardingTime);
-        const int prevBoardingVehicle = iPrivate->iBoardingVehicle;
-        const HslArea prevBoardingArea = iPrivate->iBoardingArea;
+        const Info prev(iPrivate->iInfo);
         const int prevSecondsRemaining = iPrivate->iSecondsRemaining;
         iPrivate->setHexData(data);
-        if (prevLanguage != iPrivate->iLanguage) {
+        if (prev.iLanguage != iPrivate->iInfo.iLanguage) {
             Q_EMIT languageChanged();
         }
-        if (prevValidityLengthType != iPrivate->iValidityLengthType) {
+        if (prev.iValidityLengthType != iPrivate->iInfo.iValidityLengthType) {
             Q_EMIT validityLengthTypeChanged();
         }
-        if (prevValidityLength != iPrivate->iValidityLength) {
+        if (prev.iValidityLength != iPrivate->iInfo.iValidityLength) {
             Q_EMIT validityLengthChanged();
         }
-        if (prevValidityArea != iPrivate->iValidityArea) {
+        if (prev.iValidityArea != iPrivate->iInfo.iValidityArea) {
             Q_EMIT validityAreaChanged();
         }
-        if (prevTicketPrice != iPrivate->iTicketPrice) {
+        if (prev.iTicketPrice != iPrivate->iInfo.iTicketPrice) {
             Q_EMIT ticketPriceChanged();
         }
-        if (prevGroupSize != iPrivate->iGroupSize) {
+        if (prev.iGroupSize != iPrivate->iInfo.iGroupSize) {
             Q_EMIT groupSizeChanged();
         }
-        if (prevExtraZone != iPrivate->iExtraZone) {
+        if (prev.iExtraZone != iPrivate->iInfo.iExtraZone) {
             Q_EMIT extraZoneChanged();
         }
-        if (prevExtensionFare != iPrivate->iExtensionFare) {
+        if (prev.iExtensionFare != iPrivate->iInfo.iExtensionFare) {
             Q_EMIT extensionFareChanged();
         }
-        if (prevValidityStartTime != iPrivate->iValidityStartTime) {
+        if (prev.iValidityStartTime != iPrivate->iInfo.iValidityStartTime) {
             Q_EMIT validityStartTimeChanged();
         }
-        if (prevValidityEndTime != iPrivate->iValidityEndTime) {
+        if (prev.iValidityEndTime != iPrivate->iInfo.iValidityEndTime) {
             Q_EMIT validityEndTimeChanged();
         }
-        if (prevValidityEndTimeGroup != iPrivate->iValidityEndTimeGroup) {
+        if (prev.iValidityEndTimeGroup != iPrivate->iInfo.iValidityEndTimeGroup) {
             Q_EMIT validityEndTimeGroupChanged();
         }
-        if (prevBoardingTime != iPrivate->iBoardingTime) {
+        if (prev.iBoardingTime != iPrivate->iInfo.iBoardingTime) {
             Q_EMIT boardingTimeChanged();
         }
-        if (prevBoardingVehicle != iPrivate->iBoardingVehicle) {
+        if (prev.iBoardingVehicle != iPrivate->iInfo.iBoardingVehicle) {
             Q_EMIT boardingVehicleChanged();
         }
-        if (prevBoardingArea != iPrivate->iBoardingArea) {
+        if (prev.iBoardingArea != iPrivate->iInfo.iBoardingArea) {
             Q_EMIT boardingAreaChanged();
         }
         if (prevSecondsRemaining != iPrivate->iSecondsRemaining) {
@@ -351,97 +346,97 @@ HslCardEticket::setData(
 HslData::Language
 HslCardEticket::language() const
 {
-    return iPrivate->iLanguage;
+    return iPrivate->iInfo.iLanguage;
 }
 
 HslData::ValidityLengthType
 HslCardEticket::validityLengthType() const
 {
-    return iPrivate->iValidityLengthType;
+    return iPrivate->iInfo.iValidityLengthType;
 }
 
 int
 HslCardEticket::validityLength() const
 {
-    return iPrivate->iValidityLength;
+    return iPrivate->iInfo.iValidityLength;
 }
 
 HslArea
 HslCardEticket::validityArea() const
 {
-    return iPrivate->iValidityArea;
+    return iPrivate->iInfo.iValidityArea;
 }
 
 QString
 HslCardEticket::validityAreaName() const
 {
-    return iPrivate->iValidityArea.name();
+    return iPrivate->iInfo.iValidityArea.name();
 }
 
 int
 HslCardEticket::ticketPrice() const
 {
-    return iPrivate->iTicketPrice;
+    return iPrivate->iInfo.iTicketPrice;
 }
 
 int
 HslCardEticket::groupSize() const
 {
-    return iPrivate->iGroupSize;
+    return iPrivate->iInfo.iGroupSize;
 }
 
 bool
 HslCardEticket::extraZone() const
 {
-    return iPrivate->iExtraZone;
+    return iPrivate->iInfo.iExtraZone;
 }
 
 int
 HslCardEticket::extensionFare() const
 {
-    return iPrivate->iExtensionFare;
+    return iPrivate->iInfo.iExtensionFare;
 }
 
 QDateTime
 HslCardEticket::validityStartTime() const
 {
-    return iPrivate->iValidityStartTime;
+    return iPrivate->iInfo.iValidityStartTime;
 }
 
 QDateTime
 HslCardEticket::validityEndTime() const
 {
-    return iPrivate->iValidityEndTime;
+    return iPrivate->iInfo.iValidityEndTime;
 }
 
 QDateTime
 HslCardEticket::validityEndTimeGroup() const
 {
-    return iPrivate->iValidityEndTimeGroup;
+    return iPrivate->iInfo.iValidityEndTimeGroup;
 }
 
 QDateTime
 HslCardEticket::boardingTime() const
 {
-    return iPrivate->iBoardingTime;
+    return iPrivate->iInfo.iBoardingTime;
 }
 
 int
 HslCardEticket::boardingVehicle() const
 {
-    return iPrivate->iBoardingVehicle;
+    return iPrivate->iInfo.iBoardingVehicle;
 }
 
 HslArea
 HslCardEticket::boardingArea() const
 {
-    return iPrivate->iBoardingArea;
+    return iPrivate->iInfo.iBoardingArea;
 }
 
 QString
 HslCardEticket::boardingAreaName() const
 {
-    return iPrivate->iBoardingArea.name();
+    return iPrivate->iInfo.iBoardingArea.name();
 }
 
 int
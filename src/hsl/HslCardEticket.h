@@ -66,9 +66,31 @@ class HslCardEticket :
     Q_PROPERTY(int secondsRemaining READ secondsRemaining NOTIFY secondsRemainingChanged)
 
 public:
+    // Decoded ticket, for C++ code which doesn't need a QObject
+    // (e.g. running in a worker thread). The number of seconds
+    // remaining depends on the current time, it's not included.
+    struct Info {
+        Language iLanguage;
+        ValidityLengthType iValidityLengthType;
+        int iValidityLength;
+        HslArea iValidityArea;
+        int iTicketPrice;       // Cents, the whole group
+        int iGroupSize;
+        bool iExtraZone;
+        int iExtensionFare;     // Cents
+        QDateTime iValidityStartTime;
+        QDateTime iValidityEndTime;
+        QDateTime iValidityEndTimeGroup;
+        QDateTime iBoardingTime;
+        int iBoardingVehicle;
+        HslArea iBoardingArea;
+    };
+
     HslCardEticket(QObject* aParent = Q_NULLPTR);
     ~HslCardEticket();
 
+    static void decode(const QByteArray&, Info*);
+
     QString data() const;
     void setData(QString);
 
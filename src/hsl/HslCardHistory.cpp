@@ -37,10 +37,18 @@
  * any official policies, either expressed or implied.
  */
 
+#include "HslCard.h"
 #include "HslCardHistory.h"
 #include "HslData.h"
+#include "TravelCardAllocStats.h"
+#include "TravelCardArchive.h"
+#include "TravelCardTrace.h"
 #include "Util.h"
 
+#include <gutil_timenotify.h>
+
+#include <QtCore/QTimer>
+
 #include "HarbourDebug.h"
 
 // Model roles
@@ -49,7 +57,11 @@
     role(BoardingTime,boardingTime) \
     role(TicketPrice,ticketPrice) \
     role(GroupSize,groupSize) \
-    last(RemainingValue,remainingValue)
+    role(RemainingValue,remainingValue) \
+    role(BoardingTimeString,boardingTimeString) \
+    role(TicketPriceString,ticketPriceString) \
+    role(TotalPriceString,totalPriceString) \
+    last(RemainingValueString,remainingValueString)
 
 #define MODEL_ROLES(role) \
     MODEL_ROLES_(role,role,role)
@@ -72,26 +84,40 @@ public:
         #undef LAST
     };
 
-    ModelData(TransactionType, QDateTime, int, int, int);
+    ModelData(TransactionType, uint, uint, int, int, int);
 
     QVariant get(Role) const;
+    void formatStrings();
+    void formatTimeString();
 
 public:
     TransactionType iTransactionType;
+    uint iBoardingDay;
+    uint iBoardingMinute;
     QDateTime iBoardingTime;
     int iTicketPrice;
     int iGroupSize;
     int iRemainingValue;
+    // Pre-formatted strings, so that delegates don't have to do it
+    QString iBoardingTimeString;
+    QString iTicketPriceString;
+    QString iTotalPriceString;
+    QString iRemainingValueString;
 };
 
 HslCardHistory::ModelData::ModelData(
     TransactionType aType,
-    QDateTime aBoardingTime,
+    uint aBoardingDay,
+    uint aBoardingMinute,
     int aTicketPrice,
     int aGroupSize,
     int aRemainingValue) :
     iTransactionType(aType),
-    iBoardingTime(aBoardingTime),
+    iBoardingDay(aBoardingDay),
+    iBoardingMinute(aBoardingMinute),
+    iBoardingTime(HslData::START_DATE.addDays(aBoardingDay),
+        HslData::START_TIME.addSecs(aBoardingMinute * 60),
+        Util::FINLAND_TIMEZONE),
     iTicketPrice(aTicketPrice),
     iGroupSize(aGroupSize),
     iRemainingValue(aRemainingValue)
@@ -108,10 +134,29 @@ HslCardHistory::ModelData::get(
     case TicketPriceRole: return iTicketPrice;
     case GroupSizeRole: return iGroupSize;
     case RemainingValueRole: return iRemainingValue;
+    case BoardingTimeStringRole: return iBoardingTimeString;
+    case TicketPriceStringRole: return iTicketPriceString;
+    case TotalPriceStringRole: return iTotalPriceString;
+    case RemainingValueStringRole: return iRemainingValueString;
     }
     return QVariant();
 }
 
+void
+HslCardHistory::ModelData::formatStrings()
+{
+    formatTimeString();
+    iTicketPriceString = Util::moneyString(iTicketPrice);
+    iTotalPriceString = Util::moneyString(iTicketPrice * iGroupSize);
+    iRemainingValueString = Util::moneyString(iRemainingValue);
+}
+
+void
+HslCardHistory::ModelData::formatTimeString()
+{
+    iBoardingTimeString = Util::dateTimeString(iBoardingTime);
+}
+
 // ==========================================================================
 // HslCardHistory::Private
 // ==========================================================================
@@ -119,83 +164,116 @@ HslCardHistory::ModelData::get(
 class HslCardHistory::Private
 {
 public:
-    enum { ENTRY_SIZE = 12 };
+    enum {
+        ENTRY_SIZE = 12,
+        PAGE_SIZE = 50
+    };
 
-    Private();
+    Private(HslCardHistory*);
     ~Private();
 
+    static void decodeEntry(const uchar*, Entry*);
+    static void fixTicketPrice(Entry*, const Entry*);
+    static ModelData* newModelData(const Entry&);
+    static void systemTimeChanged(GUtilTimeNotify*, void*);
+
     void setHexData(QString);
+    void clearRecords();
+    int recordCount() const;
+    const uchar* recordAt(int) const;
+    bool getRecordEntry(int, Entry*) const;
+    void fetch(int);
     ModelData* dataAt(int) const;
 
 public:
     QString iHexData;
+    QString iCardNumber;
+    bool iIncludeArchive;
     ModelData::List iData;
+    // Entries are fetched on demand, most recent first, either straight
+    // from the mapped archive file or (if there's no archive) from the
+    // records found on the card. Only one of these is used at a time.
+    TravelCardArchive* iArchive;
+    QByteArray iCardRecords;
+    GUtilTimeNotify* iTimeNotify;
+    gulong iTimeNotifyId;
 };
 
-HslCardHistory::Private::Private()
+HslCardHistory::Private::Private(
+    HslCardHistory* aModel) :
+    iIncludeArchive(false),
+    iArchive(Q_NULLPTR),
+    iTimeNotify(gutil_time_notify_new()),
+    iTimeNotifyId(gutil_time_notify_add_handler(iTimeNotify,
+        systemTimeChanged, aModel))
 {}
 
 HslCardHistory::Private::~Private()
 {
+    gutil_time_notify_remove_handler(iTimeNotify, iTimeNotifyId);
+    gutil_time_notify_unref(iTimeNotify);
     qDeleteAll(iData);
+    delete iArchive;
 }
 
 void
-HslCardHistory::Private::setHexData(
-    QString aHexData)
+HslCardHistory::Private::systemTimeChanged(
+    GUtilTimeNotify*,
+    void* aModel)
 {
-    QByteArray hexData(aHexData.toLatin1());
-    const QByteArray bytes(QByteArray::fromHex(hexData));
+    HDEBUG("System time changed");
+    QTimer::singleShot(0, (HslCardHistory*) aModel, SLOT(updateTimeStrings()));
+}
 
-    HDEBUG(hexData.constData());
-    iHexData = aHexData;
-    qDeleteAll(iData);
-    iData.clear();
-    if (!bytes.isEmpty()) {
-        const GUtilData data = Util::toData(bytes);
-
-        // History block layout (12 bytes each):
-        //
-        // +=========================================================+
-        // | Byte/Bit | Bit   | Entry | Description                  |
-        // | offset   | count | type  |                              |
-        // +==========+=======+=======+==============================+
-        // | 0/0      | 1     | uint  | Type (0 = check, 1 = charge) |
-        // | 0/1      | 14    | date  | Boarding date                |
-        // | 1/7      | 11    | time  | Boarding time                |
-        // | 3/2      | 14    | date  | Transfer end date            |
-        // | 5/0      | 11    | time  | Transfer end time            |
-        // | 6/3      | 14    | uint  | Ticket fare (cents)          |
-        // | 8/1      | 6     | uint  | Group size                   |
-        // | 8/7      | 20    | uint  | Remaining value (cents)      |
-        // | 11/3     | 5     | -     | Reserved                     |
-        // +=========================================================+
-        HASSERT(!(data.size % ENTRY_SIZE));
-        const int n = data.size / ENTRY_SIZE;
-        HDEBUG(n << "history entries:");
-        for (int i = n - 1; i >= 0; i--) {
-            const int off = i * ENTRY_SIZE;
-            HDEBUG("Entry #" << (i + 1));
-            const int type = HslData::getInt(&data, off, 0, 1);
-            HDEBUG("  TransactionType =" << type);
-            const QDate boardingDate(HslData::getDate(&data, off, 1));
-            HDEBUG("  BoardingDate =" << HslData::getInt(&data, off, 1, HslData::DATE_BITS) << boardingDate);
-            const QTime boardingTime(HslData::getTime(&data, off + 1, 7));
-            HDEBUG("  BoardingTime =" << HslData::getInt(&data, off + 1, 7, HslData::TIME_BITS) << boardingTime);
-            const int ticketPrice = HslData::getInt(&data, off + 6, 3, 14);
-            HDEBUG("  TicketFare =" << ticketPrice);
-            const int groupSize = HslData::getInt(&data, off + 8, 1, 6);
-            HDEBUG("  GroupSize =" << groupSize);
-            const int remainingValue = HslData::getInt(&data, off + 8, 7, 20);
-            HDEBUG("  RemainingValue =" << remainingValue);
-            // 0=Kauden leimaus, 1=Arvon veloitus
-            iData.append(new ModelData((type == 0) ? TransactionBoarding :
-                (type == 1) ? TransactionPurchase : TransactionUnknown,
-                QDateTime(boardingDate, boardingTime, Util::FINLAND_TIMEZONE),
-                ticketPrice, groupSize, remainingValue));
-        }
-    }
+void
+HslCardHistory::Private::decodeEntry(
+    const uchar* aRecord,
+    Entry* aEntry)
+{
+    GUtilData data;
+
+    data.bytes = aRecord;
+    data.size = ENTRY_SIZE;
+
+    // History entry layout (12 bytes each):
+    //
+    // +=========================================================+
+    // | Byte/Bit | Bit   | Entry | Description                  |
+    // | offset   | count | type  |                              |
+    // +==========+=======+=======+==============================+
+    // | 0/0      | 1     | uint  | Type (0 = check, 1 = charge) |
+    // | 0/1      | 14    | date  | Boarding date                |
+    // | 1/7      | 11    | time  | Boarding time                |
+    // | 3/2      | 14    | date  | Transfer end date            |
+    // | 5/0      | 11    | time  | Transfer end time            |
+    // | 6/3      | 14    | uint  | Ticket fare (cents)          |
+    // | 8/1      | 6     | uint  | Group size                   |
+    // | 8/7      | 20    | uint  | Remaining value (cents)      |
+    // | 11/3     | 5     | -     | Reserved                     |
+    // +=========================================================+
+    const int type = HslData::getInt(&data, 0, 0, 1);
+
+    // 0=Kauden leimaus, 1=Arvon veloitus
+    aEntry->iType = (type == 0) ? TransactionBoarding :
+        (type == 1) ? TransactionPurchase : TransactionUnknown;
+    aEntry->iDay = HslData::getInt(&data, 0, 1, HslData::DATE_BITS);
+    aEntry->iMinute = HslData::getInt(&data, 1, 7, HslData::TIME_BITS);
+    aEntry->iTicketPrice = HslData::getInt(&data, 6, 3, 14);
+    aEntry->iGroupSize = HslData::getInt(&data, 8, 1, 6);
+    aEntry->iRemainingValue = HslData::getInt(&data, 8, 7, 20);
+    HDEBUG("  TransactionType =" << type);
+    HDEBUG("  BoardingDate =" << aEntry->iDay << HslData::START_DATE.addDays(aEntry->iDay));
+    HDEBUG("  BoardingTime =" << aEntry->iMinute << HslData::START_TIME.addSecs(aEntry->iMinute * 60));
+    HDEBUG("  TicketFare =" << aEntry->iTicketPrice);
+    HDEBUG("  GroupSize =" << aEntry->iGroupSize);
+    HDEBUG("  RemainingValue =" << aEntry->iRemainingValue);
+}
 
+void
+HslCardHistory::Private::fixTicketPrice(
+    Entry* aEntry,
+    const Entry* aPrevEntry)
+{
     // New card readers have been introduced by HSL in 2024 which write
     // history entries for multi-tickets slightly differently.
     //
@@ -212,49 +290,157 @@ HslCardHistory::Private::setHexData(
     // applied to those questionable history entries (and still, there's
     // no guarantee that we get it right in every single case)
 
-    const int n = iData.size();
-    for (int i = 0; i < n; i++) {
-        ModelData* entry = iData.at(i);
-
-        // If TicketFare is actually the total price of the group trip,
-        // it must be divisible by the GroupSize
-        if (entry->iGroupSize > 1 && !(entry->iTicketPrice % entry->iGroupSize)) {
-            const QDate entryDate(entry->iBoardingTime.date());
-            static const QDate READER2_START_DATE(2024, 6, 1);
-            static const QDate READER1_END_DATE(2025, 1, 1);
-
-            if (entryDate > READER2_START_DATE) {
-                // Could be (and most likely is) a new card reader
-                bool reader2 = true;
-
-                if (entryDate < READER1_END_DATE) {
-                    // Could be either one
-                    if (i > 0) {
-                        // Check the previous entry if there is one
-                        const ModelData* prev = iData.at(i - 1);
-
-                        // Note that the balance could change (more money
-                        // added to the card) in between, in which case
-                        // this check would fail :(
-                        if (prev->iRemainingValue == entry->iRemainingValue +
-                            entry->iTicketPrice * entry->iGroupSize) {
-                            reader2 = false;
-                        }
-                    }
+    // If TicketFare is actually the total price of the group trip,
+    // it must be divisible by the GroupSize
+    if (aEntry->iGroupSize > 1 && !(aEntry->iTicketPrice % aEntry->iGroupSize)) {
+        const QDate entryDate(HslData::START_DATE.addDays(aEntry->iDay));
+        static const QDate READER2_START_DATE(2024, 6, 1);
+        static const QDate READER1_END_DATE(2025, 1, 1);
+
+        if (entryDate > READER2_START_DATE) {
+            // Could be (and most likely is) a new card reader
+            bool reader2 = true;
+
+            if (entryDate < READER1_END_DATE) {
+                // Could be either one. Check the previous entry if
+                // there is one. Note that the balance could change
+                // (more money added to the card) in between, in which
+                // case this check would fail :(
+                if (aPrevEntry && aPrevEntry->iRemainingValue ==
+                    aEntry->iRemainingValue + aEntry->iTicketPrice *
+                    aEntry->iGroupSize) {
+                    reader2 = false;
                 }
+            }
 
-                if (reader2) {
-                    HDEBUG("Fixing TicketFare for entry #" << (i + 1) <<
-                        entry->iTicketPrice << "=>" << (entry->iTicketPrice /
-                        entry->iGroupSize));
-                    // Fix the ticket price
-                    entry->iTicketPrice /= entry->iGroupSize;
-                }
+            if (reader2) {
+                HDEBUG("Fixing TicketFare" << aEntry->iTicketPrice << "=>" <<
+                    (aEntry->iTicketPrice / aEntry->iGroupSize));
+                // Fix the ticket price
+                aEntry->iTicketPrice /= aEntry->iGroupSize;
             }
         }
     }
 }
 
+HslCardHistory::ModelData*
+HslCardHistory::Private::newModelData(
+    const Entry& aEntry)
+{
+    ModelData* data = new ModelData(aEntry.iType, aEntry.iDay, aEntry.iMinute,
+        aEntry.iTicketPrice, aEntry.iGroupSize, aEntry.iRemainingValue);
+
+    data->formatStrings();
+    return data;
+}
+
+void
+HslCardHistory::Private::setHexData(
+    QString aHexData)
+{
+    QByteArray hexData(aHexData.toLatin1());
+    const QByteArray bytes(QByteArray::fromHex(hexData));
+
+    HDEBUG(hexData.constData());
+    iHexData = aHexData;
+    qDeleteAll(iData);
+    iData.clear();
+    clearRecords();
+
+    if (iIncludeArchive && !iCardNumber.isEmpty()) {
+        TravelCardArchive* archive = new TravelCardArchive(HslCard::Desc.iName,
+            iCardNumber, ENTRY_SIZE, HslCardHistory::entryTime);
+
+        // The card driver archives everything that's on the card before
+        // the data gets here. The model never writes to the archive, it
+        // only reads the entries straight from the mapped archive file.
+        // If the archive doesn't have them (e.g. the data didn't come
+        // from the card driver), the card records are shown as is.
+        if (archive->containsAll(bytes)) {
+            iArchive = archive;
+        } else {
+            delete archive;
+        }
+    }
+
+    if (!iArchive) {
+        HASSERT(!(bytes.size() % ENTRY_SIZE));
+        iCardRecords = TravelCardArchive::newestFirst(bytes, ENTRY_SIZE,
+            HslCardHistory::entryTime);
+    }
+
+    HDEBUG(recordCount() << "history entries");
+    fetch(PAGE_SIZE);
+}
+
+void
+HslCardHistory::Private::clearRecords()
+{
+    delete iArchive;
+    iArchive = Q_NULLPTR;
+    iCardRecords.clear();
+}
+
+int
+HslCardHistory::Private::recordCount() const
+{
+    return iArchive ? iArchive->count() : (iCardRecords.size() / ENTRY_SIZE);
+}
+
+const uchar*
+HslCardHistory::Private::recordAt(
+    int aRow) const
+{
+    if (iArchive) {
+        // Archive file is sorted the other way around
+        return iArchive->recordData(iArchive->count() - aRow - 1);
+    } else if (aRow >= 0 && aRow < recordCount()) {
+        return (const uchar*)iCardRecords.constData() + aRow * ENTRY_SIZE;
+    } else {
+        return Q_NULLPTR;
+    }
+}
+
+bool
+HslCardHistory::Private::getRecordEntry(
+    int aRow,
+    Entry* aEntry) const
+{
+    const uchar* record = recordAt(aRow);
+
+    if (record) {
+        // The previous entry (the one before this one in time)
+        // is the next row
+        const uchar* prevRecord = recordAt(aRow + 1);
+
+        HDEBUG("Entry #" << (aRow + 1));
+        decodeEntry(record, aEntry);
+        if (prevRecord) {
+            Entry prev;
+
+            decodeEntry(prevRecord, &prev);
+            fixTicketPrice(aEntry, &prev);
+        } else {
+            fixTicketPrice(aEntry, Q_NULLPTR);
+        }
+        return true;
+    }
+    return false;
+}
+
+void
+HslCardHistory::Private::fetch(
+    int aCount)
+{
+    const int end = qMin(iData.count() + aCount, recordCount());
+    Entry entry;
+
+    for (int i = iData.count(); i < end; i++) {
+        getRecordEntry(i, &entry);
+        iData.append(newModelData(entry));
+    }
+}
+
 inline
 HslCardHistory::ModelData*
 HslCardHistory::Private::dataAt(
@@ -274,7 +460,7 @@ HslCardHistory::Private::dataAt(
 HslCardHistory::HslCardHistory(
     QObject* aParent) :
     QAbstractListModel(aParent),
-    iPrivate(new Private)
+    iPrivate(new Private(this))
 {}
 
 HslCardHistory::~HslCardHistory()
@@ -292,42 +478,179 @@ void
 HslCardHistory::setData(
     QString aData)
 {
+    TRACE_SCOPE("HslCardHistory::setData");
+    ALLOC_STATS_SCOPE(Parse);
+
     const QString data(aData.toLower());
 
     if (iPrivate->iHexData != data) {
-        const ModelData::List prevData(iPrivate->iData);
-        const int prevCount = prevData.count();
-
-        iPrivate->iData.clear();
-        iPrivate->setHexData(data);
-
-        // All this just to avoid resetting the entire model
-        // which resets view position too.
-        const ModelData::List newData(iPrivate->iData);
-        const int count = iPrivate->iData.count();
-
-        iPrivate->iData = prevData;
-        if (count < prevCount) {
-            beginRemoveRows(QModelIndex(), count, prevCount - 1);
-            iPrivate->iData = newData;
-            endRemoveRows();
-            if (count > 0) {
-                Q_EMIT dataChanged(index(0), index(count - 1));
-            }
-        } else if (count > prevCount) {
-            beginInsertRows(QModelIndex(), prevCount, count - 1);
-            iPrivate->iData = newData;
-            endInsertRows();
-            if (prevCount > 0) {
-                Q_EMIT dataChanged(index(0), index(prevCount - 1));
-            }
-        } else if (count > 0) {
-            iPrivate->iData = newData;
+        iPrivate->iHexData = data;
+        updateModel();
+        Q_EMIT historyChanged();
+    }
+}
+
+QString
+HslCardHistory::cardNumber() const
+{
+    return iPrivate->iCardNumber;
+}
+
+void
+HslCardHistory::setCardNumber(
+    QString aCardNumber)
+{
+    if (iPrivate->iCardNumber != aCardNumber) {
+        iPrivate->iCardNumber = aCardNumber;
+        HDEBUG(aCardNumber);
+        if (iPrivate->iIncludeArchive) {
+            updateModel();
+            Q_EMIT historyChanged();
+        }
+        Q_EMIT cardNumberChanged();
+    }
+}
+
+bool
+HslCardHistory::includeArchive() const
+{
+    return iPrivate->iIncludeArchive;
+}
+
+void
+HslCardHistory::setIncludeArchive(
+    bool aIncludeArchive)
+{
+    if (iPrivate->iIncludeArchive != aIncludeArchive) {
+        iPrivate->iIncludeArchive = aIncludeArchive;
+        HDEBUG(aIncludeArchive);
+        if (!iPrivate->iCardNumber.isEmpty()) {
+            updateModel();
+            Q_EMIT historyChanged();
+        }
+        Q_EMIT includeArchiveChanged();
+    }
+}
+
+void
+HslCardHistory::updateModel()
+{
+    const ModelData::List prevData(iPrivate->iData);
+    const int prevCount = prevData.count();
+
+    iPrivate->iData.clear();
+    iPrivate->setHexData(iPrivate->iHexData);
+
+    // Keep the rows which have already been fetched
+    iPrivate->fetch(prevCount - iPrivate->iData.count());
+
+    // All this just to avoid resetting the entire model
+    // which resets view position too.
+    const ModelData::List newData(iPrivate->iData);
+    const int count = iPrivate->iData.count();
+
+    iPrivate->iData = prevData;
+    if (count < prevCount) {
+        beginRemoveRows(QModelIndex(), count, prevCount - 1);
+        iPrivate->iData = newData;
+        endRemoveRows();
+        if (count > 0) {
             Q_EMIT dataChanged(index(0), index(count - 1));
         }
-        qDeleteAll(prevData);
-        Q_EMIT historyChanged();
+    } else if (count > prevCount) {
+        beginInsertRows(QModelIndex(), prevCount, count - 1);
+        iPrivate->iData = newData;
+        endInsertRows();
+        if (prevCount > 0) {
+            Q_EMIT dataChanged(index(0), index(prevCount - 1));
+        }
+    } else if (count > 0) {
+        iPrivate->iData = newData;
+        Q_EMIT dataChanged(index(0), index(count - 1));
+    }
+    qDeleteAll(prevData);
+}
+
+int
+HslCardHistory::count() const
+{
+    return iPrivate->recordCount();
+}
+
+bool
+HslCardHistory::getEntry(
+    int aIndex,
+    Entry* aEntry) const
+{
+    const ModelData* data = iPrivate->dataAt(aIndex);
+
+    if (data) {
+        aEntry->iType = data->iTransactionType;
+        aEntry->iDay = data->iBoardingDay;
+        aEntry->iMinute = data->iBoardingMinute;
+        aEntry->iTicketPrice = data->iTicketPrice;
+        aEntry->iGroupSize = data->iGroupSize;
+        aEntry->iRemainingValue = data->iRemainingValue;
+        return true;
     }
+    return iPrivate->getRecordEntry(aIndex, aEntry);
+}
+
+QList<HslCardHistory::Entry>
+HslCardHistory::decode(
+    const QByteArray& aBytes)
+{
+    const int size = Private::ENTRY_SIZE;
+    const QByteArray records(TravelCardArchive::newestFirst(aBytes, size,
+        entryTime));
+    const int n = records.size() / size;
+    const uchar* ptr = (const uchar*)records.constData();
+    QList<Entry> entries;
+
+    // The previous entry (the one before this one in time) is the next one
+    for (int i = 0; i < n; i++) {
+        Entry entry;
+
+        HDEBUG("Entry #" << (i + 1));
+        Private::decodeEntry(ptr + i * size, &entry);
+        if (i + 1 < n) {
+            Entry prev;
+
+            Private::decodeEntry(ptr + (i + 1) * size, &prev);
+            Private::fixTicketPrice(&entry, &prev);
+        } else {
+            Private::fixTicketPrice(&entry, Q_NULLPTR);
+        }
+        entries.append(entry);
+    }
+    return entries;
+}
+
+QVariantMap
+HslCardHistory::roleValues(
+    const Entry& aEntry)
+{
+    ModelData data(aEntry.iType, aEntry.iDay, aEntry.iMinute,
+        aEntry.iTicketPrice, aEntry.iGroupSize, aEntry.iRemainingValue);
+    QVariantMap map;
+
+    data.formatStrings();
+    #define ROLE(X,x) map.insert(QStringLiteral(#x), data.get(ModelData::X##Role));
+    MODEL_ROLES(ROLE)
+    #undef ROLE
+    return map;
+}
+
+quint64
+HslCardHistory::entryTime(
+    const uchar* aRecord)
+{
+    GUtilData data;
+
+    data.bytes = aRecord;
+    data.size = Private::ENTRY_SIZE;
+    return (quint64)HslData::getInt(&data, 0, 1, HslData::DATE_BITS) * 24 * 60 +
+        HslData::getInt(&data, 1, 7, HslData::TIME_BITS);
 }
 
 QHash<int,QByteArray>
@@ -355,3 +678,40 @@ HslCardHistory::data(
     ModelData* data = iPrivate->dataAt(aIndex.row());
     return data ? data->get((ModelData::Role)aRole) : QVariant();
 }
+
+bool
+HslCardHistory::canFetchMore(
+    const QModelIndex&) const
+{
+    return iPrivate->iData.count() < iPrivate->recordCount();
+}
+
+void
+HslCardHistory::fetchMore(
+    const QModelIndex&)
+{
+    if (canFetchMore(QModelIndex())) {
+        const int first = iPrivate->iData.count();
+        const int last = qMin(first + (int)Private::PAGE_SIZE,
+            iPrivate->recordCount()) - 1;
+
+        HDEBUG("Fetching entries" << first << ".." << last);
+        beginInsertRows(QModelIndex(), first, last);
+        iPrivate->fetch(Private::PAGE_SIZE);
+        endInsertRows();
+    }
+}
+
+void
+HslCardHistory::updateTimeStrings()
+{
+    const int n = iPrivate->iData.count();
+
+    if (n > 0) {
+        for (int i = 0; i < n; i++) {
+            iPrivate->iData.at(i)->formatTimeString();
+        }
+        Q_EMIT dataChanged(index(0), index(n - 1), QVector<int>() <<
+            ModelData::BoardingTimeStringRole);
+    }
+}
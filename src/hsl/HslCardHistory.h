@@ -47,6 +47,8 @@ class HslCardHistory :
 {
     Q_OBJECT
     Q_PROPERTY(QString data READ data WRITE setData NOTIFY historyChanged)
+    Q_PROPERTY(QString cardNumber READ cardNumber WRITE setCardNumber NOTIFY cardNumberChanged)
+    Q_PROPERTY(bool includeArchive READ includeArchive WRITE setIncludeArchive NOTIFY includeArchiveChanged)
     Q_ENUMS(TransactionType)
 
 public:
@@ -56,21 +58,64 @@ public:
         TransactionPurchase
     };
 
+    // Decoded history entry, for C++ consumers of the model
+    struct Entry {
+        TransactionType iType;
+        uint iDay;              // Days since 1.1.1997
+        uint iMinute;           // Minutes since midnight
+        int iTicketPrice;       // Price of a single ticket (cents)
+        int iGroupSize;
+        int iRemainingValue;    // Cents
+    };
+
     HslCardHistory(QObject* aParent = Q_NULLPTR);
     ~HslCardHistory();
 
     QString data() const;
     void setData(QString);
 
+    // Archived entries are shown only if the card number is known.
+    // Either way, the most recent entry goes first and the entries
+    // are fetched page by page.
+    QString cardNumber() const;
+    void setCardNumber(QString);
+
+    bool includeArchive() const;
+    void setIncludeArchive(bool);
+
+    // All entries, including the ones which haven't been fetched yet
+    int count() const;
+    bool getEntry(int, Entry*) const;
+
+    // Sort key of a raw history entry (for the archive)
+    static quint64 entryTime(const uchar*);
+
+    // Entries stored on the card (without the archive), the most recent
+    // first. Doesn't need a QObject, can be used in a worker thread.
+    static QList<Entry> decode(const QByteArray&);
+
+    // Values of all roles of an entry, keyed by the role names
+    // (the same thing as data() returns for the row)
+    static QVariantMap roleValues(const Entry&);
+
     // QAbstractItemModel
     QHash<int,QByteArray> roleNames() const Q_DECL_OVERRIDE;
     int rowCount(const QModelIndex&) const Q_DECL_OVERRIDE;
     QVariant data(const QModelIndex&, int) const Q_DECL_OVERRIDE;
+    bool canFetchMore(const QModelIndex&) const Q_DECL_OVERRIDE;
+    void fetchMore(const QModelIndex&) Q_DECL_OVERRIDE;
+
+private Q_SLOTS:
+    void updateTimeStrings();
 
 Q_SIGNALS:
     void historyChanged();
+    void cardNumberChanged();
+    void includeArchiveChanged();
 
 private:
+    void updateModel();
+
     class ModelData;
     class Private;
     Private* iPrivate;
@@ -39,10 +39,14 @@
 
 #include "HslCardPeriodPass.h"
 #include "TravelCard.h"
+#include "TravelCardAllocStats.h"
+#include "TravelCardTrace.h"
 #include "Util.h"
 
 #include <gutil_timenotify.h>
 
+#include <QtCore/QTimer>
+
 #include "HarbourDebug.h"
 
 // ==========================================================================
@@ -286,18 +290,12 @@ public:
     SignalMask iQueuedSignals;
     Signal iFirstQueuedSignal;
     QString iHexData;
-    HslArea iValidityArea1;
-    HslArea iValidityArea2;
-    QDate iPeriodStartDate1;
-    QDate iPeriodStartDate2;
-    QDate iPeriodEndDate1;
-    QDate iPeriodEndDate2;
-    QDateTime iLastLoadingTime;
-    int iLatestPeriodPrice;
+    Info iInfo;
     int iEffectiveDaysRemaining;
     QDateTime iEffectiveEndDate;
     PeriodPass iPeriodPass1;
     PeriodPass iPeriodPass2;
+    QTimer* iRefreshTimer;
     GUtilTimeNotify* iTimeNotify;
     gulong iTimeNotifyId;
 };
@@ -307,14 +305,17 @@ HslCardPeriodPass::Private::Private(
     QObject(aParent),
     iQueuedSignals(0),
     iFirstQueuedSignal(SignalCount),
-    iLatestPeriodPrice(0),
     iEffectiveDaysRemaining(0),
     iPeriodPass1(&PERIOD_PASS_SIGNALS_1),
     iPeriodPass2(&PERIOD_PASS_SIGNALS_2),
+    iRefreshTimer(new QTimer(this)),
     iTimeNotify(gutil_time_notify_new()),
     iTimeNotifyId(gutil_time_notify_add_handler(iTimeNotify,
         systemTimeChanged, this))
 {
+    decode(QByteArray(), &iInfo);
+    iRefreshTimer->setSingleShot(true);
+    connect(iRefreshTimer, SIGNAL(timeout()), SLOT(refreshPeriods()));
 }
 
 HslCardPeriodPass::Private::~Private()
@@ -388,52 +389,11 @@ HslCardPeriodPass::Private::updateHexData(
     const QString aHexData)
 {
     const QByteArray hexData(aHexData.toLatin1());
-    const QByteArray bytes(QByteArray::fromHex(hexData));
 
     HDEBUG(hexData.constData());
     iHexData = aHexData;
 
-    if (!bytes.isEmpty()) {
-        const GUtilData data = Util::toData(bytes);
-
-        HDEBUG("  ProductCodeType1 =" << getInt(&data, 0, 1));
-        HDEBUG("  ProductCode1 =" << getInt(&data, 1, 14));
-        iValidityArea1 = getArea(&data, 1, 7, 2, 1);
-        HDEBUG("  ValidityAreaType1 =" << getInt(&data, 1, 7, 2));
-        HDEBUG("  ValidityArea1 =" << getInt(&data, 2, 1, 6) << iValidityArea1);
-        iPeriodStartDate1 = getDate(&data, 2, 7);
-        HDEBUG("  PeriodStartDate1 =" << getInt(&data, 2, 7, 14) << iPeriodStartDate1);
-        iPeriodEndDate1 = getDate(&data, 4, 5);
-        HDEBUG("  PeriodEndDate1 =" << getInt(&data, 4, 5, 14) << iPeriodEndDate1);
-        HDEBUG("  ProductCodeType2 =" << getInt(&data, 7, 0, 1));
-        HDEBUG("  ProductCode2 =" << getInt(&data, 7, 1, 14));
-        iValidityArea2 = getArea(&data, 8, 7, 9, 1);
-        HDEBUG("  ValidityAreaType2 =" << getInt(&data,  8, 7, 2));
-        HDEBUG("  ValidityArea2 =" << getInt(&data, 9, 1, 6) << iValidityArea2);
-        iPeriodStartDate2 = getDate(&data, 9, 7);
-        HDEBUG("  PeriodStartDate2 =" << getInt(&data, 9, 7, 14) << iPeriodStartDate2);
-        iPeriodEndDate2 = getDate(&data, 11, 5);
-        HDEBUG("  PeriodEndDate2 =" << getInt(&data, 11, 5, 14) << iPeriodEndDate2);
-        HDEBUG("  ProductCodeType =" << getInt(&data, 14, 0, 1));
-        HDEBUG("  ProductCode =" << getInt(&data, 14, 1, 14));
-        const QDate loadingDate(getDate(&data, 15, 7));
-        const QTime loadingTime(getTime(&data, 17, 5));
-        iLastLoadingTime = QDateTime(loadingDate, loadingTime, Util::FINLAND_TIMEZONE);
-        HDEBUG("  LoadingDate =" << getInt(&data, 15, 7, 14) << loadingDate);
-        HDEBUG("  LoadingTime =" << getInt(&data, 17, 5, 11) << loadingTime);
-        HDEBUG("  LoadedPeriodDays =" << getInt(&data, 19, 0, 9));
-        iLatestPeriodPrice = getInt(&data, 20, 1, 20);
-        HDEBUG("  PriceOfPeriod =" << iLatestPeriodPrice);
-        HDEBUG("  LoadingOrganisationID =" << getInt(&data, 22, 5, 14));
-        HDEBUG("  LoadingDeviceNumber =" << getInt(&data, 24, 3, 13));
-        HDEBUG("  BoardingDate =" << getInt(&data, 26, 0, 14));
-        HDEBUG("  BoardingTime =" << getInt(&data, 27, 6, 11));
-        HDEBUG("  BoardingVehicle =" << getInt(&data, 29, 1, 14));
-        HDEBUG("  BoardingLocationNumberType =" << getInt(&data, 30, 7, 2));
-        HDEBUG("  BoardingLocationNumber =" << getInt(&data, 31, 1, 14));
-        HDEBUG("  BoardingDirection =" << getInt(&data, 32, 7, 1));
-        HDEBUG("  BoardingAreaType =" << getInt(&data, 33, 0, 2));
-        HDEBUG("  BoardingArea =" << getInt(&data, 33, 2, 6));
+    if (decode(QByteArray::fromHex(hexData), &iInfo)) {
         updatePeriods();
     } else {
         HDEBUG("No valid period pass data");
@@ -447,16 +407,16 @@ void
 HslCardPeriodPass::Private::updatePeriods()
 {
     Signals signals1, signals2;
-    const bool validPeriod1 = isValidPeriod(iPeriodStartDate1, iPeriodEndDate1);
-    const bool validPeriod2 = isValidPeriod(iPeriodStartDate2, iPeriodEndDate2);
+    const bool validPeriod1 = isValidPeriod(iInfo.iPeriodStartDate1, iInfo.iPeriodEndDate1);
+    const bool validPeriod2 = isValidPeriod(iInfo.iPeriodStartDate2, iInfo.iPeriodEndDate2);
     if (validPeriod1) {
         if (validPeriod2) {
             const QDate today(Util::currentTimeInFinland().date());
-            const bool currentPeriod1 = (today >= iPeriodStartDate1 &&
-                today <= iPeriodEndDate1);
-            const bool currentPeriod2 = (today >= iPeriodStartDate2 &&
-                today <= iPeriodEndDate2);
-            const bool latest1 = (iPeriodEndDate1 >= iPeriodEndDate2);
+            const bool currentPeriod1 = (today >= iInfo.iPeriodStartDate1 &&
+                today <= iInfo.iPeriodEndDate1);
+            const bool currentPeriod2 = (today >= iInfo.iPeriodStartDate2 &&
+                today <= iInfo.iPeriodEndDate2);
+            const bool latest1 = (iInfo.iPeriodEndDate1 >= iInfo.iPeriodEndDate2);
 
             HDEBUG("Both periods are valid");
             if (currentPeriod1 == currentPeriod2) {
@@ -464,66 +424,66 @@ HslCardPeriodPass::Private::updatePeriods()
                 // or both nor (a typical situation)
                 if (latest1) {
                     HDEBUG("Current period 1");
-                    signals1 = iPeriodPass1.update(iValidityArea1,
-                        startDateTime(iPeriodStartDate1),
-                        endDateTime(iPeriodEndDate1),
-                        iLastLoadingTime, iLatestPeriodPrice);
-                    signals2 = iPeriodPass2.update(iValidityArea2,
-                        startDateTime(iPeriodStartDate2),
-                        endDateTime(iPeriodEndDate2));
+                    signals1 = iPeriodPass1.update(iInfo.iValidityArea1,
+                        startDateTime(iInfo.iPeriodStartDate1),
+                        endDateTime(iInfo.iPeriodEndDate1),
+                        iInfo.iLastLoadingTime, iInfo.iLatestPeriodPrice);
+                    signals2 = iPeriodPass2.update(iInfo.iValidityArea2,
+                        startDateTime(iInfo.iPeriodStartDate2),
+                        endDateTime(iInfo.iPeriodEndDate2));
                 } else {
                     HDEBUG("Current period 2");
-                    signals1 = iPeriodPass1.update(iValidityArea2,
-                        startDateTime(iPeriodStartDate2),
-                        endDateTime(iPeriodEndDate2),
-                        iLastLoadingTime, iLatestPeriodPrice);
-                    signals2 = iPeriodPass2.update(iValidityArea1,
-                        startDateTime(iPeriodStartDate1),
-                        endDateTime(iPeriodEndDate1));
+                    signals1 = iPeriodPass1.update(iInfo.iValidityArea2,
+                        startDateTime(iInfo.iPeriodStartDate2),
+                        endDateTime(iInfo.iPeriodEndDate2),
+                        iInfo.iLastLoadingTime, iInfo.iLatestPeriodPrice);
+                    signals2 = iPeriodPass2.update(iInfo.iValidityArea1,
+                        startDateTime(iInfo.iPeriodStartDate1),
+                        endDateTime(iInfo.iPeriodEndDate1));
                 }
             } else {
                 if (currentPeriod1) {
                     // Period 1 is current, show it first
                     HDEBUG("Current period 1");
-                    signals1 = iPeriodPass1.update(iValidityArea1,
-                        startDateTime(iPeriodStartDate1),
-                        endDateTime(iPeriodEndDate1),
-                        latest1 ? iLastLoadingTime : QDateTime(),
-                        latest1 ? iLatestPeriodPrice : 0);
-                    signals2 = iPeriodPass2.update(iValidityArea2,
-                        startDateTime(iPeriodStartDate2),
-                        endDateTime(iPeriodEndDate2),
-                        latest1 ? QDateTime() : iLastLoadingTime,
-                        latest1 ? 0 : iLatestPeriodPrice);
+                    signals1 = iPeriodPass1.update(iInfo.iValidityArea1,
+                        startDateTime(iInfo.iPeriodStartDate1),
+                        endDateTime(iInfo.iPeriodEndDate1),
+                        latest1 ? iInfo.iLastLoadingTime : QDateTime(),
+                        latest1 ? iInfo.iLatestPeriodPrice : 0);
+                    signals2 = iPeriodPass2.update(iInfo.iValidityArea2,
+                        startDateTime(iInfo.iPeriodStartDate2),
+                        endDateTime(iInfo.iPeriodEndDate2),
+                        latest1 ? QDateTime() : iInfo.iLastLoadingTime,
+                        latest1 ? 0 : iInfo.iLatestPeriodPrice);
                 } else {
                     // Period 2 is current, show it first
                     HDEBUG("Current period 2");
-                    signals1 = iPeriodPass1.update(iValidityArea2,
-                        startDateTime(iPeriodStartDate2),
-                        endDateTime(iPeriodEndDate2),
-                        latest1 ? QDateTime() : iLastLoadingTime,
-                        latest1 ? 0 : iLatestPeriodPrice);
-                    signals2 = iPeriodPass2.update(iValidityArea1,
-                        startDateTime(iPeriodStartDate1),
-                        endDateTime(iPeriodEndDate1),
-                        latest1 ? iLastLoadingTime : QDateTime(),
-                        latest1 ? iLatestPeriodPrice : 0);
+                    signals1 = iPeriodPass1.update(iInfo.iValidityArea2,
+                        startDateTime(iInfo.iPeriodStartDate2),
+                        endDateTime(iInfo.iPeriodEndDate2),
+                        latest1 ? QDateTime() : iInfo.iLastLoadingTime,
+                        latest1 ? 0 : iInfo.iLatestPeriodPrice);
+                    signals2 = iPeriodPass2.update(iInfo.iValidityArea1,
+                        startDateTime(iInfo.iPeriodStartDate1),
+                        endDateTime(iInfo.iPeriodEndDate1),
+                        latest1 ? iInfo.iLastLoadingTime : QDateTime(),
+                        latest1 ? iInfo.iLatestPeriodPrice : 0);
                 }
             }
         } else {
             HDEBUG("Only period 1 is valid");
-            signals1 = iPeriodPass1.update(iValidityArea1,
-                startDateTime(iPeriodStartDate1),
-                endDateTime(iPeriodEndDate1),
-                iLastLoadingTime, iLatestPeriodPrice);
+            signals1 = iPeriodPass1.update(iInfo.iValidityArea1,
+                startDateTime(iInfo.iPeriodStartDate1),
+                endDateTime(iInfo.iPeriodEndDate1),
+                iInfo.iLastLoadingTime, iInfo.iLatestPeriodPrice);
             signals2 = iPeriodPass2.reset();
         }
     } else if (validPeriod2) {
         HDEBUG("Only period 2 is valid");
-        signals1 = iPeriodPass1.update(iValidityArea2,
-            startDateTime(iPeriodStartDate2),
-            endDateTime(iPeriodEndDate2),
-            iLastLoadingTime, iLatestPeriodPrice);
+        signals1 = iPeriodPass1.update(iInfo.iValidityArea2,
+            startDateTime(iInfo.iPeriodStartDate2),
+            endDateTime(iInfo.iPeriodEndDate2),
+            iInfo.iLastLoadingTime, iInfo.iLatestPeriodPrice);
         signals2 = iPeriodPass2.reset();
     } else {
         HDEBUG("No valid period passes");
@@ -583,8 +543,8 @@ HslCardPeriodPass::Private::scheduleRefreshPeriods()
     const QDate today = now.date();
     const QDateTime nextMidnight(today.addDays(1), QTime(0,0), Util::FINLAND_TIMEZONE);
     HDEBUG(now.toString("dd.MM.yyyy hh:mm:ss") << now.secsTo(nextMidnight) << "sec until midnight");
-    QTimer::singleShot(now.msecsTo(nextMidnight) + 1000, this,
-        SLOT(refreshPeriods()));
+    // Restarting the timer cancels the previously scheduled refresh
+    iRefreshTimer->start(now.msecsTo(nextMidnight) + 1000);
 }
 
 // ==========================================================================
@@ -603,6 +563,67 @@ HslCardPeriodPass::~HslCardPeriodPass()
     delete iPrivate;
 }
 
+bool
+HslCardPeriodPass::decode(
+    const QByteArray& aBytes,
+    Info* aInfo)
+{
+    aInfo->iValidityArea1 = HslArea();
+    aInfo->iPeriodStartDate1 = QDate();
+    aInfo->iPeriodEndDate1 = QDate();
+    aInfo->iValidityArea2 = HslArea();
+    aInfo->iPeriodStartDate2 = QDate();
+    aInfo->iPeriodEndDate2 = QDate();
+    aInfo->iLastLoadingTime = QDateTime();
+    aInfo->iLatestPeriodPrice = 0;
+
+    if (!aBytes.isEmpty()) {
+        const GUtilData data = Util::toData(aBytes);
+
+        HDEBUG("  ProductCodeType1 =" << getInt(&data, 0, 1));
+        HDEBUG("  ProductCode1 =" << getInt(&data, 1, 14));
+        aInfo->iValidityArea1 = getArea(&data, 1, 7, 2, 1);
+        HDEBUG("  ValidityAreaType1 =" << getInt(&data, 1, 7, 2));
+        HDEBUG("  ValidityArea1 =" << getInt(&data, 2, 1, 6) << aInfo->iValidityArea1);
+        aInfo->iPeriodStartDate1 = getDate(&data, 2, 7);
+        HDEBUG("  PeriodStartDate1 =" << getInt(&data, 2, 7, 14) << aInfo->iPeriodStartDate1);
+        aInfo->iPeriodEndDate1 = getDate(&data, 4, 5);
+        HDEBUG("  PeriodEndDate1 =" << getInt(&data, 4, 5, 14) << aInfo->iPeriodEndDate1);
+        HDEBUG("  ProductCodeType2 =" << getInt(&data, 7, 0, 1));
+        HDEBUG("  ProductCode2 =" << getInt(&data, 7, 1, 14));
+        aInfo->iValidityArea2 = getArea(&data, 8, 7, 9, 1);
+        HDEBUG("  ValidityAreaType2 =" << getInt(&data,  8, 7, 2));
+        HDEBUG("  ValidityArea2 =" << getInt(&data, 9, 1, 6) << aInfo->iValidityArea2);
+        aInfo->iPeriodStartDate2 = getDate(&data, 9, 7);
+        HDEBUG("  PeriodStartDate2 =" << getInt(&data, 9, 7, 14) << aInfo->iPeriodStartDate2);
+        aInfo->iPeriodEndDate2 = getDate(&data, 11, 5);
+        HDEBUG("  PeriodEndDate2 =" << getInt(&data, 11, 5, 14) << aInfo->iPeriodEndDate2);
+        HDEBUG("  ProductCodeType =" << getInt(&data, 14, 0, 1));
+        HDEBUG("  ProductCode =" << getInt(&data, 14, 1, 14));
+        const QDate loadingDate(getDate(&data, 15, 7));
+        const QTime loadingTime(getTime(&data, 17, 5));
+        aInfo->iLastLoadingTime = QDateTime(loadingDate, loadingTime, Util::FINLAND_TIMEZONE);
+        HDEBUG("  LoadingDate =" << getInt(&data, 15, 7, 14) << loadingDate);
+        HDEBUG("  LoadingTime =" << getInt(&data, 17, 5, 11) << loadingTime);
+        HDEBUG("  LoadedPeriodDays =" << getInt(&data, 19, 0, 9));
+        aInfo->iLatestPeriodPrice = getInt(&data, 20, 1, 20);
+        HDEBUG("  PriceOfPeriod =" << aInfo->iLatestPeriodPrice);
+        HDEBUG("  LoadingOrganisationID =" << getInt(&data, 22, 5, 14));
+        HDEBUG("  LoadingDeviceNumber =" << getInt(&data, 24, 3, 13));
+        HDEBUG("  BoardingDate =" << getInt(&data, 26, 0, 14));
+        HDEBUG("  BoardingTime =" << getInt(&data, 27, 6, 11));
+        HDEBUG("  BoardingVehicle =" << getInt(&data, 29, 1, 14));
+        HDEBUG("  BoardingLocationNumberType =" << getInt(&data, 30, 7, 2));
+        HDEBUG("  BoardingLocationNumber =" << getInt(&data, 31, 1, 14));
+        HDEBUG("  BoardingDirection =" << getInt(&data, 32, 7, 1));
+        HDEBUG("  BoardingAreaType =" << getInt(&data, 33, 0, 2));
+        HDEBUG("  BoardingArea =" << getInt(&data, 33, 2, 6));
+        return true;
+    } else {
+        return false;
+    }
+}
+
 const QString
 HslCardPeriodPass::data() const
 {
@@ -613,6 +634,9 @@ void
 HslCardPeriodPass::setData(
     const QString aData)
 {
+    TRACE_SCOPE("HslCardPeriodPass::setData");
+    ALLOC_STATS_SCOPE(Parse);
+
     const QString data(aData.toLower());
     if (iPrivate->iHexData != data) {
         iPrivate->updateHexData(data);
@@ -75,9 +75,27 @@ class HslCardPeriodPass :
     class Types;
 
 public:
+    // Both periods as they are stored on the card, for C++ code which
+    // doesn't need a QObject (e.g. running in a worker thread). Which
+    // one is period 1 and how many days are remaining depends on the
+    // current date, that's not included.
+    struct Info {
+        HslArea iValidityArea1;
+        QDate iPeriodStartDate1;
+        QDate iPeriodEndDate1;
+        HslArea iValidityArea2;
+        QDate iPeriodStartDate2;
+        QDate iPeriodEndDate2;
+        QDateTime iLastLoadingTime;
+        int iLatestPeriodPrice;     // Cents
+    };
+
     HslCardPeriodPass(QObject* aParent = Q_NULLPTR);
     ~HslCardPeriodPass();
 
+    // Returns false if there's no data
+    static bool decode(const QByteArray&, Info*);
+
     const QString data() const;
     void setData(const QString);
 
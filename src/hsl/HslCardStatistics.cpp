@@ -0,0 +1,450 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "HslCardStatistics.h"
+#include "HslCardHistory.h"
+#include "HslCardStoredValue.h"
+#include "Util.h"
+
+#include "HarbourDebug.h"
+
+#include <QtCore/QMap>
+#include <QtCore/QPointer>
+#include <QtCore/QVector>
+
+// Model roles
+#define MODEL_ROLES_(first,role,last) \
+    first(Year,year) \
+    role(Month,month) \
+    role(Spent,spent) \
+    role(SpentString,spentString) \
+    role(ToppedUp,toppedUp) \
+    role(Boardings,boardings) \
+    last(GroupTrips,groupTrips)
+
+#define MODEL_ROLES(role) \
+    MODEL_ROLES_(role,role,role)
+
+// ==========================================================================
+// HslCardStatistics::Private
+// ==========================================================================
+
+class HslCardStatistics::Private :
+    public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Role {
+        #define FIRST(X,x) FirstRole = Qt::UserRole, X##Role = FirstRole,
+        #define ROLE(X,x) X##Role,
+        #define LAST(X,x) X##Role, LastRole = X##Role
+        MODEL_ROLES_(FIRST,ROLE,LAST)
+        #undef FIRST
+        #undef ROLE
+        #undef LAST
+    };
+
+    struct Month {
+        int iYear;
+        int iMonth;
+        int iSpent;         // Cents
+        int iToppedUp;      // Cents
+        int iBoardings;
+        int iGroupTrips;
+
+        bool operator==(const Month&) const;
+        QVariant get(Role) const;
+    };
+
+    typedef QVector<Month> Months;
+    typedef QMap<int,Month> MonthMap;
+
+    Private(HslCardStatistics*);
+
+    HslCardStatistics* parentModel() const;
+    int count() const;
+    void setHistory(HslCardHistory*);
+    void setStoredValue(HslCardStoredValue*);
+
+    static uint timestamp(uint, uint);
+    static int cost(const HslCardHistory::Entry&);
+    static Month& monthAt(MonthMap&, uint);
+
+    Months compute() const;
+
+public Q_SLOTS:
+    void update();
+
+public:
+    QPointer<HslCardHistory> iHistory;
+    QPointer<HslCardStoredValue> iStoredValue;
+    Months iMonths;
+    int iMaxCount;
+};
+
+bool
+HslCardStatistics::Private::Month::operator==(
+    const Month& aMonth) const
+{
+    return iYear == aMonth.iYear &&
+        iMonth == aMonth.iMonth &&
+        iSpent == aMonth.iSpent &&
+        iToppedUp == aMonth.iToppedUp &&
+        iBoardings == aMonth.iBoardings &&
+        iGroupTrips == aMonth.iGroupTrips;
+}
+
+QVariant
+HslCardStatistics::Private::Month::get(
+    Role aRole) const
+{
+    switch (aRole) {
+    case YearRole: return iYear;
+    case MonthRole: return iMonth;
+    case SpentRole: return iSpent;
+    case SpentStringRole: return Util::moneyString(iSpent);
+    case ToppedUpRole: return iToppedUp;
+    case BoardingsRole: return iBoardings;
+    case GroupTripsRole: return iGroupTrips;
+    }
+    return QVariant();
+}
+
+HslCardStatistics::Private::Private(
+    HslCardStatistics* aParent) :
+    QObject(aParent),
+    iMaxCount(-1)
+{
+}
+
+inline
+HslCardStatistics*
+HslCardStatistics::Private::parentModel() const
+{
+    return qobject_cast<HslCardStatistics*>(parent());
+}
+
+int
+HslCardStatistics::Private::count() const
+{
+    const int n = iMonths.count();
+
+    return (iMaxCount >= 0 && iMaxCount < n) ? iMaxCount : n;
+}
+
+void
+HslCardStatistics::Private::setHistory(
+    HslCardHistory* aHistory)
+{
+    if (iHistory) {
+        iHistory->disconnect(this);
+    }
+    iHistory = aHistory;
+    if (iHistory) {
+        connect(iHistory, SIGNAL(historyChanged()), SLOT(update()));
+    }
+    update();
+}
+
+void
+HslCardStatistics::Private::setStoredValue(
+    HslCardStoredValue* aStoredValue)
+{
+    if (iStoredValue) {
+        iStoredValue->disconnect(this);
+    }
+    iStoredValue = aStoredValue;
+    if (iStoredValue) {
+        connect(iStoredValue, SIGNAL(dataChanged()), SLOT(update()));
+    }
+    update();
+}
+
+inline
+uint
+HslCardStatistics::Private::timestamp(
+    uint aDay,
+    uint aMinute)
+{
+    return aDay * 24 * 60 + aMinute;
+}
+
+inline
+int
+HslCardStatistics::Private::cost(
+    const HslCardHistory::Entry& aEntry)
+{
+    return aEntry.iTicketPrice * qMax(aEntry.iGroupSize, 1);
+}
+
+HslCardStatistics::Private::Month&
+HslCardStatistics::Private::monthAt(
+    MonthMap& aMonths,
+    uint aDay)
+{
+    const QDate date(HslData::START_DATE.addDays(aDay));
+    const int key = date.year() * 12 + date.month() - 1;
+    MonthMap::iterator it = aMonths.find(key);
+
+    if (it == aMonths.end()) {
+        const Month month = { date.year(), date.month(), 0, 0, 0, 0 };
+
+        it = aMonths.insert(key, month);
+    }
+    return it.value();
+}
+
+HslCardStatistics::Private::Months
+HslCardStatistics::Private::compute() const
+{
+    MonthMap months;
+
+    // The last load is the only one that's recorded explicitly. The
+    // earlier ones can only be detected by the balance going up in
+    // between two purchases.
+    int loadedValue = 0;
+    uint loadTime = 0;
+
+    if (iStoredValue && iStoredValue->loadedValue() > 0) {
+        loadedValue = iStoredValue->loadedValue();
+        loadTime = timestamp(iStoredValue->loadingDay(),
+            iStoredValue->loadingMinute());
+        monthAt(months, iStoredValue->loadingDay()).iToppedUp += loadedValue;
+    }
+
+    // The history comes sorted, the most recent entry first. One pass
+    // is enough, and only the last seen purchase needs to be remembered.
+    HslCardHistory::Entry nextPurchase;
+    bool haveNextPurchase = false;
+    const int n = iHistory ? iHistory->count() : 0;
+
+    for (int i = 0; i < n; i++) {
+        HslCardHistory::Entry entry;
+
+        if (iHistory->getEntry(i, &entry) &&
+            entry.iType != HslCardHistory::TransactionUnknown) {
+            Month& month = monthAt(months, entry.iDay);
+
+            month.iBoardings++;
+            if (entry.iType == HslCardHistory::TransactionPurchase) {
+                month.iSpent += cost(entry);
+                if (entry.iGroupSize > 1) {
+                    month.iGroupTrips++;
+                }
+                if (haveNextPurchase) {
+                    int loaded = nextPurchase.iRemainingValue +
+                        cost(nextPurchase) - entry.iRemainingValue;
+
+                    if (loaded > 0 && loadedValue > 0 &&
+                        loadTime > timestamp(entry.iDay, entry.iMinute) &&
+                        loadTime <= timestamp(nextPurchase.iDay,
+                            nextPurchase.iMinute)) {
+                        // Already counted
+                        loaded -= loadedValue;
+                    }
+                    if (loaded > 0) {
+                        HDEBUG("Detected load of" << loaded);
+                        monthAt(months, nextPurchase.iDay).iToppedUp += loaded;
+                    }
+                }
+                nextPurchase = entry;
+                haveNextPurchase = true;
+            }
+        }
+    }
+
+    // Most recent month first
+    Months result;
+
+    result.reserve(months.count());
+    MonthMap::const_iterator it = months.constEnd();
+    while (it != months.constBegin()) {
+        --it;
+        result.append(it.value());
+    }
+    return result;
+}
+
+void
+HslCardStatistics::Private::update()
+{
+    const Months months(compute());
+
+    if (iMonths != months) {
+        HslCardStatistics* model = parentModel();
+        const int prevCount = count();
+
+        model->beginResetModel();
+        iMonths = months;
+        model->endResetModel();
+        if (prevCount != count()) {
+            Q_EMIT model->countChanged();
+        }
+    }
+}
+
+// ==========================================================================
+// HslCardStatistics
+// ==========================================================================
+
+HslCardStatistics::HslCardStatistics(
+    QObject* aParent) :
+    QAbstractListModel(aParent),
+    iPrivate(new Private(this))
+{
+}
+
+HslCardStatistics::~HslCardStatistics()
+{
+    if (iPrivate->iHistory) {
+        iPrivate->iHistory->disconnect(iPrivate);
+    }
+    if (iPrivate->iStoredValue) {
+        iPrivate->iStoredValue->disconnect(iPrivate);
+    }
+}
+
+QObject*
+HslCardStatistics::history() const
+{
+    return iPrivate->iHistory;
+}
+
+void
+HslCardStatistics::setHistory(
+    QObject* aObject)
+{
+    HslCardHistory* history = qobject_cast<HslCardHistory*>(aObject);
+
+    if (iPrivate->iHistory != history) {
+        iPrivate->setHistory(history);
+        Q_EMIT historyChanged();
+    }
+}
+
+QObject*
+HslCardStatistics::storedValue() const
+{
+    return iPrivate->iStoredValue;
+}
+
+void
+HslCardStatistics::setStoredValue(
+    QObject* aObject)
+{
+    HslCardStoredValue* storedValue = qobject_cast<HslCardStoredValue*>(aObject);
+
+    if (iPrivate->iStoredValue != storedValue) {
+        iPrivate->setStoredValue(storedValue);
+        Q_EMIT storedValueChanged();
+    }
+}
+
+int
+HslCardStatistics::maxCount() const
+{
+    return iPrivate->iMaxCount;
+}
+
+void
+HslCardStatistics::setMaxCount(
+    int aMaxCount)
+{
+    if (aMaxCount < 0) {
+        aMaxCount = -1;
+    }
+    if (iPrivate->iMaxCount != aMaxCount) {
+        const int prevCount = iPrivate->count();
+        const int n = iPrivate->iMonths.count();
+        const int newCount = (aMaxCount >= 0 && aMaxCount < n) ? aMaxCount : n;
+
+        HDEBUG(aMaxCount);
+        if (newCount < prevCount) {
+            beginRemoveRows(QModelIndex(), newCount, prevCount - 1);
+            iPrivate->iMaxCount = aMaxCount;
+            endRemoveRows();
+        } else if (newCount > prevCount) {
+            beginInsertRows(QModelIndex(), prevCount, newCount - 1);
+            iPrivate->iMaxCount = aMaxCount;
+            endInsertRows();
+        } else {
+            iPrivate->iMaxCount = aMaxCount;
+        }
+        if (prevCount != newCount) {
+            Q_EMIT countChanged();
+        }
+        Q_EMIT maxCountChanged();
+    }
+}
+
+int
+HslCardStatistics::count() const
+{
+    return iPrivate->count();
+}
+
+QHash<int,QByteArray>
+HslCardStatistics::roleNames() const
+{
+    QHash<int,QByteArray> roles;
+    #define ROLE(X,x) roles.insert(Private::X##Role, #x);
+    MODEL_ROLES(ROLE)
+    #undef ROLE
+    return roles;
+}
+
+int
+HslCardStatistics::rowCount(
+    const QModelIndex&) const
+{
+    return iPrivate->count();
+}
+
+QVariant
+HslCardStatistics::data(
+    const QModelIndex& aIndex,
+    int aRole) const
+{
+    const int row = aIndex.row();
+
+    return (row >= 0 && row < iPrivate->count()) ?
+        iPrivate->iMonths.at(row).get((Private::Role)aRole) : QVariant();
+}
+
+#include "HslCardStatistics.moc"
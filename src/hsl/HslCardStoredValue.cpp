@@ -38,6 +38,8 @@
  */
 
 #include "HslCardStoredValue.h"
+#include "TravelCardAllocStats.h"
+#include "TravelCardTrace.h"
 #include "Util.h"
 
 #include "HarbourDebug.h"
@@ -55,31 +57,53 @@ public:
 
 public:
     QString iHexData;
-    int iMoneyValue;
-    QDateTime iLoadingTime;
-    int iLoadedValue;
+    Info iInfo;
 };
 
-HslCardStoredValue::Private::Private() :
-    iMoneyValue(0),
-    iLoadedValue(0)
-{}
+HslCardStoredValue::Private::Private()
+{
+    decode(QByteArray(), &iInfo);
+}
 
 void
 HslCardStoredValue::Private::setHexData(
     QString aHexData)
 {
     const QByteArray hexData(aHexData.toLatin1());
-    const QByteArray bytes(QByteArray::fromHex(hexData));
 
     HDEBUG(hexData.constData());
     iHexData = aHexData;
-    iMoneyValue = 0;
-    iLoadingTime = QDateTime();
-    iLoadedValue = 0;
+    decode(QByteArray::fromHex(hexData), &iInfo);
+}
+
+// ==========================================================================
+// HslCardStoredValue
+// ==========================================================================
+
+HslCardStoredValue::HslCardStoredValue(
+    QObject* aParent) :
+    HslData(aParent),
+    iPrivate(new Private())
+{}
+
+HslCardStoredValue::~HslCardStoredValue()
+{
+    delete iPrivate;
+}
+
+void
+HslCardStoredValue::decode(
+    const QByteArray& aBytes,
+    Info* aInfo)
+{
+    aInfo->iMoneyValue = 0;
+    aInfo->iLoadedValue = 0;
+    aInfo->iLoadingTime = QDateTime();
+    aInfo->iLoadingDay = 0;
+    aInfo->iLoadingMinute = 0;
 
-    if (!bytes.isEmpty()) {
-        const GUtilData data = Util::toData(bytes);
+    if (!aBytes.isEmpty()) {
+        const GUtilData data = Util::toData(aBytes);
 
         // StoredValue
         //
@@ -95,35 +119,22 @@ HslCardStoredValue::Private::setHexData(
         // | 9/7      | 14    | uint  | Loading device number     |
         // | 11/5     | 3     | -     | Reserved                  |
         // +======================================================+
-        iMoneyValue = getInt(&data, 0, 20);
-        HDEBUG("  ValueCounter =" << iMoneyValue);
-        const QDate loadingDate(getDate(&data, 2, 4));
-        const QTime loadingTime(getTime(&data, 4, 2));
-        iLoadingTime = QDateTime(loadingDate, loadingTime, Util::FINLAND_TIMEZONE);
-        HDEBUG("  LoadingDate =" << getInt(&data, 2, 4, 14) << loadingDate);
-        HDEBUG("  LoadingTime =" << getInt(&data, 4, 2, 11) << loadingTime);
-        iLoadedValue = getInt(&data, 5, 5, 20);
-        HDEBUG("  LoadedValue =" << iLoadedValue);
+        aInfo->iMoneyValue = getInt(&data, 0, 20);
+        HDEBUG("  ValueCounter =" << aInfo->iMoneyValue);
+        aInfo->iLoadingDay = getInt(&data, 2, 4, DATE_BITS);
+        aInfo->iLoadingMinute = getInt(&data, 4, 2, TIME_BITS);
+        const QDate loadingDate(START_DATE.addDays(aInfo->iLoadingDay));
+        const QTime loadingTime(START_TIME.addSecs(aInfo->iLoadingMinute * 60));
+        aInfo->iLoadingTime = QDateTime(loadingDate, loadingTime, Util::FINLAND_TIMEZONE);
+        HDEBUG("  LoadingDate =" << aInfo->iLoadingDay << loadingDate);
+        HDEBUG("  LoadingTime =" << aInfo->iLoadingMinute << loadingTime);
+        aInfo->iLoadedValue = getInt(&data, 5, 5, 20);
+        HDEBUG("  LoadedValue =" << aInfo->iLoadedValue);
         HDEBUG("  LoadingOrganisationID =" << getInt(&data, 8, 1, 14));
         HDEBUG("  LoadingDeviceNumber =" << getInt(&data, 9, 7, 14));
     }
 }
 
-// ==========================================================================
-// HslCardStoredValue
-// ==========================================================================
-
-HslCardStoredValue::HslCardStoredValue(
-    QObject* aParent) :
-    HslData(aParent),
-    iPrivate(new Private())
-{}
-
-HslCardStoredValue::~HslCardStoredValue()
-{
-    delete iPrivate;
-}
-
 QString
 HslCardStoredValue::data() const
 {
@@ -134,19 +145,20 @@ void
 HslCardStoredValue::setData(
     QString aData)
 {
+    TRACE_SCOPE("HslCardStoredValue::setData");
+    ALLOC_STATS_SCOPE(Parse);
+
     QString data(aData.toLower());
     if (iPrivate->iHexData != data) {
-        const int prevMoneyValue = iPrivate->iMoneyValue;
-        const QDateTime prevLoadingTime(iPrivate->iLoadingTime);
-        const int prevLoadedValue = iPrivate->iLoadedValue;
+        const Info prev(iPrivate->iInfo);
         iPrivate->setHexData(data);
-        if (prevMoneyValue != iPrivate->iMoneyValue) {
+        if (prev.iMoneyValue != iPrivate->iInfo.iMoneyValue) {
             Q_EMIT moneyValueChanged();
         }
-        if (prevLoadingTime != iPrivate->iLoadingTime) {
+        if (prev.iLoadingTime != iPrivate->iInfo.iLoadingTime) {
             Q_EMIT loadingTimeChanged();
         }
-        if (prevLoadedValue != iPrivate->iLoadedValue) {
+        if (prev.iLoadedValue != iPrivate->iInfo.iLoadedValue) {
             Q_EMIT loadedValueChanged();
         }
         Q_EMIT dataChanged();
@@ -156,17 +168,29 @@ HslCardStoredValue::setData(
 int
 HslCardStoredValue::moneyValue() const
 {
-    return iPrivate->iMoneyValue;
+    return iPrivate->iInfo.iMoneyValue;
 }
 
 int
 HslCardStoredValue::loadedValue() const
 {
-    return iPrivate->iLoadedValue;
+    return iPrivate->iInfo.iLoadedValue;
 }
 
 QDateTime
 HslCardStoredValue::loadingTime() const
 {
-    return iPrivate->iLoadingTime;
+    return iPrivate->iInfo.iLoadingTime;
+}
+
+uint
+HslCardStoredValue::loadingDay() const
+{
+    return iPrivate->iInfo.iLoadingDay;
+}
+
+uint
+HslCardStoredValue::loadingMinute() const
+{
+    return iPrivate->iInfo.iLoadingMinute;
 }
@@ -53,9 +53,21 @@ class HslCardStoredValue :
     Q_PROPERTY(QDateTime loadingTime READ loadingTime NOTIFY loadingTimeChanged)
 
 public:
+    // Decoded stored value, for C++ code which doesn't need
+    // a QObject (e.g. running in a worker thread)
+    struct Info {
+        int iMoneyValue;        // Cents
+        int iLoadedValue;       // Cents
+        QDateTime iLoadingTime;
+        uint iLoadingDay;       // Days since 1.1.1997
+        uint iLoadingMinute;    // Minutes since midnight
+    };
+
     HslCardStoredValue(QObject* aParent = Q_NULLPTR);
     ~HslCardStoredValue();
 
+    static void decode(const QByteArray&, Info*);
+
     QString data() const;
     void setData(QString);
 
@@ -63,6 +75,10 @@ public:
     int loadedValue() const;
     QDateTime loadingTime() const;
 
+    // Raw loading time (days since 1.1.1997 and minutes since midnight)
+    uint loadingDay() const;
+    uint loadingMinute() const;
+
 Q_SIGNALS:
     void dataChanged();
     void moneyValueChanged();
@@ -38,6 +38,9 @@
  */
 
 #include "TravelCard.h"
+#include "TravelCardHistoryFilter.h"
+#include "TravelCardPolling.h"
+#include "TravelCardTrace.h"
 
 #include "NfcAdapter.h"
 #include "NfcMode.h"
@@ -55,9 +58,85 @@
 #include <QGuiApplication>
 #include <QtQuick>
 
+#include <atomic>
+
+#include <stdio.h>
+
 #define APP_NAME  "harbour-matkakortti"
 #define APP_QML_IMPORT  "harbour.matkakortti"
 
+// Startup profile, printed to stderr when the first frame has been
+// swapped if MATKAKORTTI_STARTUP_PROFILE environment variable is set.
+// Everything is a no-op otherwise.
+#define STARTUP_PROFILE_ENV "MATKAKORTTI_STARTUP_PROFILE"
+#define STARTUP_PROFILE_MAX_PHASES (8)
+
+static struct startup_profile {
+    bool enabled;
+    int count;
+    QElapsedTimer timer;
+    const char* name[STARTUP_PROFILE_MAX_PHASES];
+    qint64 ns[STARTUP_PROFILE_MAX_PHASES];
+    std::atomic<qint64> first_frame;
+    QMetaObject::Connection frame_swapped[2];
+} startup_profile;
+
+static void startup_profile_start()
+{
+    startup_profile.enabled = !qgetenv(STARTUP_PROFILE_ENV).isEmpty();
+    if (startup_profile.enabled) {
+        startup_profile.timer.start();
+    }
+}
+
+static void startup_profile_phase(const char* name)
+{
+    struct startup_profile* p = &startup_profile;
+    if (p->enabled && p->count < STARTUP_PROFILE_MAX_PHASES) {
+        p->name[p->count] = name;
+        p->ns[p->count++] = p->timer.nsecsElapsed();
+    }
+}
+
+static void startup_profile_print()
+{
+    const struct startup_profile* p = &startup_profile;
+    qint64 prev = 0;
+    fprintf(stderr, "Startup profile (ms):\n");
+    for (int i = 0; i < p->count; i++) {
+        fprintf(stderr, "  %-16s %8.1f %8.1f\n", p->name[i],
+            (p->ns[i] - prev)/1e6, p->ns[i]/1e6);
+        prev = p->ns[i];
+    }
+    fprintf(stderr, "  %-16s %8.1f %8.1f\n", "firstFrame",
+        (p->first_frame - prev)/1e6, p->first_frame/1e6);
+}
+
+static void startup_profile_watch(QQuickWindow* window)
+{
+    struct startup_profile* p = &startup_profile;
+    if (p->enabled) {
+        // frameSwapped is usually emitted on the render thread, the time
+        // is taken there and the rest is done on the main thread
+        p->frame_swapped[0] = QObject::connect(window,
+            &QQuickWindow::frameSwapped, []() {
+                qint64 none = 0;
+                startup_profile.first_frame.compare_exchange_strong(none,
+                    startup_profile.timer.nsecsElapsed());
+            });
+        p->frame_swapped[1] = QObject::connect(window,
+            &QQuickWindow::frameSwapped, window, []() {
+                struct startup_profile* p = &startup_profile;
+                if (p->first_frame && p->frame_swapped[0]) {
+                    QObject::disconnect(p->frame_swapped[0]);
+                    QObject::disconnect(p->frame_swapped[1]);
+                    p->frame_swapped[0] = QMetaObject::Connection();
+                    startup_profile_print();
+                }
+            }, Qt::QueuedConnection);
+    }
+}
+
 static void register_types(const char* uri, int v1 = 1, int v2 = 0)
 {
 #define REGISTER_TYPE(uri, v1, v2, Class) \
@@ -73,15 +152,20 @@ static void register_types(const char* uri, int v1 = 1, int v2 = 0)
     REGISTER_SINGLETON_TYPE(uri, v1, v2, NfcSystem);
     REGISTER_TYPE(uri, v1, v2, NfcMode);
     REGISTER_TYPE(uri, v1, v2, TravelCard);
+    REGISTER_TYPE(uri, v1, v2, TravelCardHistoryFilter);
+    REGISTER_TYPE(uri, v1, v2, TravelCardPolling);
     TravelCard::registerTypes(uri, v1, v2);
 }
 
 int main(int argc, char *argv[])
 {
+    startup_profile_start();
     QGuiApplication* app = SailfishApp::application(argc, argv);
+    startup_profile_phase("application");
 
     app->setApplicationName(APP_NAME);
     register_types(APP_QML_IMPORT, 1, 0);
+    startup_profile_phase("registerTypes");
 
     // Load translations
     QLocale locale;
@@ -100,6 +184,7 @@ int main(int argc, char *argv[])
         HDEBUG("Failed to load translator for" << locale);
         delete tr;
     }
+    startup_profile_phase("translations");
 
 #ifdef DEBUG
     gutil_log_default.level = GLOG_LEVEL_VERBOSE;
@@ -107,14 +192,36 @@ int main(int argc, char *argv[])
 
     // Create the view
     QQuickView* view = SailfishApp::createView();
+    startup_profile_phase("createView");
+    startup_profile_watch(view);
 
     // Initialize the view and show it
     view->setTitle(qtTrId("matkakortti-app_name"));
+#ifdef APP_QML_RESOURCES
+    // Built with CONFIG+=aot_qml
+    view->setSource(QUrl("qrc:/qml/main.qml"));
+#else
     view->setSource(SailfishApp::pathTo("qml/main.qml"));
+#endif
+    startup_profile_phase("setSource");
     view->showFullScreen();
+    startup_profile_phase("showFullScreen");
+
+#ifdef MATKAKORTTI_TRACE
+    TravelCardTrace::expectFrame();
+    QObject::connect(view, &QQuickWindow::frameSwapped,
+        TravelCardTrace::frameSwapped);
+#endif
 
     int ret = app->exec();
 
+#ifdef MATKAKORTTI_TRACE
+    const QString traceFile(qgetenv(TravelCardTrace::FILE_ENV));
+    if (!traceFile.isEmpty()) {
+        TravelCardTrace::save(traceFile);
+    }
+#endif
+
     delete view;
     delete app;
     return ret;
@@ -45,6 +45,11 @@
 #include "NysseCardOwnerInfo.h"
 #include "NysseCardTicketInfo.h"
 #include "NysseCard.h"
+#include "TravelCardAllocStats.h"
+#include "TravelCardArchive.h"
+#include "TravelCardDump.h"
+#include "TravelCardSummary.h"
+#include "TravelCardTrace.h"
 #include "Util.h"
 
 #include "HarbourDebug.h"
@@ -112,10 +117,9 @@ public:
     void readNextBlock();
     const DataBlock* currentBlock();
 
-    static TravelCardImpl* newTravelCard(QString, QObject*);
+    static TravelCardImpl* newTravelCard(TravelCardSession*, QObject*);
     static void registerTypes(const char*, int, int);
-
-    static const QString PAGE_URL;
+    static TravelCardSummary* newSummary(QObject*);
 
     static const DataBlock DATA_BLOCKS[];
 
@@ -156,8 +160,6 @@ public:
     int iCurrentBlock;
 };
 
-const QString NysseCard::Private::PAGE_URL("nysse/NyssePage.qml");
-
 //
 // This is basically what Android app does:
 //
@@ -271,19 +273,23 @@ NysseCard::Private::transmit(
 void
 NysseCard::Private::readSucceeded()
 {
-    QVariantMap cardInfo;
-    cardInfo.insert(Util::CARD_TYPE_KEY, Desc.iName);
+    TRACE_SCOPE("NysseCard::readSucceeded");
+    ALLOC_STATS_SCOPE(ReadSucceeded);
+
+    // Card number is BCD encoded in bytes 1-9 of the application info.
+    // Save the history before the card forgets it.
+    TravelCardArchive::store(Desc.iName,
+        HarbourUtil::toHex(iResp[APP_INFO_BLOCK].iData.mid(1, 9)),
+        DATA_BLOCKS[HISTORY_BLOCK].iRecordSize, NysseCardHistory::entryTime,
+        iResp[HISTORY_BLOCK].iData);
+
+    TravelCardDump dump(Desc.iName);
     for (int i = 0; i < BLOCK_COUNT; i++) {
         const Response* resp = iResp + i;
-        const char* key = DATA_BLOCKS[i].iKey;
-        cardInfo.insert(QString::asprintf("%sData", key),
-            HarbourUtil::toHex(resp->iData)),
-        cardInfo.insert(QString::asprintf("%sStatus1", key),
-            QString::asprintf("%04x", resp->iPrepareStatus));
-        cardInfo.insert(QString::asprintf("%sStatus2", key),
-            QString::asprintf("%04x", resp->iReadStatus));
+        dump.addBlock(QLatin1String(DATA_BLOCKS[i].iKey), resp->iData,
+            resp->iPrepareStatus, resp->iReadStatus);
     }
-    parentObject()->success(PAGE_URL, cardInfo);
+    parentObject()->success(Desc.iPageUrl, dump);
 }
 
 void
@@ -404,9 +410,9 @@ NysseCard::Private::SELECT_RESPONSE_SLOT(
 // ==========================================================================
 
 NysseCard::NysseCard(
-    QString aPath,
+    TravelCardSession* aSession,
     QObject* aParent) :
-    TravelCardIsoDep(aPath, aParent),
+    TravelCardIsoDep(aSession, aParent),
     iPrivate(new Private(this))
 {}
 
@@ -417,6 +423,49 @@ NysseCard::startIo()
     transmit(&Private::SELECT_CMD, iPrivate, QT_STRINGIFY(SELECT_RESPONSE_SLOT));
 }
 
+// ==========================================================================
+// NysseCard::Summary
+// ==========================================================================
+
+class NysseCard::Summary :
+    public TravelCardSummary
+{
+    Q_OBJECT
+
+public:
+    Summary(QObject*);
+
+    void setCardInfo(const QVariantMap&) Q_DECL_OVERRIDE;
+
+private Q_SLOTS:
+    void updateBalance();
+
+private:
+    NysseCardBalance* iBalance;
+};
+
+NysseCard::Summary::Summary(
+    QObject* aParent) :
+    TravelCardSummary(Desc.iName, aParent),
+    iBalance(new NysseCardBalance(this))
+{
+    connect(iBalance, SIGNAL(balanceChanged()), SLOT(updateBalance()));
+}
+
+void
+NysseCard::Summary::setCardInfo(
+    const QVariantMap& aCardInfo)
+{
+    // Season tickets aren't decoded, only the balance is shown
+    iBalance->setData(aCardInfo.value(QStringLiteral("balanceData")).toString());
+}
+
+void
+NysseCard::Summary::updateBalance()
+{
+    setBalance(iBalance->balance());
+}
+
 // ==========================================================================
 // NysseCard::Desc
 // ==========================================================================
@@ -425,10 +474,10 @@ NysseCard::startIo()
 
 TravelCardImpl*
 NysseCard::Private::newTravelCard(
-    QString aPath,
+    TravelCardSession* aSession,
     QObject* aParent)
 {
-    return new NysseCard(aPath, aParent);
+    return new NysseCard(aSession, aParent);
 }
 
 void
@@ -444,10 +493,20 @@ NysseCard::Private::registerTypes(
     REGISTER_TYPE(NysseCardTicketInfo, aUri, v1, v2);
 }
 
+TravelCardSummary*
+NysseCard::Private::newSummary(
+    QObject* aParent)
+{
+    return new Summary(aParent);
+}
+
 const TravelCardImpl::CardDesc NysseCard::Desc = {
     QStringLiteral("Nysse"),
+    QStringLiteral("nysse/NyssePage.qml"),
     NysseCard::Private::newTravelCard,
-    NysseCard::Private::registerTypes
+    NysseCard::Private::registerTypes,
+    NysseCard::Private::newSummary,
+    NfcTechA // DESFire
 };
 
 #include "NysseCard.moc"
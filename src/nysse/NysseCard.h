@@ -47,7 +47,7 @@ class NysseCard :
 {
     Q_OBJECT
     Q_DISABLE_COPY(NysseCard)
-    NysseCard(QString, QObject*);
+    NysseCard(TravelCardSession*, QObject*);
 
 public:
     static const CardDesc Desc;
@@ -57,6 +57,7 @@ protected:
 
 private:
     class Private;
+    class Summary;
     Private* iPrivate;
 };
 
@@ -36,6 +36,8 @@
  */
 
 #include "NysseCardAppInfo.h"
+#include "TravelCardAllocStats.h"
+#include "TravelCardTrace.h"
 
 #include "HarbourDebug.h"
 
@@ -49,15 +51,14 @@ public:
 
 public:
     QString iHexData;
-    QString iCardNumber;
+    Info iInfo;
 };
 
 void NysseCardAppInfo::Private::setHexData(QString aHexData)
 {
     HDEBUG(qPrintable(aHexData));
     iHexData = aHexData;
-    iCardNumber = iHexData.mid(2, 18);
-    HDEBUG("  CardNumber =" << iCardNumber);
+    decode(QByteArray::fromHex(aHexData.toLatin1()), &iInfo);
 }
 
 // ==========================================================================
@@ -75,6 +76,13 @@ NysseCardAppInfo::~NysseCardAppInfo()
     delete iPrivate;
 }
 
+void NysseCardAppInfo::decode(const QByteArray& aBytes, Info* aInfo)
+{
+    // Card number is 9 bytes long, right after the first byte
+    aInfo->iCardNumber = QString::fromLatin1(aBytes.mid(1, 9).toHex());
+    HDEBUG("  CardNumber =" << aInfo->iCardNumber);
+}
+
 QString NysseCardAppInfo::data() const
 {
     return iPrivate->iHexData;
@@ -82,11 +90,14 @@ QString NysseCardAppInfo::data() const
 
 void NysseCardAppInfo::setData(QString aData)
 {
+    TRACE_SCOPE("NysseCardAppInfo::setData");
+    ALLOC_STATS_SCOPE(Parse);
+
     QString data(aData.toLower());
     if (iPrivate->iHexData != data) {
-        const QString prevCardNumber(iPrivate->iCardNumber);
+        const QString prevCardNumber(iPrivate->iInfo.iCardNumber);
         iPrivate->setHexData(data);
-        if (prevCardNumber != iPrivate->iCardNumber) {
+        if (prevCardNumber != iPrivate->iInfo.iCardNumber) {
             Q_EMIT cardNumberChanged();
         }
         Q_EMIT dataChanged();
@@ -95,5 +106,5 @@ void NysseCardAppInfo::setData(QString aData)
 
 QString NysseCardAppInfo::cardNumber() const
 {
-    return iPrivate->iCardNumber;
+    return iPrivate->iInfo.iCardNumber;
 }
@@ -47,9 +47,16 @@ class NysseCardAppInfo : public QObject {
     Q_PROPERTY(QString cardNumber READ cardNumber NOTIFY cardNumberChanged)
 
 public:
+    // Decoded application info, for C++ code which doesn't need a QObject
+    struct Info {
+        QString iCardNumber;
+    };
+
     NysseCardAppInfo(QObject* aParent = Q_NULLPTR);
     ~NysseCardAppInfo();
 
+    static void decode(const QByteArray& aBytes, Info* aInfo);
+
     QString data() const;
     void setData(QString aData);
 
@@ -38,6 +38,8 @@
  */
 
 #include "NysseCardBalance.h"
+#include "TravelCardAllocStats.h"
+#include "TravelCardTrace.h"
 #include "Util.h"
 
 #include "HarbourDebug.h"
@@ -75,16 +77,15 @@ public:
     SignalMask iQueuedSignals;
     Signal iFirstQueuedSignal;
     QString iHexData;
-    bool iValid;
-    uint iBalance;
+    Info iInfo;
 };
 
 NysseCardBalance::Private::Private() :
     iQueuedSignals(0),
-    iFirstQueuedSignal(SignalCount),
-    iValid(false),
-    iBalance(0)
-{}
+    iFirstQueuedSignal(SignalCount)
+{
+    decode(QByteArray(), &iInfo);
+}
 
 void
 NysseCardBalance::Private::queueSignal(
@@ -138,22 +139,12 @@ NysseCardBalance::Private::setHexData(
         HDEBUG(qPrintable(iHexData));
         queueSignal(SignalDataChanged);
 
-        uint balance = 0;
-        bool valid = false;
-        const QByteArray bytes(QByteArray::fromHex(aHexData.toLatin1()));
-        if (bytes.size() == 4) {
-            const uchar* data = (const uchar*) bytes.constData();
-            balance = Util::uint32le(data);
-            HDEBUG("  Balance =" << balance);
-            valid = true;
-        }
-
-        if (iBalance != balance) {
-            iBalance = balance;
+        const Info prev(iInfo);
+        decode(QByteArray::fromHex(aHexData.toLatin1()), &iInfo);
+        if (prev.iBalance != iInfo.iBalance) {
             queueSignal(SignalBalanceChanged);
         }
-        if (iValid != valid) {
-            iValid = valid;
+        if (prev.iValid != iInfo.iValid) {
             queueSignal(SignalValidChanged);
         }
     }
@@ -175,6 +166,21 @@ NysseCardBalance::~NysseCardBalance()
     delete iPrivate;
 }
 
+void
+NysseCardBalance::decode(
+    const QByteArray& aBytes,
+    Info* aInfo)
+{
+    if (aBytes.size() == 4) {
+        aInfo->iBalance = Util::uint32le((const uchar*)aBytes.constData());
+        aInfo->iValid = true;
+        HDEBUG("  Balance =" << aInfo->iBalance);
+    } else {
+        aInfo->iBalance = 0;
+        aInfo->iValid = false;
+    }
+}
+
 QString
 NysseCardBalance::data() const
 {
@@ -185,6 +191,9 @@ void
 NysseCardBalance::setData(
     QString aData)
 {
+    TRACE_SCOPE("NysseCardBalance::setData");
+    ALLOC_STATS_SCOPE(Parse);
+
     iPrivate->setHexData(aData.toLower());
     iPrivate->emitQueuedSignals(this);
 }
@@ -192,11 +201,11 @@ NysseCardBalance::setData(
 bool
 NysseCardBalance::valid() const
 {
-    return iPrivate->iValid;
+    return iPrivate->iInfo.iValid;
 }
 
 uint
 NysseCardBalance::balance() const
 {
-    return iPrivate->iBalance;
+    return iPrivate->iInfo.iBalance;
 }
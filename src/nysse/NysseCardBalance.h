@@ -52,9 +52,17 @@ class NysseCardBalance :
     Q_PROPERTY(uint balance READ balance NOTIFY balanceChanged)
 
 public:
+    // Decoded balance, for C++ code which doesn't need a QObject
+    struct Info {
+        bool iValid;
+        uint iBalance;      // Cents
+    };
+
     NysseCardBalance(QObject* aParent = Q_NULLPTR);
     ~NysseCardBalance();
 
+    static void decode(const QByteArray&, Info*);
+
     QString data() const;
     void setData(QString);
 
@@ -37,10 +37,18 @@
  * any official policies, either expressed or implied.
  */
 
+#include "NysseCard.h"
 #include "NysseCardHistory.h"
 #include "NysseUtil.h"
+#include "TravelCardAllocStats.h"
+#include "TravelCardArchive.h"
+#include "TravelCardTrace.h"
 #include "Util.h"
 
+#include <gutil_timenotify.h>
+
+#include <QtCore/QTimer>
+
 #include "HarbourDebug.h"
 
 // Model roles
@@ -48,7 +56,10 @@
     first(TransactionType,transactionType) \
     role(TransactionTime,transactionTime) \
     role(PassengerCount,passengerCount) \
-    last(MoneyAmount,moneyAmount)
+    role(MoneyAmount,moneyAmount) \
+    role(TransactionTimeString,transactionTimeString) \
+    role(MoneyAmountString,moneyAmountString) \
+    last(TotalAmountString,totalAmountString)
 
 #define MODEL_ROLES(role) \
     MODEL_ROLES_(role,role,role)
@@ -74,12 +85,17 @@ public:
     ModelData(TransactionType, QDateTime, uint, uint);
 
     QVariant get(Role) const;
+    void formatTimeString();
 
 public:
     const TransactionType iTransactionType;
     const QDateTime iTransactionTime;
     const uint iPassengerCount;
     const uint iMoneyAmount;
+    // Pre-formatted strings, so that delegates don't have to do it
+    QString iTransactionTimeString;
+    const QString iMoneyAmountString;
+    const QString iTotalAmountString;
 };
 
 NysseCardHistory::ModelData::ModelData(
@@ -90,7 +106,10 @@ NysseCardHistory::ModelData::ModelData(
     iTransactionType(aType),
     iTransactionTime(aTransactionTime),
     iPassengerCount(aPassengerCount),
-    iMoneyAmount(aMoneyAmount)
+    iMoneyAmount(aMoneyAmount),
+    iTransactionTimeString(Util::dateTimeString(aTransactionTime)),
+    iMoneyAmountString(Util::moneyString(aMoneyAmount)),
+    iTotalAmountString(Util::moneyString(aMoneyAmount * aPassengerCount))
 {
 }
 
@@ -103,10 +122,19 @@ NysseCardHistory::ModelData::get(
     case TransactionTimeRole: return iTransactionTime;
     case PassengerCountRole: return iPassengerCount;
     case MoneyAmountRole: return iMoneyAmount;
+    case TransactionTimeStringRole: return iTransactionTimeString;
+    case MoneyAmountStringRole: return iMoneyAmountString;
+    case TotalAmountStringRole: return iTotalAmountString;
     }
     return QVariant();
 }
 
+void
+NysseCardHistory::ModelData::formatTimeString()
+{
+    iTransactionTimeString = Util::dateTimeString(iTransactionTime);
+}
+
 // ==========================================================================
 // NysseCardHistory::Private
 // ==========================================================================
@@ -114,26 +142,106 @@ NysseCardHistory::ModelData::get(
 class NysseCardHistory::Private
 {
 public:
-    enum { ENTRY_SIZE = 16 };
+    enum {
+        ENTRY_SIZE = 16,
+        PAGE_SIZE = 50
+    };
 
-    Private();
+    Private(NysseCardHistory*);
     ~Private();
 
     void setHexData(const QString);
+    void clearRecords();
+    int recordCount() const;
+    const uchar* recordAt(int) const;
+    void fetch(int);
     const ModelData* dataAt(int) const;
 
+    static void decodeEntry(const uchar*, Entry*);
+    static void systemTimeChanged(GUtilTimeNotify*, void*);
+
 public:
     QString iHexData;
+    QString iCardNumber;
+    bool iIncludeArchive;
     ModelData::List iData;
+    // Entries are fetched on demand, most recent first, either straight
+    // from the mapped archive file or (if there's no archive) from the
+    // records found on the card. Only one of these is used at a time.
+    TravelCardArchive* iArchive;
+    QByteArray iCardRecords;
+    GUtilTimeNotify* iTimeNotify;
+    gulong iTimeNotifyId;
 };
 
-NysseCardHistory::Private::Private()
+NysseCardHistory::Private::Private(
+    NysseCardHistory* aModel) :
+    iIncludeArchive(false),
+    iArchive(Q_NULLPTR),
+    iTimeNotify(gutil_time_notify_new()),
+    iTimeNotifyId(gutil_time_notify_add_handler(iTimeNotify,
+        systemTimeChanged, aModel))
 {
 }
 
 NysseCardHistory::Private::~Private()
 {
+    gutil_time_notify_remove_handler(iTimeNotify, iTimeNotifyId);
+    gutil_time_notify_unref(iTimeNotify);
     qDeleteAll(iData);
+    delete iArchive;
+}
+
+void
+NysseCardHistory::Private::systemTimeChanged(
+    GUtilTimeNotify*,
+    void* aModel)
+{
+    HDEBUG("System time changed");
+    QTimer::singleShot(0, (NysseCardHistory*) aModel, SLOT(updateTimeStrings()));
+}
+
+void
+NysseCardHistory::Private::decodeEntry(
+    const uchar* aBlock,
+    Entry* aEntry)
+{
+    // History block layout:
+    //
+    // +===========================================================+
+    // | Offset | Size | Description                               |
+    // +===========================================================+
+    // | 0      | 2    | Date                                      |
+    // | 2      | 1    | Minutes since last validation             |
+    // | 3      | 3    | ???                                       |
+    // | 6      | 2    | Time + Transaction type (low nibble)      |
+    // | 8      | 2    | Transaction amount (in cents)             |
+    // | 10     | 2    | Route + something (low 2 bits)            |
+    // | 12     | 1    | Transaction type (part 2)                 |
+    // | 13     | 1    | Passenger count (high nibble) + something |
+    // | 14     | 2    | ???                                       |
+    // +===========================================================+
+    //
+    HDEBUG(QByteArray((char*)aBlock, ENTRY_SIZE).toHex().constData());
+    const guint typeCode = (((guint)(aBlock[6] & 0x0f)) << 8) + aBlock[12];
+    // Not so sure about these...
+    switch (typeCode) {
+    case 0x100: aEntry->iType = TransactionIssue; break;
+    case 0x300: aEntry->iType = TransactionCharge; break;
+    case 0x301: aEntry->iType = TransactionDeposit; break;
+    case 0x54a: aEntry->iType = TransactionPurchase; break;
+    case 0x548:
+    case 0xb48: aEntry->iType = TransactionValidation; break;
+    default:    aEntry->iType = TransactionUnknown; break;
+    }
+    HDEBUG("  Type =" << hex << typeCode << "(" << dec  << aEntry->iType << ")");
+    aEntry->iTime = NysseUtil::toDateTime(Util::uint16le(aBlock + 0),
+        Util::uint16le(aBlock + 6) >> 4);
+    HDEBUG("  Time =" << aEntry->iTime);
+    aEntry->iPassengerCount = aBlock[13] >> 4;
+    HDEBUG("  Count =" << aEntry->iPassengerCount);
+    aEntry->iMoneyAmount = Util::uint16le(aBlock + 8);
+    HDEBUG("  MoneyAmount =" << aEntry->iMoneyAmount);
 }
 
 void
@@ -143,54 +251,74 @@ NysseCardHistory::Private::setHexData(
     iHexData = aHexData;
     qDeleteAll(iData);
     iData.clear();
+    clearRecords();
 
     HDEBUG(qPrintable(aHexData));
     const QByteArray bytes(QByteArray::fromHex(aHexData.toLatin1()));
-    HASSERT(!(bytes.size() % ENTRY_SIZE));
-    const int n = bytes.size() / ENTRY_SIZE;
-    HDEBUG(n << "history entries:");
-    for (int i = n - 1; i >= 0; i--) {
-        const guint8* block = (guint8*) bytes.constData() + i * ENTRY_SIZE;
-
-        // History block layout:
-        //
-        // +===========================================================+
-        // | Offset | Size | Description                               |
-        // +===========================================================+
-        // | 0      | 2    | Date                                      |
-        // | 2      | 1    | Minutes since last validation             |
-        // | 3      | 3    | ???                                       |
-        // | 6      | 2    | Time + Transaction type (low nibble)      |
-        // | 8      | 2    | Transaction amount (in cents)             |
-        // | 10     | 2    | Route + something (low 2 bits)            |
-        // | 12     | 1    | Transaction type (part 2)                 |
-        // | 13     | 1    | Passenger count (high nibble) + something |
-        // | 14     | 2    | ???                                       |
-        // +===========================================================+
-        //
-        HDEBUG("Entry #" << (i + 1) << ":" <<
-            QByteArray((char*)block, ENTRY_SIZE).toHex().constData());
-        const guint typeCode = (((guint)(block[6] & 0x0f)) << 8) + block[12];
-        TransactionType type;
-        // Not so sure about these...
-        switch (typeCode) {
-        case 0x100: type = TransactionIssue; break;
-        case 0x300: type = TransactionCharge; break;
-        case 0x301: type = TransactionDeposit; break;
-        case 0x54a: type = TransactionPurchase; break;
-        case 0x548:
-        case 0xb48: type = TransactionValidation; break;
-        default:    type = TransactionUnknown; break;
+    if (iIncludeArchive && !iCardNumber.isEmpty()) {
+        TravelCardArchive* archive = new TravelCardArchive(NysseCard::Desc.iName,
+            iCardNumber, ENTRY_SIZE, NysseCardHistory::entryTime);
+
+        // The card driver archives everything that's on the card before
+        // the data gets here. The model never writes to the archive, it
+        // only reads the entries straight from the mapped archive file.
+        // If the archive doesn't have them (e.g. the data didn't come
+        // from the card driver), the card records are shown as is.
+        if (archive->containsAll(bytes)) {
+            iArchive = archive;
+        } else {
+            delete archive;
         }
-        HDEBUG("  Type =" << hex << typeCode << "(" << dec  << type << ")");
-        QDateTime time(NysseUtil::toDateTime(Util::uint16le(block + 0),
-            Util::uint16le(block + 6) >> 4));
-        HDEBUG("  Time =" << time);
-        const uint count = block[13] >> 4;
-        HDEBUG("  Count =" << count);
-        const uint amount = Util::uint16le(block + 8);
-        HDEBUG("  MoneyAmount =" << amount);
-        iData.append(new ModelData(type, time, count, amount));
+    }
+    if (!iArchive) {
+        HASSERT(!(bytes.size() % ENTRY_SIZE));
+        iCardRecords = TravelCardArchive::newestFirst(bytes, ENTRY_SIZE,
+            NysseCardHistory::entryTime);
+    }
+    HDEBUG(recordCount() << "history entries");
+    fetch(PAGE_SIZE);
+}
+
+void
+NysseCardHistory::Private::clearRecords()
+{
+    delete iArchive;
+    iArchive = Q_NULLPTR;
+    iCardRecords.clear();
+}
+
+int
+NysseCardHistory::Private::recordCount() const
+{
+    return iArchive ? iArchive->count() : (iCardRecords.size() / ENTRY_SIZE);
+}
+
+const uchar*
+NysseCardHistory::Private::recordAt(
+    int aRow) const
+{
+    if (iArchive) {
+        // Archive file is sorted the other way around
+        return iArchive->recordData(iArchive->count() - aRow - 1);
+    } else if (aRow >= 0 && aRow < recordCount()) {
+        return (const uchar*)iCardRecords.constData() + aRow * ENTRY_SIZE;
+    } else {
+        return Q_NULLPTR;
+    }
+}
+
+void
+NysseCardHistory::Private::fetch(
+    int aCount)
+{
+    const int end = qMin(iData.count() + aCount, recordCount());
+    Entry entry;
+
+    for (int i = iData.count(); i < end; i++) {
+        HDEBUG("Entry #" << (i + 1));
+        decodeEntry(recordAt(i), &entry);
+        iData.append(new ModelData(entry.iType, entry.iTime,
+            entry.iPassengerCount, entry.iMoneyAmount));
     }
 }
 
@@ -213,7 +341,7 @@ NysseCardHistory::Private::dataAt(
 NysseCardHistory::NysseCardHistory(
     QObject* aParent) :
     QAbstractListModel(aParent),
-    iPrivate(new Private)
+    iPrivate(new Private(this))
 {
 }
 
@@ -232,38 +360,134 @@ void
 NysseCardHistory::setData(
     const QString aData)
 {
+    TRACE_SCOPE("NysseCardHistory::setData");
+    ALLOC_STATS_SCOPE(Parse);
+
     QString data(aData.toLower());
     if (iPrivate->iHexData != data) {
-        const ModelData::List prevData(iPrivate->iData);
-        const int prevCount = prevData.count();
-        iPrivate->iData.clear();
-        iPrivate->setHexData(data);
-        // All this just to avoid resetting the entire model
-        // which resets view position too.
-        const ModelData::List newData(iPrivate->iData);
-        const int count = iPrivate->iData.count();
-        iPrivate->iData = prevData;
-        if (count < prevCount) {
-            beginRemoveRows(QModelIndex(), count, prevCount - 1);
-            iPrivate->iData = newData;
-            endRemoveRows();
-            if (count > 0) {
-                QAbstractListModel::dataChanged(index(0), index(count - 1));
-            }
-        } else if (count > prevCount) {
-            beginInsertRows(QModelIndex(), prevCount, count - 1);
-            iPrivate->iData = newData;
-            endInsertRows();
-            if (prevCount > 0) {
-                QAbstractListModel::dataChanged(index(0), index(prevCount - 1));
-            }
-        } else if (count > 0) {
-            iPrivate->iData = newData;
+        iPrivate->iHexData = data;
+        updateModel();
+        Q_EMIT dataChanged();
+    }
+}
+
+QString
+NysseCardHistory::cardNumber() const
+{
+    return iPrivate->iCardNumber;
+}
+
+void
+NysseCardHistory::setCardNumber(
+    QString aCardNumber)
+{
+    if (iPrivate->iCardNumber != aCardNumber) {
+        iPrivate->iCardNumber = aCardNumber;
+        HDEBUG(aCardNumber);
+        if (iPrivate->iIncludeArchive) {
+            updateModel();
+        }
+        Q_EMIT cardNumberChanged();
+    }
+}
+
+bool
+NysseCardHistory::includeArchive() const
+{
+    return iPrivate->iIncludeArchive;
+}
+
+void
+NysseCardHistory::setIncludeArchive(
+    bool aIncludeArchive)
+{
+    if (iPrivate->iIncludeArchive != aIncludeArchive) {
+        iPrivate->iIncludeArchive = aIncludeArchive;
+        HDEBUG(aIncludeArchive);
+        if (!iPrivate->iCardNumber.isEmpty()) {
+            updateModel();
+        }
+        Q_EMIT includeArchiveChanged();
+    }
+}
+
+void
+NysseCardHistory::updateModel()
+{
+    const ModelData::List prevData(iPrivate->iData);
+    const int prevCount = prevData.count();
+    iPrivate->iData.clear();
+    iPrivate->setHexData(iPrivate->iHexData);
+    // Keep the rows which have already been fetched
+    iPrivate->fetch(prevCount - iPrivate->iData.count());
+    // All this just to avoid resetting the entire model
+    // which resets view position too.
+    const ModelData::List newData(iPrivate->iData);
+    const int count = iPrivate->iData.count();
+    iPrivate->iData = prevData;
+    if (count < prevCount) {
+        beginRemoveRows(QModelIndex(), count, prevCount - 1);
+        iPrivate->iData = newData;
+        endRemoveRows();
+        if (count > 0) {
             QAbstractListModel::dataChanged(index(0), index(count - 1));
         }
-        qDeleteAll(prevData);
-        Q_EMIT dataChanged();
+    } else if (count > prevCount) {
+        beginInsertRows(QModelIndex(), prevCount, count - 1);
+        iPrivate->iData = newData;
+        endInsertRows();
+        if (prevCount > 0) {
+            QAbstractListModel::dataChanged(index(0), index(prevCount - 1));
+        }
+    } else if (count > 0) {
+        iPrivate->iData = newData;
+        QAbstractListModel::dataChanged(index(0), index(count - 1));
+    }
+    qDeleteAll(prevData);
+}
+
+quint64
+NysseCardHistory::entryTime(
+    const uchar* aRecord)
+{
+    // Days since 1 Jan 1900 and half-minutes since midnight
+    return (quint64)Util::uint16le(aRecord) * 24 * 60 * 2 +
+        (Util::uint16le(aRecord + 6) >> 4);
+}
+
+QList<NysseCardHistory::Entry>
+NysseCardHistory::decode(
+    const QByteArray& aBytes)
+{
+    const int size = Private::ENTRY_SIZE;
+    const QByteArray records(TravelCardArchive::newestFirst(aBytes, size,
+        entryTime));
+    const int n = records.size() / size;
+    const uchar* ptr = (const uchar*)records.constData();
+    QList<Entry> entries;
+
+    for (int i = 0; i < n; i++) {
+        Entry entry;
+
+        HDEBUG("Entry #" << (i + 1));
+        Private::decodeEntry(ptr + i * size, &entry);
+        entries.append(entry);
     }
+    return entries;
+}
+
+QVariantMap
+NysseCardHistory::roleValues(
+    const Entry& aEntry)
+{
+    const ModelData data(aEntry.iType, aEntry.iTime, aEntry.iPassengerCount,
+        aEntry.iMoneyAmount);
+    QVariantMap map;
+
+#define ROLE(X,x) map.insert(QStringLiteral(#x), data.get(ModelData::X##Role));
+    MODEL_ROLES(ROLE)
+#undef ROLE
+    return map;
 }
 
 QHash<int,QByteArray>
@@ -291,3 +515,40 @@ NysseCardHistory::data(
     const ModelData* data = iPrivate->dataAt(aIndex.row());
     return data ? data->get((ModelData::Role)aRole) : QVariant();
 }
+
+bool
+NysseCardHistory::canFetchMore(
+    const QModelIndex&) const
+{
+    return iPrivate->iData.count() < iPrivate->recordCount();
+}
+
+void
+NysseCardHistory::fetchMore(
+    const QModelIndex&)
+{
+    if (canFetchMore(QModelIndex())) {
+        const int first = iPrivate->iData.count();
+        const int last = qMin(first + (int)Private::PAGE_SIZE,
+            iPrivate->recordCount()) - 1;
+
+        HDEBUG("Fetching entries" << first << ".." << last);
+        beginInsertRows(QModelIndex(), first, last);
+        iPrivate->fetch(Private::PAGE_SIZE);
+        endInsertRows();
+    }
+}
+
+void
+NysseCardHistory::updateTimeStrings()
+{
+    const int n = iPrivate->iData.count();
+
+    if (n > 0) {
+        for (int i = 0; i < n; i++) {
+            iPrivate->iData.at(i)->formatTimeString();
+        }
+        QAbstractListModel::dataChanged(index(0), index(n - 1),
+            QVector<int>() << ModelData::TransactionTimeStringRole);
+    }
+}
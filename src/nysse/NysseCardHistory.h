@@ -41,6 +41,7 @@
 #define NYSSE_CARD_HISTORY_H
 
 #include <QAbstractListModel>
+#include <QDateTime>
 
 class NysseCardHistory :
     public QAbstractListModel
@@ -48,6 +49,8 @@ class NysseCardHistory :
     Q_OBJECT
     Q_DISABLE_COPY(NysseCardHistory)
     Q_PROPERTY(QString data READ data WRITE setData NOTIFY dataChanged)
+    Q_PROPERTY(QString cardNumber READ cardNumber WRITE setCardNumber NOTIFY cardNumberChanged)
+    Q_PROPERTY(bool includeArchive READ includeArchive WRITE setIncludeArchive NOTIFY includeArchiveChanged)
     Q_ENUMS(TransactionType)
 
 public:
@@ -60,21 +63,58 @@ public:
         TransactionValidation
     };
 
+    // Decoded history entry, for C++ code which doesn't need the model
+    struct Entry {
+        TransactionType iType;
+        QDateTime iTime;
+        uint iPassengerCount;
+        uint iMoneyAmount;      // Cents
+    };
+
     NysseCardHistory(QObject* aParent = Q_NULLPTR);
     ~NysseCardHistory();
 
     const QString data() const;
     void setData(const QString);
 
+    // Archived entries are shown only if the card number is known.
+    // Either way, the most recent entry goes first and the entries
+    // are fetched page by page.
+    QString cardNumber() const;
+    void setCardNumber(QString);
+
+    bool includeArchive() const;
+    void setIncludeArchive(bool);
+
+    // Sort key of a raw history entry (for the archive)
+    static quint64 entryTime(const uchar*);
+
+    // Entries stored on the card (without the archive), the most recent
+    // first. Doesn't need a QObject, can be used in a worker thread.
+    static QList<Entry> decode(const QByteArray&);
+
+    // Values of all roles of an entry, keyed by the role names
+    // (the same thing as data() returns for the row)
+    static QVariantMap roleValues(const Entry&);
+
     // QAbstractItemModel
     QHash<int,QByteArray> roleNames() const Q_DECL_OVERRIDE;
     int rowCount(const QModelIndex&) const Q_DECL_OVERRIDE;
     QVariant data(const QModelIndex&, int) const Q_DECL_OVERRIDE;
+    bool canFetchMore(const QModelIndex&) const Q_DECL_OVERRIDE;
+    void fetchMore(const QModelIndex&) Q_DECL_OVERRIDE;
+
+private Q_SLOTS:
+    void updateTimeStrings();
 
 Q_SIGNALS:
     void dataChanged();
+    void cardNumberChanged();
+    void includeArchiveChanged();
 
 private:
+    void updateModel();
+
     class ModelData;
     class Private;
     Private* iPrivate;
@@ -37,6 +37,8 @@
 
 #include "NysseCardOwnerInfo.h"
 #include "NysseUtil.h"
+#include "TravelCardAllocStats.h"
+#include "TravelCardTrace.h"
 #include "Util.h"
 
 #include "HarbourDebug.h"
@@ -79,9 +81,7 @@ public:
     SignalMask iQueuedSignals;
     Signal iFirstQueuedSignal;
     QString iHexData;
-    QString iOwnerName;
-    QDateTime iBirthDate;
-    QDateTime iIssueDate;
+    Info iInfo;
 };
 
 NysseCardOwnerInfo::Private::Private(
@@ -138,57 +138,21 @@ void
 NysseCardOwnerInfo::Private::updateHexData(
     const QString aHexData)
 {
-    // Owner info layout (96 bytes)
-    //
-    // +=========================================================+
-    // | Offset | Size | Description                             |
-    // +=========================================================+
-    // | 0      | 6    | ??? (05 00 00 00 00 00)                 |
-    // | 6      | 24   | Owner's name, padded with zeros         |
-    // | 30     | 4    | ???                                     |
-    // | 34     | 2    | Birthdate (days since 1 Jan 1900)       |
-    // | 36     | 6    | ???                                     |
-    // | 42     | 2    | Card issue date (days since 1 Jan 1900) |
-    // | 44     | 52   | ???                                     |
-    // +=========================================================+
     if (iHexData != aHexData) {
         iHexData = aHexData;
         HDEBUG(qPrintable(iHexData));
         queueSignal(SignalDataChanged);
 
-        const QString prevOwnerName(iOwnerName);
-        const QDateTime prevBirthDate(iBirthDate);
-        const QDateTime prevIssueDate(iIssueDate);
-        const QByteArray data(QByteArray::fromHex(aHexData.toLatin1()));
-
-        if (data.size() >= 44) {
-            const uchar* bytes = (const uchar*)data.constData();
-
-            // Owner name is padded with zeros
-            const char* name = data.constData() + 6;
-            int nameLen = 24;
-            while (nameLen > 0 && !name[nameLen - 1]) nameLen--;
-            iOwnerName = QString::fromLatin1(name, nameLen);
-            HDEBUG("  OwnerName =" << iOwnerName);
-
-            iBirthDate = NysseUtil::toDateTime(Util::uint16le(bytes + 34));
-            HDEBUG("  BirthDate =" << iBirthDate.date());
-
-            iIssueDate = NysseUtil::toDateTime(Util::uint16le(bytes + 42));
-            HDEBUG("  IssueDate =" << iIssueDate.date());
-        } else {
-            iOwnerName.clear();
-            iBirthDate =
-            iIssueDate = QDateTime();
-        }
+        const Info prev(iInfo);
 
-        if (prevOwnerName != iOwnerName) {
+        decode(QByteArray::fromHex(aHexData.toLatin1()), &iInfo);
+        if (prev.iOwnerName != iInfo.iOwnerName) {
             queueSignal(SignalOwnerNameChanged);
         }
-        if (prevBirthDate != iBirthDate) {
+        if (prev.iBirthDate != iInfo.iBirthDate) {
             queueSignal(SignalBirthDateChanged);
         }
-        if (prevIssueDate != iIssueDate) {
+        if (prev.iIssueDate != iInfo.iIssueDate) {
             queueSignal(SignalIssueDateChanged);
         }
     }
@@ -205,6 +169,46 @@ NysseCardOwnerInfo::NysseCardOwnerInfo(
 {
 }
 
+void
+NysseCardOwnerInfo::decode(
+    const QByteArray& aData,
+    Info* aInfo)
+{
+    // Owner info layout (96 bytes)
+    //
+    // +=========================================================+
+    // | Offset | Size | Description                             |
+    // +=========================================================+
+    // | 0      | 6    | ??? (05 00 00 00 00 00)                 |
+    // | 6      | 24   | Owner's name, padded with zeros         |
+    // | 30     | 4    | ???                                     |
+    // | 34     | 2    | Birthdate (days since 1 Jan 1900)       |
+    // | 36     | 6    | ???                                     |
+    // | 42     | 2    | Card issue date (days since 1 Jan 1900) |
+    // | 44     | 52   | ???                                     |
+    // +=========================================================+
+    if (aData.size() >= 44) {
+        const uchar* bytes = (const uchar*)aData.constData();
+
+        // Owner name is padded with zeros
+        const char* name = aData.constData() + 6;
+        int nameLen = 24;
+        while (nameLen > 0 && !name[nameLen - 1]) nameLen--;
+        aInfo->iOwnerName = QString::fromLatin1(name, nameLen);
+        HDEBUG("  OwnerName =" << aInfo->iOwnerName);
+
+        aInfo->iBirthDate = NysseUtil::toDateTime(Util::uint16le(bytes + 34));
+        HDEBUG("  BirthDate =" << aInfo->iBirthDate.date());
+
+        aInfo->iIssueDate = NysseUtil::toDateTime(Util::uint16le(bytes + 42));
+        HDEBUG("  IssueDate =" << aInfo->iIssueDate.date());
+    } else {
+        aInfo->iOwnerName.clear();
+        aInfo->iBirthDate =
+        aInfo->iIssueDate = QDateTime();
+    }
+}
+
 QString
 NysseCardOwnerInfo::data() const
 {
@@ -215,6 +219,9 @@ void
 NysseCardOwnerInfo::setData(
     const QString aHexData)
 {
+    TRACE_SCOPE("NysseCardOwnerInfo::setData");
+    ALLOC_STATS_SCOPE(Parse);
+
     iPrivate->updateHexData(aHexData);
     iPrivate->emitQueuedSignals();
 }
@@ -222,19 +229,19 @@ NysseCardOwnerInfo::setData(
 QString
 NysseCardOwnerInfo::ownerName() const
 {
-    return iPrivate->iOwnerName;
+    return iPrivate->iInfo.iOwnerName;
 }
 
 QDateTime
 NysseCardOwnerInfo::birthDate() const
 {
-    return iPrivate->iBirthDate;
+    return iPrivate->iInfo.iBirthDate;
 }
 
 QDateTime
 NysseCardOwnerInfo::issueDate() const
 {
-    return iPrivate->iIssueDate;
+    return iPrivate->iInfo.iIssueDate;
 }
 
 #include "NysseCardOwnerInfo.moc"
@@ -52,8 +52,17 @@ class NysseCardOwnerInfo :
     Q_PROPERTY(QDateTime issueDate READ issueDate NOTIFY issueDateChanged)
 
 public:
+    // Decoded owner info, for C++ code which doesn't need a QObject
+    struct Info {
+        QString iOwnerName;
+        QDateTime iBirthDate;
+        QDateTime iIssueDate;
+    };
+
     NysseCardOwnerInfo(QObject* aParent = Q_NULLPTR);
 
+    static void decode(const QByteArray&, Info*);
+
     QString data() const;
     void setData(const QString);
 
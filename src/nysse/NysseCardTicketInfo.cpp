@@ -41,9 +41,13 @@
 
 #include "NysseCardTicketInfo.h"
 #include "NysseUtil.h"
+#include "TravelCardAllocStats.h"
 #include "TravelCard.h"
+#include "TravelCardTrace.h"
 #include "Util.h"
 
+#include <QtCore/QTimer>
+
 #include "HarbourDebug.h"
 
 // s(SignalName,signalName)
@@ -92,9 +96,9 @@ public:
     SignalMask iQueuedSignals;
     Signal iFirstQueuedSignal;
     QString iHexData;
-    QDateTime iEndDate;
-    bool iValid;
+    Info iInfo;
     int iDaysRemaining;
+    QTimer* iRefreshTimer;
     GUtilTimeNotify* iTimeNotify;
     gulong iTimeNotifyId;
 };
@@ -104,12 +108,15 @@ NysseCardTicketInfo::Private::Private(
     QObject(aParent),
     iQueuedSignals(0),
     iFirstQueuedSignal(SignalCount),
-    iValid(false),
     iDaysRemaining(TravelCard::PeriodInvalid),
+    iRefreshTimer(new QTimer(this)),
     iTimeNotify(gutil_time_notify_new()),
     iTimeNotifyId(gutil_time_notify_add_handler(iTimeNotify,
         systemTimeChanged, this))
 {
+    decode(QByteArray(), &iInfo);
+    iRefreshTimer->setSingleShot(true);
+    connect(iRefreshTimer, SIGNAL(timeout()), SLOT(refreshDaysRemaining()));
 }
 
 NysseCardTicketInfo::Private::~Private()
@@ -165,53 +172,16 @@ void
 NysseCardTicketInfo::Private::updateHexData(
     const QString aHexData)
 {
-    const QByteArray bytes(QByteArray::fromHex(aHexData.toLatin1()));
+    const Info prev(iInfo);
 
     iHexData = aHexData;
     HDEBUG(qPrintable(iHexData));
-
-    // Season pass info contains two 48 bytes blocks.
-    // Block layout:
-    //
-    // +=========================================================+
-    // | Offset | Size | Description                             |
-    // +=========================================================+
-    // | 0      | 1    | Block id                                |
-    // | 1      | 5    | ??? (usually 0f 03 00 00 00)            |
-    // | 6      | 1    | Record type?                            |
-    // |        |      +-----------------------------------------+
-    // |        |      | 0x00 | Empty record                     |
-    // |        |      | 0x03 | Subscription (period ticket)     |
-    // |        |      | 0x3f | ???                              |
-    // |        |      +-----------------------------------------+
-    // | 10     | 2    | Subscription end date (record type 3)   |
-    // +=========================================================+
-    if (bytes.size() >= 96) {
-        const uchar* data = (const uchar*) bytes.constData();
-        const uint id1 = data[0];
-        const uint id2 = data[48];
-        const uint off = (id1 > id2 && (id1 - id2) <= 128) ? 0 : 48;
-        const uchar* block = data + off;
-        bool valid = false;
-
-        HDEBUG("Block ids" << hex << id1 << "and" << id2 << "using the" <<
-            (off ? "second" : "first") << "one");
-
-        if (block[6] == 3) {
-            const QDateTime endDate(NysseUtil::toDateTime(Util::uint16be(block + 10)));
-            HDEBUG("  EndDate =" << endDate);
-            if (iEndDate != endDate) {
-                iEndDate = endDate;
-                queueSignal(SignalEndDateChanged);
-            }
-            valid = true;
-        }
-
-        HDEBUG("  Valid =" << valid);
-        if (iValid != valid) {
-            iValid = valid;
-            queueSignal(SignalValidChanged);
-        }
+    decode(QByteArray::fromHex(aHexData.toLatin1()), &iInfo);
+    if (prev.iEndDate != iInfo.iEndDate) {
+        queueSignal(SignalEndDateChanged);
+    }
+    if (prev.iValid != iInfo.iValid) {
+        queueSignal(SignalValidChanged);
     }
 
     updateDaysRemaining();
@@ -242,17 +212,18 @@ NysseCardTicketInfo::Private::scheduleRefreshDaysRemaining()
     const QDate today = now.date();
     const QDateTime nextMidnight(today.addDays(1), QTime(0,0), Util::FINLAND_TIMEZONE);
     HDEBUG(now.toString("dd.MM.yyyy hh:mm:ss") << now.secsTo(nextMidnight) << "sec until midnight");
-    QTimer::singleShot(now.msecsTo(nextMidnight) + 1000, this, SLOT(refreshDaysRemaining()));
+    // Restarting the timer cancels the previously scheduled refresh
+    iRefreshTimer->start(now.msecsTo(nextMidnight) + 1000);
 }
 
 void
 NysseCardTicketInfo::Private::updateDaysRemaining()
 {
     const int prevDaysRemaining = iDaysRemaining;
-    if (iValid) {
+    if (iInfo.iValid) {
         const QDateTime now = QDateTime::currentDateTime();
         const QDate today = now.date();
-        const QDate lastDay(iEndDate.date());
+        const QDate lastDay(iInfo.iEndDate.date());
         if (today > lastDay) {
             iDaysRemaining = TravelCard::PeriodEnded;
         } else {
@@ -282,6 +253,48 @@ NysseCardTicketInfo::~NysseCardTicketInfo()
     delete iPrivate;
 }
 
+void
+NysseCardTicketInfo::decode(
+    const QByteArray& aBytes,
+    Info* aInfo)
+{
+    // Season pass info contains two 48 bytes blocks.
+    // Block layout:
+    //
+    // +=========================================================+
+    // | Offset | Size | Description                             |
+    // +=========================================================+
+    // | 0      | 1    | Block id                                |
+    // | 1      | 5    | ??? (usually 0f 03 00 00 00)            |
+    // | 6      | 1    | Record type?                            |
+    // |        |      +-----------------------------------------+
+    // |        |      | 0x00 | Empty record                     |
+    // |        |      | 0x03 | Subscription (period ticket)     |
+    // |        |      | 0x3f | ???                              |
+    // |        |      +-----------------------------------------+
+    // | 10     | 2    | Subscription end date (record type 3)   |
+    // +=========================================================+
+    aInfo->iValid = false;
+    aInfo->iEndDate = QDateTime();
+    if (aBytes.size() >= 96) {
+        const uchar* data = (const uchar*) aBytes.constData();
+        const uint id1 = data[0];
+        const uint id2 = data[48];
+        const uint off = (id1 > id2 && (id1 - id2) <= 128) ? 0 : 48;
+        const uchar* block = data + off;
+
+        HDEBUG("Block ids" << hex << id1 << "and" << id2 << "using the" <<
+            (off ? "second" : "first") << "one");
+
+        if (block[6] == 3) {
+            aInfo->iEndDate = NysseUtil::toDateTime(Util::uint16be(block + 10));
+            aInfo->iValid = true;
+            HDEBUG("  EndDate =" << aInfo->iEndDate);
+        }
+        HDEBUG("  Valid =" << aInfo->iValid);
+    }
+}
+
 const QString
 NysseCardTicketInfo::data() const
 {
@@ -292,6 +305,9 @@ void
 NysseCardTicketInfo::setData(
     const QString aData)
 {
+    TRACE_SCOPE("NysseCardTicketInfo::setData");
+    ALLOC_STATS_SCOPE(Parse);
+
     const QString data(aData.toLower());
     if (iPrivate->iHexData != data) {
         iPrivate->updateHexData(data);
@@ -303,7 +319,7 @@ NysseCardTicketInfo::setData(
 bool
 NysseCardTicketInfo::valid() const
 {
-    return iPrivate->iValid;
+    return iPrivate->iInfo.iValid;
 }
 
 int
@@ -315,7 +331,7 @@ NysseCardTicketInfo::daysRemaining() const
 QDateTime
 NysseCardTicketInfo::endDate() const
 {
-    return iPrivate->iEndDate;
+    return iPrivate->iInfo.iEndDate;
 }
 
 #include "NysseCardTicketInfo.moc"
@@ -55,9 +55,19 @@ class NysseCardTicketInfo :
     Q_PROPERTY(QDateTime endDate READ endDate NOTIFY endDateChanged)
 
 public:
+    // Decoded season ticket, for C++ code which doesn't need a QObject.
+    // The number of days remaining depends on the current date, that's
+    // not included.
+    struct Info {
+        bool iValid;
+        QDateTime iEndDate;
+    };
+
     NysseCardTicketInfo(QObject* aParent = Q_NULLPTR);
     ~NysseCardTicketInfo();
 
+    static void decode(const QByteArray&, Info*);
+
     const QString data() const;
     void setData(const QString);
 
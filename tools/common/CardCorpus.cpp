@@ -0,0 +1,175 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "CardCorpus.h"
+
+#include "TravelCardDump.h"
+#include "Util.h"
+
+#include "HarbourDebug.h"
+
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+
+#include <algorithm>
+
+#ifndef CARD_CORPUS_DIR
+#  define CARD_CORPUS_DIR "corpus"
+#endif
+
+static
+bool
+card_corpus_dump_less(
+    const CardCorpus::Dump& aDump1,
+    const CardCorpus::Dump& aDump2)
+{
+    return aDump1.iName < aDump2.iName;
+}
+
+static
+bool
+card_corpus_load_binary(
+    const QFileInfo& aFile,
+    QList<CardCorpus::Dump>* aDumps)
+{
+    QList<TravelCardDump> dumps;
+
+    if (TravelCardDump::load(aFile.filePath(), &dumps)) {
+        for (int i = 0; i < dumps.count(); i++) {
+            CardCorpus::Dump dump;
+
+            dump.iName = aFile.completeBaseName();
+            if (dumps.count() > 1) {
+                dump.iName += QString::asprintf("#%d", i + 1);
+            }
+            dump.iCardInfo = dumps.at(i).cardInfo();
+            dump.iCardType = dumps.at(i).iCardType;
+            aDumps->append(dump);
+        }
+        return true;
+    } else {
+        HWARN("Failed to load" << qPrintable(aFile.filePath()));
+        return false;
+    }
+}
+
+static
+bool
+card_corpus_load_file(
+    const QFileInfo& aFile,
+    QList<CardCorpus::Dump>* aDumps)
+{
+    if (aFile.suffix() == QLatin1String(TravelCardDump::SUFFIX + 1)) {
+        return card_corpus_load_binary(aFile, aDumps);
+    }
+
+    QFile f(aFile.filePath());
+
+    if (f.open(QIODevice::ReadOnly)) {
+        QJsonParseError error;
+        const QJsonDocument doc(QJsonDocument::fromJson(f.readAll(), &error));
+
+        if (doc.isObject()) {
+            CardCorpus::Dump dump;
+
+            dump.iName = aFile.completeBaseName();
+            dump.iCardInfo = doc.object().toVariantMap();
+            dump.iCardType = dump.iCardInfo.value(Util::CARD_TYPE_KEY).
+                toString();
+            aDumps->append(dump);
+            return true;
+        } else {
+            HWARN(qPrintable(aFile.filePath()) << error.errorString());
+        }
+    } else {
+        HWARN("Can't open" << qPrintable(aFile.filePath()));
+    }
+    return false;
+}
+
+bool
+CardCorpus::load(
+    const QString& aPath,
+    QList<Dump>* aDumps)
+{
+    const QFileInfo info(aPath);
+
+    if (info.isDir()) {
+        const QFileInfoList files(QDir(aPath).entryInfoList(QStringList() <<
+            QStringLiteral("*.json") <<
+            (QLatin1Char('*') + QLatin1String(TravelCardDump::SUFFIX)),
+            QDir::Files | QDir::Readable));
+        QList<Dump> dumps;
+        bool ok = true;
+
+        for (int i = 0; i < files.count(); i++) {
+            if (!card_corpus_load_file(files.at(i), &dumps)) {
+                ok = false;
+            }
+        }
+        std::sort(dumps.begin(), dumps.end(), card_corpus_dump_less);
+        aDumps->append(dumps);
+        return ok;
+    } else {
+        return card_corpus_load_file(info, aDumps);
+    }
+}
+
+bool
+CardCorpus::load(
+    const QStringList& aPaths,
+    QList<Dump>* aDumps)
+{
+    bool ok = true;
+
+    for (int i = 0; i < aPaths.count(); i++) {
+        if (!load(aPaths.at(i), aDumps)) {
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+QString
+CardCorpus::defaultPath()
+{
+    return QString::fromLocal8Bit(CARD_CORPUS_DIR);
+}
@@ -0,0 +1,337 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "CardDecoder.h"
+#include "CardParsers.h"
+
+#include "Util.h"
+
+#include <QtCore/QAbstractItemModel>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QMetaProperty>
+#include <QtCore/QStringList>
+#include <QtCore/QTextStream>
+#include <QtCore/QVector>
+
+// ==========================================================================
+// Helpers
+// ==========================================================================
+
+static
+QVariant
+card_decoder_value(
+    const QVariant& aValue)
+{
+    const int type = aValue.userType();
+
+    if (type == QMetaType::QDateTime) {
+        const QDateTime t(aValue.toDateTime());
+
+        // Include UTC offset, the timezone matters
+        return t.isValid() ? t.toOffsetFromUtc(t.offsetFromUtc()).
+            toString(Qt::ISODate) : QString();
+    } else if (type == QMetaType::QDate) {
+        return aValue.toDate().toString(Qt::ISODate);
+    } else if (QMetaType::typeFlags(type) & QMetaType::IsGadget) {
+        const QMetaObject* mo = QMetaType::metaObjectForType(type);
+        QVariantMap map;
+
+        for (int i = mo->propertyOffset(); i < mo->propertyCount(); i++) {
+            const QMetaProperty p(mo->property(i));
+
+            map.insert(p.name(), card_decoder_value(p.readOnGadget(aValue.
+                constData())));
+        }
+        return map;
+    } else if (QMetaType::typeFlags(type) & QMetaType::IsEnumeration) {
+        return aValue.toInt();
+    } else {
+        return aValue;
+    }
+}
+
+static
+QVariant
+card_decoder_plain_value(
+    const QVariant& aValue)
+{
+    const int type = aValue.userType();
+
+    if (type == QMetaType::QVariantMap) {
+        const QVariantMap map(aValue.toMap());
+        QVariantMap out;
+
+        for (QVariantMap::ConstIterator it = map.constBegin();
+             it != map.constEnd(); ++it) {
+            out.insert(it.key(), card_decoder_plain_value(it.value()));
+        }
+        return out;
+    } else if (type == QMetaType::QVariantList) {
+        const QVariantList list(aValue.toList());
+        QVariantList out;
+
+        for (int i = 0; i < list.count(); i++) {
+            out.append(card_decoder_plain_value(list.at(i)));
+        }
+        return out;
+    } else {
+        return card_decoder_value(aValue);
+    }
+}
+
+static
+QVariant
+card_decoder_properties(
+    const QObject* aObject)
+{
+    const QMetaObject* mo = aObject->metaObject();
+    QVariantMap map;
+
+    // Writable properties (data, cardNumber etc.) are inputs
+    for (int i = QObject::staticMetaObject.propertyCount();
+         i < mo->propertyCount(); i++) {
+        const QMetaProperty p(mo->property(i));
+
+        if (!p.isWritable()) {
+            const QVariant value(p.read(aObject));
+
+            if (p.isEnumType()) {
+                const char* key = p.enumerator().valueToKey(value.toInt());
+
+                map.insert(p.name(), key ? QVariant(QString::fromLatin1(key)) :
+                    QVariant(value.toInt()));
+            } else {
+                map.insert(p.name(), card_decoder_value(value));
+            }
+        }
+    }
+    return map;
+}
+
+static
+QVariant
+card_decoder_rows(
+    QAbstractItemModel* aModel)
+{
+    const QHash<int,QByteArray> roles(aModel->roleNames());
+    QVariantList rows;
+
+    while (aModel->canFetchMore(QModelIndex())) {
+        aModel->fetchMore(QModelIndex());
+    }
+    for (int row = 0; row < aModel->rowCount(QModelIndex()); row++) {
+        const QModelIndex index(aModel->index(row, 0));
+        QHashIterator<int,QByteArray> it(roles);
+        QVariantMap map;
+
+        while (it.hasNext()) {
+            it.next();
+            map.insert(QString::fromLatin1(it.value()),
+                card_decoder_value(aModel->data(index, it.key())));
+        }
+        rows.append(map);
+    }
+    return rows;
+}
+
+static
+void
+card_decoder_flatten(
+    const QString& aPrefix,
+    const QVariant& aValue,
+    QStringList* aKeys,
+    QStringList* aValues)
+{
+    const int type = aValue.userType();
+
+    if (type == QMetaType::QVariantMap) {
+        const QVariantMap map(aValue.toMap());
+
+        for (QVariantMap::ConstIterator it = map.constBegin();
+             it != map.constEnd(); ++it) {
+            card_decoder_flatten(aPrefix + QLatin1Char('.') + it.key(),
+                it.value(), aKeys, aValues);
+        }
+    } else if (type == QMetaType::QVariantList) {
+        const QVariantList list(aValue.toList());
+
+        for (int i = 0; i < list.count(); i++) {
+            card_decoder_flatten(aPrefix + QLatin1Char('.') +
+                QString::number(i), list.at(i), aKeys, aValues);
+        }
+    } else {
+        aKeys->append(aPrefix);
+        aValues->append(aValue.toString());
+    }
+}
+
+// ==========================================================================
+// CardDecoder::Private
+// ==========================================================================
+
+class CardDecoder::Private
+{
+public:
+    Private();
+    ~Private();
+
+public:
+    QVector<QObject*> iParsers;
+};
+
+CardDecoder::Private::Private() :
+    iParsers(CardParsers::COUNT, Q_NULLPTR)
+{
+}
+
+CardDecoder::Private::~Private()
+{
+    qDeleteAll(iParsers);
+}
+
+// ==========================================================================
+// CardDecoder
+// ==========================================================================
+
+CardDecoder::CardDecoder() :
+    iPrivate(new Private)
+{
+}
+
+CardDecoder::~CardDecoder()
+{
+    delete iPrivate;
+}
+
+QVariantMap
+CardDecoder::decode(
+    const QVariantMap& aCardInfo,
+    qint64* aDecodeNanoseconds)
+{
+    const QString cardType(aCardInfo.value(Util::CARD_TYPE_KEY).toString());
+    QVariantMap decoded;
+    qint64 ns = 0;
+
+    for (int i = 0; i < CardParsers::COUNT; i++) {
+        const CardParsers::Parser* parser = CardParsers::ALL + i;
+
+        if (*parser->iCardType == cardType) {
+            QObject* obj = iPrivate->iParsers[i];
+            const QString data(aCardInfo.value(QLatin1String(parser->iKey)).
+                toString());
+            QElapsedTimer timer;
+
+            if (!obj) {
+                obj = iPrivate->iParsers[i] = parser->iNew();
+            }
+
+            QAbstractItemModel* model = qobject_cast<QAbstractItemModel*>(obj);
+
+            timer.start();
+            CardParsers::setData(obj, data);
+            ns += timer.nsecsElapsed();
+            decoded.insert(QString::fromLatin1(parser->iName), model ?
+                card_decoder_rows(model) : card_decoder_properties(obj));
+        }
+    }
+    if (aDecodeNanoseconds) {
+        *aDecodeNanoseconds = ns;
+    }
+    return decoded;
+}
+
+QVariantMap
+CardDecoder::decodePlain(
+    const QVariantMap& aCardInfo)
+{
+    const QString cardType(aCardInfo.value(Util::CARD_TYPE_KEY).toString());
+    QVariantMap decoded;
+
+    for (int i = 0; i < CardParsers::COUNT; i++) {
+        const CardParsers::Parser* parser = CardParsers::ALL + i;
+
+        if (*parser->iCardType == cardType) {
+            const QString data(aCardInfo.value(QLatin1String(parser->iKey)).
+                toString());
+
+            decoded.insert(QString::fromLatin1(parser->iName),
+                card_decoder_plain_value(parser->iDecode(QByteArray::
+                fromHex(data.toLatin1()))));
+        }
+    }
+    return decoded;
+}
+
+void
+CardDecoder::flatten(
+    const QVariantMap& aDecoded,
+    QStringList* aKeys,
+    QStringList* aValues)
+{
+    for (QVariantMap::ConstIterator it = aDecoded.constBegin();
+         it != aDecoded.constEnd(); ++it) {
+        card_decoder_flatten(it.key(), it.value(), aKeys, aValues);
+    }
+}
+
+QString
+CardDecoder::toText(
+    const QVariantMap& aDecoded)
+{
+    QStringList keys, values;
+    QString text;
+    QTextStream out(&text);
+
+    flatten(aDecoded, &keys, &values);
+    for (int i = 0; i < keys.count(); i++) {
+        out << keys.at(i) << " = " << values.at(i) << '\n';
+    }
+    out.flush();
+    return text;
+}
+
+QByteArray
+CardDecoder::toJson(
+    const QVariantMap& aDecoded,
+    bool aCompact)
+{
+    return QJsonDocument(QJsonObject::fromVariantMap(aDecoded)).
+        toJson(aCompact ? QJsonDocument::Compact : QJsonDocument::Indented);
+}
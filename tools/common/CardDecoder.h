@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#ifndef CARD_DECODER_H
+#define CARD_DECODER_H
+
+#include <QtCore/QStringList>
+#include <QtCore/QVariantMap>
+
+// Runs the card info through all the parsers which the card page
+// would use and collects their output. The result maps parser class
+// names to either a map of read-only properties or, for the models,
+// a list of rows (each row mapping role names to values). Dates are
+// converted to ISO 8601 strings and gadgets (e.g. HslArea) to maps,
+// so that the result can be converted to JSON as is.
+//
+// Parser objects are created on demand and reused for subsequent
+// cards, the same way as the card page reuses them on a re-tap. The
+// decoder (and the parsers) belong to the thread which created it.
+// Worker threads should rather use decodePlain() which doesn't create
+// any objects (see CardParsers for what's different in its output).
+class CardDecoder
+{
+    Q_DISABLE_COPY(CardDecoder)
+
+public:
+    CardDecoder();
+    ~CardDecoder();
+
+    QVariantMap decode(const QVariantMap& aCardInfo,
+        qint64* aDecodeNanoseconds = Q_NULLPTR);
+    static QVariantMap decodePlain(const QVariantMap& aCardInfo);
+
+    // Flat list of "parser.property" keys and the values (as strings)
+    static void flatten(const QVariantMap& aDecoded, QStringList* aKeys,
+        QStringList* aValues);
+
+    // One "parser.property = value" line per value, sorted
+    static QString toText(const QVariantMap& aDecoded);
+    static QByteArray toJson(const QVariantMap& aDecoded, bool aCompact);
+
+private:
+    class Private;
+    Private* iPrivate;
+};
+
+#endif // CARD_DECODER_H
@@ -0,0 +1,302 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "CardParsers.h"
+
+#include "hsl/HslCard.h"
+#include "hsl/HslCardAppInfo.h"
+#include "hsl/HslCardEticket.h"
+#include "hsl/HslCardHistory.h"
+#include "hsl/HslCardPeriodPass.h"
+#include "hsl/HslCardStoredValue.h"
+#include "hsl/HslData.h"
+
+#include "nysse/NysseCard.h"
+#include "nysse/NysseCardAppInfo.h"
+#include "nysse/NysseCardBalance.h"
+#include "nysse/NysseCardHistory.h"
+#include "nysse/NysseCardOwnerInfo.h"
+#include "nysse/NysseCardTicketInfo.h"
+
+#include <QtCore/QMetaEnum>
+
+template <class T>
+static
+QObject*
+card_parser_new()
+{
+    return new T;
+}
+
+static
+QVariant
+card_parser_enum_key(
+    const char* aEnum,
+    int aValue)
+{
+    // Same as the property would be printed
+    const QMetaObject* mo = &HslData::staticMetaObject;
+    const QMetaEnum e(mo->enumerator(mo->indexOfEnumerator(aEnum)));
+    const char* key = e.valueToKey(aValue);
+
+    return key ? QVariant(QString::fromLatin1(key)) : QVariant(aValue);
+}
+
+static
+QVariant
+card_parser_hsl_app_info(
+    const QByteArray& aData)
+{
+    HslCardAppInfo::Info info;
+    QVariantMap map;
+
+    HslCardAppInfo::decode(aData, &info);
+    map.insert("appVersion", info.iAppVersion);
+    map.insert("cardNumber", info.iCardNumber);
+    return map;
+}
+
+static
+QVariant
+card_parser_hsl_eticket(
+    const QByteArray& aData)
+{
+    HslCardEticket::Info info;
+    QVariantMap map;
+
+    HslCardEticket::decode(aData, &info);
+    map.insert("language", card_parser_enum_key("Language", info.iLanguage));
+    map.insert("validityLengthType", card_parser_enum_key("ValidityLengthType",
+        info.iValidityLengthType));
+    map.insert("validityLength", info.iValidityLength);
+    map.insert("validityArea", QVariant::fromValue(info.iValidityArea));
+    map.insert("validityAreaName", info.iValidityArea.name());
+    map.insert("ticketPrice", info.iTicketPrice);
+    map.insert("groupSize", info.iGroupSize);
+    map.insert("extraZone", info.iExtraZone);
+    map.insert("extensionFare", info.iExtensionFare);
+    map.insert("validityStartTime", info.iValidityStartTime);
+    map.insert("validityEndTime", info.iValidityEndTime);
+    map.insert("validityEndTimeGroup", info.iValidityEndTimeGroup);
+    map.insert("boardingTime", info.iBoardingTime);
+    map.insert("boardingVehicle", info.iBoardingVehicle);
+    map.insert("boardingArea", QVariant::fromValue(info.iBoardingArea));
+    map.insert("boardingAreaName", info.iBoardingArea.name());
+    return map;
+}
+
+static
+QVariant
+card_parser_hsl_period_pass(
+    const QByteArray& aData)
+{
+    HslCardPeriodPass::Info info;
+    QVariantMap map;
+
+    HslCardPeriodPass::decode(aData, &info);
+    map.insert("validityArea1", QVariant::fromValue(info.iValidityArea1));
+    map.insert("validityAreaName1", info.iValidityArea1.name());
+    map.insert("periodStartDate1", info.iPeriodStartDate1);
+    map.insert("periodEndDate1", info.iPeriodEndDate1);
+    map.insert("validityArea2", QVariant::fromValue(info.iValidityArea2));
+    map.insert("validityAreaName2", info.iValidityArea2.name());
+    map.insert("periodStartDate2", info.iPeriodStartDate2);
+    map.insert("periodEndDate2", info.iPeriodEndDate2);
+    map.insert("lastLoadingTime", info.iLastLoadingTime);
+    map.insert("latestPeriodPrice", info.iLatestPeriodPrice);
+    return map;
+}
+
+static
+QVariant
+card_parser_hsl_stored_value(
+    const QByteArray& aData)
+{
+    HslCardStoredValue::Info info;
+    QVariantMap map;
+
+    HslCardStoredValue::decode(aData, &info);
+    map.insert("moneyValue", info.iMoneyValue);
+    map.insert("loadedValue", info.iLoadedValue);
+    map.insert("loadingTime", info.iLoadingTime);
+    return map;
+}
+
+static
+QVariant
+card_parser_hsl_history(
+    const QByteArray& aData)
+{
+    const QList<HslCardHistory::Entry> entries(HslCardHistory::decode(aData));
+    QVariantList rows;
+
+    for (int i = 0; i < entries.count(); i++) {
+        rows.append(HslCardHistory::roleValues(entries.at(i)));
+    }
+    return rows;
+}
+
+static
+QVariant
+card_parser_nysse_app_info(
+    const QByteArray& aData)
+{
+    NysseCardAppInfo::Info info;
+    QVariantMap map;
+
+    NysseCardAppInfo::decode(aData, &info);
+    map.insert("cardNumber", info.iCardNumber);
+    return map;
+}
+
+static
+QVariant
+card_parser_nysse_balance(
+    const QByteArray& aData)
+{
+    NysseCardBalance::Info info;
+    QVariantMap map;
+
+    NysseCardBalance::decode(aData, &info);
+    map.insert("valid", info.iValid);
+    map.insert("balance", info.iBalance);
+    return map;
+}
+
+static
+QVariant
+card_parser_nysse_history(
+    const QByteArray& aData)
+{
+    const QList<NysseCardHistory::Entry> entries(NysseCardHistory::decode(aData));
+    QVariantList rows;
+
+    for (int i = 0; i < entries.count(); i++) {
+        rows.append(NysseCardHistory::roleValues(entries.at(i)));
+    }
+    return rows;
+}
+
+static
+QVariant
+card_parser_nysse_owner_info(
+    const QByteArray& aData)
+{
+    NysseCardOwnerInfo::Info info;
+    QVariantMap map;
+
+    NysseCardOwnerInfo::decode(aData, &info);
+    map.insert("ownerName", info.iOwnerName);
+    map.insert("birthDate", info.iBirthDate);
+    map.insert("issueDate", info.iIssueDate);
+    return map;
+}
+
+static
+QVariant
+card_parser_nysse_ticket_info(
+    const QByteArray& aData)
+{
+    NysseCardTicketInfo::Info info;
+    QVariantMap map;
+
+    NysseCardTicketInfo::decode(aData, &info);
+    map.insert("valid", info.iValid);
+    map.insert("endDate", info.iEndDate);
+    return map;
+}
+
+#define HSL_PARSER(T,key,size,decode) \
+    { #T, &HslCard::Desc.iName, key, size, card_parser_new<T>, decode }
+#define NYSSE_PARSER(T,key,size,decode) \
+    { #T, &NysseCard::Desc.iName, key, size, card_parser_new<T>, decode }
+
+const CardParsers::Parser CardParsers::ALL[] = {
+    HSL_PARSER(HslCardAppInfo, "appInfo", 0,
+        card_parser_hsl_app_info),
+    HSL_PARSER(HslCardEticket, "eTicket", 0,
+        card_parser_hsl_eticket),
+    HSL_PARSER(HslCardPeriodPass, "periodPass", 0,
+        card_parser_hsl_period_pass),
+    HSL_PARSER(HslCardStoredValue, "storedValue", 0,
+        card_parser_hsl_stored_value),
+    HSL_PARSER(HslCardHistory, "history", 12,
+        card_parser_hsl_history),
+    NYSSE_PARSER(NysseCardAppInfo, "appInfoData", 0,
+        card_parser_nysse_app_info),
+    NYSSE_PARSER(NysseCardBalance, "balanceData", 0,
+        card_parser_nysse_balance),
+    NYSSE_PARSER(NysseCardHistory, "historyData", 16,
+        card_parser_nysse_history),
+    NYSSE_PARSER(NysseCardOwnerInfo, "ownerInfoData", 0,
+        card_parser_nysse_owner_info),
+    NYSSE_PARSER(NysseCardTicketInfo, "ticketInfoData", 0,
+        card_parser_nysse_ticket_info)
+};
+
+const int CardParsers::COUNT = sizeof(ALL)/sizeof(ALL[0]);
+
+QString
+CardParsers::data(
+    const Parser* aParser,
+    const CardCorpus::Dump& aDump)
+{
+    return (aDump.iCardType == *aParser->iCardType) ?
+        aDump.iCardInfo.value(QLatin1String(aParser->iKey)).toString() :
+        QString();
+}
+
+int
+CardParsers::recordCount(
+    const Parser* aParser,
+    const QString& aHexData)
+{
+    // Two hex digits per byte
+    return aParser->iRecordSize ?
+        (aHexData.length() / (2 * aParser->iRecordSize)) :
+        aHexData.isEmpty() ? 0 : 1;
+}
+
+void
+CardParsers::setData(
+    QObject* aParser,
+    const QString& aHexData)
+{
+    // Same thing as QML is doing
+    aParser->setProperty("data", aHexData);
+}
@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#ifndef CARD_PARSERS_H
+#define CARD_PARSERS_H
+
+#include "CardCorpus.h"
+
+#include <QtCore/QObject>
+
+// The parsers which the card pages are instantiating, along with the
+// card info keys which they are getting their data from.
+//
+// Each parser can also be run without creating a QObject, which is
+// what the batch mode does on its worker threads. The plain decoder
+// returns the same thing as reading the object would (a map of the
+// read-only properties or, for the models, a list of rows), except
+// for the values which depend on the current time: the number of
+// seconds/days remaining is omitted and HslCardPeriodPass lists the
+// periods the way they are stored on the card, with no attempt to
+// figure out which one is current.
+class CardParsers
+{
+public:
+    struct Parser {
+        const char* iName;          // Class name
+        const QString* iCardType;   // Desc.iName of the card driver
+        const char* iKey;           // Card info key
+        int iRecordSize;            // Zero if the whole block is a record
+        QObject* (*iNew)();
+        QVariant (*iDecode)(const QByteArray&);
+    };
+
+    static const Parser ALL[];
+    static const int COUNT;
+
+    // Hex data which this parser would receive from the page,
+    // empty string if the dump is for a different card type.
+    static QString data(const Parser*, const CardCorpus::Dump&);
+    static int recordCount(const Parser*, const QString& aHexData);
+    static void setData(QObject*, const QString&);
+};
+
+#endif // CARD_PARSERS_H
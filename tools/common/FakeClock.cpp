@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "FakeClock.h"
+
+#include <dlfcn.h>
+#include <sys/time.h>
+#include <time.h>
+
+static volatile bool fake_clock_enabled = false;
+static qint64 fake_clock_msec = 0;
+
+typedef int (*FakeClockGetTimeFunc)(clockid_t, struct timespec*);
+
+static
+int
+fake_clock_real_gettime(
+    clockid_t aClock,
+    struct timespec* aTime)
+{
+    static FakeClockGetTimeFunc real = Q_NULLPTR;
+
+    if (!real) {
+        real = (FakeClockGetTimeFunc)dlsym(RTLD_NEXT, "clock_gettime");
+    }
+    return real(aClock, aTime);
+}
+
+extern "C" {
+
+int
+clock_gettime(
+    clockid_t aClock,
+    struct timespec* aTime) __THROW
+{
+    if (fake_clock_enabled && (aClock == CLOCK_REALTIME ||
+        aClock == CLOCK_REALTIME_COARSE)) {
+        aTime->tv_sec = fake_clock_msec / 1000;
+        aTime->tv_nsec = (fake_clock_msec % 1000) * 1000000;
+        return 0;
+    }
+    return fake_clock_real_gettime(aClock, aTime);
+}
+
+// QDateTime::currentMSecsSinceEpoch() calls gettimeofday(), which has
+// to be declared exactly like in <sys/time.h>. The second parameter used
+// to be struct timezone* (__timezone_ptr_t), glibc 2.31 made it void*.
+#if defined(__GLIBC__) && (__GLIBC__ == 2) && (__GLIBC_MINOR__ < 31)
+typedef __timezone_ptr_t FakeClockTimezone;
+#else
+typedef void* FakeClockTimezone;
+#endif
+
+int
+gettimeofday(
+    struct timeval* __restrict aTime,
+    FakeClockTimezone) __THROW
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_REALTIME, &ts);
+    aTime->tv_sec = ts.tv_sec;
+    aTime->tv_usec = ts.tv_nsec / 1000;
+    return 0;
+}
+
+time_t
+time(
+    time_t* aTime) __THROW
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_REALTIME, &ts);
+    if (aTime) {
+        *aTime = ts.tv_sec;
+    }
+    return ts.tv_sec;
+}
+
+} // extern "C"
+
+void
+FakeClock::set(
+    const QDateTime& aTime)
+{
+    if (aTime.isValid()) {
+        fake_clock_msec = aTime.toMSecsSinceEpoch();
+        fake_clock_enabled = true;
+    } else {
+        fake_clock_enabled = false;
+    }
+}
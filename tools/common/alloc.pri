@@ -0,0 +1,11 @@
+# Replaces malloc() and friends with the counting versions. Only
+# makes sense for the tools which are measuring allocations. With
+# CONFIG+=alloc_stats the counter is already there (see core.pri)
+
+!alloc_stats {
+    HEADERS += \
+        $${PWD}/../../src/AllocCounter.h
+
+    SOURCES += \
+        $${PWD}/../../src/AllocCounter.cpp
+}
@@ -0,0 +1,11 @@
+# Replaces the wall clock functions with the ones returning fixed
+# time, to make time-dependent output reproducible.
+
+INCLUDEPATH += \
+    $${PWD}
+
+HEADERS += \
+    $${PWD}/FakeClock.h
+
+SOURCES += \
+    $${PWD}/FakeClock.cpp
@@ -0,0 +1,18 @@
+# Corpus loading, the parser table and the decoder shared by the
+# benchmark, the golden output harness and the command line tool
+
+INCLUDEPATH += \
+    $${PWD}
+
+HEADERS += \
+    $${PWD}/CardCorpus.h \
+    $${PWD}/CardDecoder.h \
+    $${PWD}/CardParsers.h
+
+SOURCES += \
+    $${PWD}/CardCorpus.cpp \
+    $${PWD}/CardDecoder.cpp \
+    $${PWD}/CardParsers.cpp
+
+# Default location of the corpus
+DEFINES += CARD_CORPUS_DIR=\\\"$${PWD}/../corpus\\\"
@@ -0,0 +1,648 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "FakeNfcd.h"
+
+#include "HarbourDebug.h"
+
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+
+#include <gio/gio.h>
+
+#include <string.h>
+
+// Values of the properties which libgnfcdc is interested in are
+// derived from the names of the output arguments, the names being
+// compared case-insensitively and ignoring underscores, e.g. both
+// "target_present" and "TargetPresent" match "targetpresent".
+// Anything unknown gets a zero/empty value of the right type.
+
+// ==========================================================================
+// FakeNfcd::Private
+// ==========================================================================
+
+class FakeNfcd::Private
+{
+public:
+    enum Kind {
+        Daemon,
+        Adapter,
+        Tag,
+        IsoDep,
+        KindCount
+    };
+
+    // As defined by nfcd
+    enum {
+        NFC_TECHNOLOGY_A = 0x01,
+        NFC_PROTOCOL_T4A_TAG = 0x08,
+        NFC_MODE_READER_WRITER = 0x02
+    };
+
+    struct Object {
+        Private* iPrivate;
+        Kind iKind;
+        GDBusInterfaceInfo* iInterface;
+        guint iRegId;
+    };
+
+    struct Transmit {
+        Private* iPrivate;
+        GDBusMethodInvocation* iInvocation;
+        const GDBusMethodInfo* iMethod;
+    };
+
+    static const char* const INTERFACE[KindCount];
+    static const char* const OBJECT_PATH[KindCount];
+    static const char ERROR_FAILED[];
+    static const GDBusInterfaceVTable VTABLE;
+
+    Private(const TravelCardEmulator::Config&, const QString&);
+    ~Private();
+
+    static QByteArray normalize(const char*);
+    static GVariant* defaultValue(const GVariantType*);
+    static int interfaceVersion(const GDBusInterfaceInfo*);
+    static const GDBusArgInfo* findArg(GDBusArgInfo**, const char*);
+
+    GVariant* value(const Object*, const GDBusArgInfo*) const;
+    GVariant* tuple(const Object*, GDBusArgInfo**) const;
+    bool registerObject(Kind);
+    void unregisterObject(Kind);
+    void emitSignal(Kind, const char*);
+    void transmit(GDBusMethodInvocation*, GVariant*, const GDBusMethodInfo*);
+
+    static void methodCall(GDBusConnection*, const gchar*, const gchar*,
+        const gchar*, const gchar*, GVariant*, GDBusMethodInvocation*,
+        gpointer);
+    static void transmitResp(NfcIsoDepClient*, const GUtilData*, guint,
+        const GError*, void*);
+    static void transmitFree(gpointer);
+    static void nameAcquired(GDBusConnection*, const gchar*, gpointer);
+    static void nameLost(GDBusConnection*, const gchar*, gpointer);
+
+public:
+    const TravelCardEmulator::Config iConfig;
+    TravelCardEmulator* iCard;
+    GDBusConnection* iBus;
+    GDBusNodeInfo* iNode[KindCount];
+    Object iObject[KindCount];
+    guint iOwnId;
+    void (*iReady)(void*);
+    void (*iLost)(void*);
+    void* iUserData;
+};
+
+const char* const FakeNfcd::Private::INTERFACE[] = {
+    "org.sailfishos.nfc.Daemon",
+    "org.sailfishos.nfc.Adapter",
+    "org.sailfishos.nfc.Tag",
+    "org.sailfishos.nfc.IsoDep"
+};
+
+const char* const FakeNfcd::Private::OBJECT_PATH[] = {
+    "/",
+    FakeNfcd::ADAPTER_PATH,
+    FakeNfcd::TAG_PATH,
+    FakeNfcd::TAG_PATH
+};
+
+const char FakeNfcd::Private::ERROR_FAILED[] = "org.sailfishos.nfc.Error.Failed";
+
+const GDBusInterfaceVTable FakeNfcd::Private::VTABLE = {
+    FakeNfcd::Private::methodCall, Q_NULLPTR, Q_NULLPTR
+};
+
+FakeNfcd::Private::Private(
+    const TravelCardEmulator::Config& aConfig,
+    const QString& aSpecDir) :
+    iConfig(aConfig),
+    iCard(Q_NULLPTR),
+    iBus(Q_NULLPTR),
+    iOwnId(0),
+    iReady(Q_NULLPTR),
+    iLost(Q_NULLPTR),
+    iUserData(Q_NULLPTR)
+{
+    for (int i = 0; i < KindCount; i++) {
+        const QString file(aSpecDir + QDir::separator() +
+            QLatin1String(INTERFACE[i]) + QLatin1String(".xml"));
+        QFile f(file);
+        Object* obj = iObject + i;
+
+        obj->iPrivate = this;
+        obj->iKind = (Kind)i;
+        obj->iInterface = Q_NULLPTR;
+        obj->iRegId = 0;
+        iNode[i] = Q_NULLPTR;
+        if (f.open(QIODevice::ReadOnly)) {
+            GError* error = Q_NULLPTR;
+
+            iNode[i] = g_dbus_node_info_new_for_xml(f.readAll().constData(),
+                &error);
+            if (iNode[i]) {
+                obj->iInterface = g_dbus_node_info_lookup_interface(iNode[i],
+                    INTERFACE[i]);
+            } else {
+                HWARN(qPrintable(file) << error->message);
+                g_error_free(error);
+            }
+        } else {
+            HWARN("Can't open" << qPrintable(file));
+        }
+    }
+}
+
+FakeNfcd::Private::~Private()
+{
+    delete iCard;
+    if (iOwnId) {
+        g_bus_unown_name(iOwnId);
+    }
+    for (int i = 0; i < KindCount; i++) {
+        unregisterObject((Kind)i);
+        if (iNode[i]) {
+            g_dbus_node_info_unref(iNode[i]);
+        }
+    }
+    if (iBus) {
+        g_object_unref(iBus);
+    }
+}
+
+QByteArray
+FakeNfcd::Private::normalize(
+    const char* aName)
+{
+    QByteArray name;
+
+    for (const char* ptr = aName; *ptr; ptr++) {
+        if (*ptr != '_') {
+            name.append(g_ascii_tolower(*ptr));
+        }
+    }
+    return name;
+}
+
+GVariant*
+FakeNfcd::Private::defaultValue(
+    const GVariantType* aType)
+{
+    switch (g_variant_type_peek_string(aType)[0]) {
+    case 'b': return g_variant_new_boolean(FALSE);
+    case 'y': return g_variant_new_byte(0);
+    case 'n': return g_variant_new_int16(0);
+    case 'q': return g_variant_new_uint16(0);
+    case 'i': return g_variant_new_int32(0);
+    case 'u': return g_variant_new_uint32(0);
+    case 'x': return g_variant_new_int64(0);
+    case 't': return g_variant_new_uint64(0);
+    case 'h': return g_variant_new_handle(0);
+    case 'd': return g_variant_new_double(0);
+    case 's': return g_variant_new_string("");
+    case 'o': return g_variant_new_object_path("/");
+    case 'g': return g_variant_new_signature("");
+    case 'v': return g_variant_new_variant(g_variant_new_int32(0));
+    case 'a':
+        return g_variant_new_array(g_variant_type_element(aType), Q_NULLPTR, 0);
+    case '(':
+    case '{':
+        {
+            GPtrArray* items = g_ptr_array_new();
+            GVariant* value;
+
+            for (const GVariantType* t = g_variant_type_first(aType); t;
+                 t = g_variant_type_next(t)) {
+                g_ptr_array_add(items, defaultValue(t));
+            }
+            value = (g_variant_type_peek_string(aType)[0] == '(') ?
+                g_variant_new_tuple((GVariant**)items->pdata, items->len) :
+                g_variant_new_dict_entry((GVariant*)items->pdata[0],
+                    (GVariant*)items->pdata[1]);
+            g_ptr_array_free(items, TRUE);
+            return value;
+        }
+    }
+    return Q_NULLPTR;
+}
+
+int
+FakeNfcd::Private::interfaceVersion(
+    const GDBusInterfaceInfo* aInterface)
+{
+    // nfcd adds GetAllN method with every new version of an interface
+    int version = 1;
+
+    if (aInterface) {
+        for (GDBusMethodInfo** m = aInterface->methods; m && *m; m++) {
+            const char* name = (*m)->name;
+
+            if (g_str_has_prefix(name, "GetAll")) {
+                version = qMax(version, atoi(name + 6));
+            }
+        }
+    }
+    return version;
+}
+
+const GDBusArgInfo*
+FakeNfcd::Private::findArg(
+    GDBusArgInfo** aArgs,
+    const char* aName)
+{
+    for (GDBusArgInfo** arg = aArgs; arg && *arg; arg++) {
+        if (normalize((*arg)->name) == aName) {
+            return *arg;
+        }
+    }
+    return Q_NULLPTR;
+}
+
+GVariant*
+FakeNfcd::Private::value(
+    const Object* aObject,
+    const GDBusArgInfo* aArg) const
+{
+    const QByteArray name(normalize(aArg->name));
+    const char* sig = aArg->signature;
+    const Kind kind = aObject->iKind;
+
+    #define IS(n,s) (name == n && !strcmp(sig, s))
+    if (IS("version", "i")) {
+        return g_variant_new_int32(interfaceVersion(aObject->iInterface));
+    } else if (kind == Daemon && IS("adapters", "ao")) {
+        const char* adapters[] = { FakeNfcd::ADAPTER_PATH, Q_NULLPTR };
+
+        return g_variant_new_objv(adapters, -1);
+    } else if (kind == Adapter) {
+        if (IS("enabled", "b") || IS("powered", "b")) {
+            return g_variant_new_boolean(TRUE);
+        } else if (IS("targetpresent", "b")) {
+            return g_variant_new_boolean(iCard != Q_NULLPTR);
+        } else if (IS("mode", "u") || IS("supportedmodes", "u")) {
+            return g_variant_new_uint32(NFC_MODE_READER_WRITER);
+        } else if (IS("tags", "ao")) {
+            const char* tags[] = { FakeNfcd::TAG_PATH, Q_NULLPTR };
+
+            return g_variant_new_objv(tags, iCard ? -1 : 0);
+        }
+    } else if (kind == Tag) {
+        if (IS("present", "b")) {
+            return g_variant_new_boolean(iCard != Q_NULLPTR);
+        } else if (IS("technology", "u")) {
+            return g_variant_new_uint32(NFC_TECHNOLOGY_A);
+        } else if (IS("protocol", "u")) {
+            return g_variant_new_uint32(NFC_PROTOCOL_T4A_TAG);
+        } else if (IS("interfaces", "as")) {
+            const char* ifaces[] = { INTERFACE[Tag], INTERFACE[IsoDep], Q_NULLPTR };
+
+            return g_variant_new_strv(ifaces, -1);
+        }
+    }
+    #undef IS
+    return defaultValue(G_VARIANT_TYPE(sig));
+}
+
+GVariant*
+FakeNfcd::Private::tuple(
+    const Object* aObject,
+    GDBusArgInfo** aArgs) const
+{
+    GPtrArray* items = g_ptr_array_new();
+    GVariant* tuple;
+
+    for (GDBusArgInfo** arg = aArgs; arg && *arg; arg++) {
+        g_ptr_array_add(items, value(aObject, *arg));
+    }
+    tuple = g_variant_new_tuple((GVariant**)items->pdata, items->len);
+    g_ptr_array_free(items, TRUE);
+    return tuple;
+}
+
+bool
+FakeNfcd::Private::registerObject(
+    Kind aKind)
+{
+    Object* obj = iObject + aKind;
+
+    if (obj->iInterface && !obj->iRegId) {
+        GError* error = Q_NULLPTR;
+
+        obj->iRegId = g_dbus_connection_register_object(iBus,
+            OBJECT_PATH[aKind], obj->iInterface, &VTABLE, obj,
+            Q_NULLPTR, &error);
+        if (!obj->iRegId) {
+            HWARN(INTERFACE[aKind] << error->message);
+            g_error_free(error);
+        }
+    }
+    return obj->iRegId != 0;
+}
+
+void
+FakeNfcd::Private::unregisterObject(
+    Kind aKind)
+{
+    Object* obj = iObject + aKind;
+
+    if (obj->iRegId) {
+        g_dbus_connection_unregister_object(iBus, obj->iRegId);
+        obj->iRegId = 0;
+    }
+}
+
+void
+FakeNfcd::Private::emitSignal(
+    Kind aKind,
+    const char* aName)
+{
+    const Object* obj = iObject + aKind;
+    const GDBusSignalInfo* signal = obj->iInterface ?
+        g_dbus_interface_info_lookup_signal(obj->iInterface, aName) :
+        Q_NULLPTR;
+
+    if (signal && iBus) {
+        g_dbus_connection_emit_signal(iBus, Q_NULLPTR, OBJECT_PATH[aKind],
+            INTERFACE[aKind], aName, tuple(obj, signal->args), Q_NULLPTR);
+    }
+}
+
+void
+FakeNfcd::Private::transmit(
+    GDBusMethodInvocation* aCall,
+    GVariant* aParams,
+    const GDBusMethodInfo* aMethod)
+{
+    GDBusArgInfo** args = aMethod->in_args;
+    NfcIsoDepApdu apdu;
+    gsize size = 0;
+    int i = 0;
+
+    memset(&apdu, 0, sizeof(apdu));
+    for (GDBusArgInfo** arg = args; arg && *arg; arg++, i++) {
+        GVariant* child = g_variant_get_child_value(aParams, i);
+        const QByteArray name(normalize((*arg)->name));
+
+        if (name == "cla") {
+            apdu.cla = g_variant_get_byte(child);
+        } else if (name == "ins") {
+            apdu.ins = g_variant_get_byte(child);
+        } else if (name == "p1") {
+            apdu.p1 = g_variant_get_byte(child);
+        } else if (name == "p2") {
+            apdu.p2 = g_variant_get_byte(child);
+        } else if (name == "le") {
+            apdu.le = g_variant_get_uint32(child);
+        } else if (name == "data") {
+            apdu.data.bytes = (const guint8*)g_variant_get_fixed_array(child,
+                &size, 1);
+            apdu.data.size = size;
+        }
+        // The data is still referenced by aParams
+        g_variant_unref(child);
+    }
+
+    if (iCard) {
+        Transmit* tx = new Transmit;
+
+        tx->iPrivate = this;
+        tx->iInvocation = aCall;
+        tx->iMethod = aMethod;
+        iCard->transmit(&apdu, Q_NULLPTR, transmitResp, tx, transmitFree);
+    } else {
+        g_dbus_method_invocation_return_dbus_error(aCall, ERROR_FAILED,
+            "Tag is gone");
+    }
+}
+
+/* static */
+void
+FakeNfcd::Private::transmitResp(
+    NfcIsoDepClient*,
+    const GUtilData* aResponse,
+    guint aSw,
+    const GError* aError,
+    void* aTransmit)
+{
+    Transmit* tx = (Transmit*)aTransmit;
+    GDBusMethodInvocation* call = tx->iInvocation;
+
+    tx->iInvocation = Q_NULLPTR;
+    if (aError) {
+        g_dbus_method_invocation_return_dbus_error(call, ERROR_FAILED,
+            aError->message);
+    } else {
+        GDBusArgInfo** args = tx->iMethod->out_args;
+        GPtrArray* items = g_ptr_array_new();
+
+        for (GDBusArgInfo** arg = args; arg && *arg; arg++) {
+            const QByteArray name(normalize((*arg)->name));
+
+            if (name == "response" && !strcmp((*arg)->signature, "ay")) {
+                g_ptr_array_add(items, g_variant_new_fixed_array(
+                    G_VARIANT_TYPE_BYTE, aResponse->bytes, aResponse->size, 1));
+            } else if (name == "sw1" && !strcmp((*arg)->signature, "y")) {
+                g_ptr_array_add(items, g_variant_new_byte(aSw >> 8));
+            } else if (name == "sw2" && !strcmp((*arg)->signature, "y")) {
+                g_ptr_array_add(items, g_variant_new_byte(aSw & 0xff));
+            } else {
+                g_ptr_array_add(items,
+                    defaultValue(G_VARIANT_TYPE((*arg)->signature)));
+            }
+        }
+        g_dbus_method_invocation_return_value(call,
+            g_variant_new_tuple((GVariant**)items->pdata, items->len));
+        g_ptr_array_free(items, TRUE);
+    }
+}
+
+/* static */
+void
+FakeNfcd::Private::transmitFree(
+    gpointer aTransmit)
+{
+    Transmit* tx = (Transmit*)aTransmit;
+
+    if (tx->iInvocation) {
+        // The tag has been removed before the response was delivered
+        g_dbus_method_invocation_return_dbus_error(tx->iInvocation,
+            ERROR_FAILED, "Tag is gone");
+    }
+    delete tx;
+}
+
+/* static */
+void
+FakeNfcd::Private::methodCall(
+    GDBusConnection*,
+    const gchar*,
+    const gchar*,
+    const gchar*,
+    const gchar* aMethod,
+    GVariant* aParams,
+    GDBusMethodInvocation* aCall,
+    gpointer aObject)
+{
+    const Object* obj = (Object*)aObject;
+    Private* self = obj->iPrivate;
+    const GDBusMethodInfo* method =
+        g_dbus_interface_info_lookup_method(obj->iInterface, aMethod);
+
+    HDEBUG(INTERFACE[obj->iKind] << aMethod);
+    if (obj->iKind == IsoDep && !strcmp(aMethod, "Transmit")) {
+        self->transmit(aCall, aParams, method);
+    } else {
+        // Lock acquisition, getters and whatnot
+        g_dbus_method_invocation_return_value(aCall,
+            self->tuple(obj, method->out_args));
+    }
+}
+
+/* static */
+void
+FakeNfcd::Private::nameAcquired(
+    GDBusConnection*,
+    const gchar* aName,
+    gpointer aPrivate)
+{
+    Private* self = (Private*)aPrivate;
+
+    HDEBUG("Acquired" << aName);
+    if (self->iReady) {
+        self->iReady(self->iUserData);
+    }
+}
+
+/* static */
+void
+FakeNfcd::Private::nameLost(
+    GDBusConnection*,
+    const gchar* aName,
+    gpointer aPrivate)
+{
+    Private* self = (Private*)aPrivate;
+
+    HWARN("Lost" << aName);
+    if (self->iLost) {
+        self->iLost(self->iUserData);
+    }
+}
+
+// ==========================================================================
+// FakeNfcd
+// ==========================================================================
+
+const char FakeNfcd::BUS_NAME[] = "org.sailfishos.nfc.daemon";
+const char FakeNfcd::ADAPTER_PATH[] = "/nfc0";
+const char FakeNfcd::TAG_PATH[] = "/nfc0/tag0";
+
+FakeNfcd::FakeNfcd(
+    const TravelCardEmulator::Config& aConfig,
+    const QString& aSpecDir) :
+    iPrivate(new Private(aConfig, aSpecDir))
+{
+}
+
+FakeNfcd::~FakeNfcd()
+{
+    delete iPrivate;
+}
+
+bool
+FakeNfcd::start(
+    GBusType aBusType,
+    void (*aReady)(void*),
+    void (*aLost)(void*),
+    void* aUserData)
+{
+    GError* error = Q_NULLPTR;
+
+    iPrivate->iReady = aReady;
+    iPrivate->iLost = aLost;
+    iPrivate->iUserData = aUserData;
+    iPrivate->iBus = g_bus_get_sync(aBusType, Q_NULLPTR, &error);
+    if (iPrivate->iBus) {
+        if (iPrivate->registerObject(Private::Daemon) &&
+            iPrivate->registerObject(Private::Adapter)) {
+            iPrivate->iOwnId = g_bus_own_name_on_connection(iPrivate->iBus,
+                BUS_NAME, G_BUS_NAME_OWNER_FLAGS_NONE, Private::nameAcquired,
+                Private::nameLost, iPrivate, Q_NULLPTR);
+            return true;
+        }
+    } else {
+        HWARN(error->message);
+        g_error_free(error);
+    }
+    return false;
+}
+
+bool
+FakeNfcd::tagPresent() const
+{
+    return iPrivate->iCard != Q_NULLPTR;
+}
+
+void
+FakeNfcd::tap()
+{
+    if (!iPrivate->iCard) {
+        HDEBUG("Tag arrived");
+        // Every tap starts with a fresh card state
+        iPrivate->iCard = new TravelCardEmulator(iPrivate->iConfig);
+        iPrivate->registerObject(Private::Tag);
+        iPrivate->registerObject(Private::IsoDep);
+        iPrivate->emitSignal(Private::Adapter, "TargetPresentChanged");
+        iPrivate->emitSignal(Private::Adapter, "TagsChanged");
+    }
+}
+
+void
+FakeNfcd::remove()
+{
+    if (iPrivate->iCard) {
+        HDEBUG("Tag is gone");
+        delete iPrivate->iCard;
+        iPrivate->iCard = Q_NULLPTR;
+        iPrivate->emitSignal(Private::Tag, "Removed");
+        iPrivate->unregisterObject(Private::IsoDep);
+        iPrivate->unregisterObject(Private::Tag);
+        iPrivate->emitSignal(Private::Adapter, "TargetPresentChanged");
+        iPrivate->emitSignal(Private::Adapter, "TagsChanged");
+    }
+}
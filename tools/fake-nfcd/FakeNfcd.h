@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#ifndef FAKE_NFCD_H
+#define FAKE_NFCD_H
+
+#include "TravelCardEmulator.h"
+
+#include <gio/gio.h>
+
+// Minimal stand-in for nfcd. Exposes one adapter (/nfc0) and, while
+// the card is "on the reader", one ISO-DEP tag (/nfc0/tag0) backed by
+// TravelCardEmulator. The interfaces are loaded from the libgnfcdc
+// D-Bus specs. Methods not explicitly handled return values derived
+// from the names of their output arguments (see FakeNfcd.cpp) which
+// is enough to keep libgnfcdc happy.
+class FakeNfcd
+{
+    Q_DISABLE_COPY(FakeNfcd)
+
+public:
+    static const char BUS_NAME[];   // org.sailfishos.nfc.daemon
+    static const char ADAPTER_PATH[];
+    static const char TAG_PATH[];
+
+    FakeNfcd(const TravelCardEmulator::Config&, const QString& aSpecDir);
+    ~FakeNfcd();
+
+    // Registers the objects and requests the bus name on the
+    // given bus. The ready callback is invoked when the name is
+    // acquired, the lost callback if it couldn't be acquired.
+    bool start(GBusType, void (*aReady)(void*), void (*aLost)(void*),
+        void* aUserData);
+
+    bool tagPresent() const;
+    void tap();
+    void remove();
+
+private:
+    class Private;
+    Private* iPrivate;
+};
+
+#endif // FAKE_NFCD_H
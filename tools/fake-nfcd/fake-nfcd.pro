@@ -0,0 +1,14 @@
+TARGET = fake-nfcd
+
+include(../tools.pri)
+
+# D-Bus interfaces are taken from libgnfcdc, so that the client and
+# the fake daemon can't disagree about what they look like
+DEFINES += NFCD_SPEC_DIR=\\\"$${LIBGNFCDC_SPEC}\\\"
+
+HEADERS += \
+    FakeNfcd.h
+
+SOURCES += \
+    FakeNfcd.cpp \
+    main.cpp
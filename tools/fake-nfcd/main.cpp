@@ -0,0 +1,180 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "FakeNfcd.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#ifndef NFCD_SPEC_DIR
+#  define NFCD_SPEC_DIR "."
+#endif
+
+// Commands accepted on stdin, one per line:
+//
+//   tap     - put the card on the reader
+//   remove  - take it away
+//   quit    - exit
+//
+// "ready" is printed to stdout once the bus name has been acquired.
+
+typedef struct fake_nfcd_app {
+    GMainLoop* loop;
+    FakeNfcd* nfcd;
+    guint watch;
+    int ret;
+} FakeNfcdApp;
+
+static
+void
+fake_nfcd_ready(
+    void* aUserData)
+{
+    printf("ready\n");
+    fflush(stdout);
+}
+
+static
+void
+fake_nfcd_lost(
+    void* aUserData)
+{
+    FakeNfcdApp* app = (FakeNfcdApp*)aUserData;
+
+    app->ret = 1;
+    g_main_loop_quit(app->loop);
+}
+
+static
+gboolean
+fake_nfcd_stdin(
+    GIOChannel* aChannel,
+    GIOCondition aCondition,
+    gpointer aUserData)
+{
+    FakeNfcdApp* app = (FakeNfcdApp*)aUserData;
+    gchar* line = NULL;
+    gsize term = 0;
+
+    if (g_io_channel_read_line(aChannel, &line, NULL, &term, NULL) ==
+        G_IO_STATUS_NORMAL) {
+        line[term] = 0;
+        g_strstrip(line);
+        if (!strcmp(line, "tap")) {
+            app->nfcd->tap();
+        } else if (!strcmp(line, "remove")) {
+            app->nfcd->remove();
+        } else if (!strcmp(line, "quit")) {
+            g_main_loop_quit(app->loop);
+        } else if (line[0]) {
+            fprintf(stderr, "Unknown command '%s'\n", line);
+        }
+        g_free(line);
+        return G_SOURCE_CONTINUE;
+    } else {
+        // EOF or error
+        app->watch = 0;
+        g_main_loop_quit(app->loop);
+        return G_SOURCE_REMOVE;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    gboolean system = FALSE;
+    char* specDir = NULL;
+    GOptionEntry entries[] = {
+        { "system", 0, 0, G_OPTION_ARG_NONE, &system,
+          "Use the system bus (default is session)", NULL },
+        { "spec", 's', 0, G_OPTION_ARG_FILENAME, &specDir,
+          "Directory containing nfcd D-Bus specs", "DIR" },
+        { NULL }
+    };
+    GOptionContext* options = g_option_context_new("CONFIG");
+    GError* error = NULL;
+    int ret = 2;
+
+    g_option_context_add_main_entries(options, entries, NULL);
+    g_option_context_set_summary(options, "Emulates nfcd with a single "
+        "ISO-DEP tag backed by the travel card emulator.");
+    if (g_option_context_parse(options, &argc, &argv, &error) && argc == 2) {
+        TravelCardEmulator::Config config;
+
+        if (TravelCardEmulator::load(QString::fromLocal8Bit(argv[1]),
+            &config)) {
+            FakeNfcdApp app;
+            FakeNfcd nfcd(config, QString::fromLocal8Bit(specDir ?
+                specDir : NFCD_SPEC_DIR));
+
+            app.loop = g_main_loop_new(NULL, FALSE);
+            app.nfcd = &nfcd;
+            app.ret = 0;
+            if (nfcd.start(system ? G_BUS_TYPE_SYSTEM : G_BUS_TYPE_SESSION,
+                fake_nfcd_ready, fake_nfcd_lost, &app)) {
+                GIOChannel* in = g_io_channel_unix_new(fileno(stdin));
+                app.watch = g_io_add_watch(in, (GIOCondition)
+                    (G_IO_IN | G_IO_HUP | G_IO_ERR), fake_nfcd_stdin, &app);
+
+                g_main_loop_run(app.loop);
+                if (app.watch) {
+                    g_source_remove(app.watch);
+                }
+                g_io_channel_unref(in);
+                ret = app.ret;
+            } else {
+                ret = 1;
+            }
+            g_main_loop_unref(app.loop);
+        } else {
+            fprintf(stderr, "Failed to load %s\n", argv[1]);
+        }
+    } else {
+        if (error) {
+            fprintf(stderr, "%s\n", error->message);
+            g_error_free(error);
+        } else {
+            char* help = g_option_context_get_help(options, TRUE, NULL);
+
+            fprintf(stderr, "%s", help);
+            g_free(help);
+        }
+    }
+    g_option_context_free(options);
+    g_free(specDir);
+    return ret;
+}
@@ -0,0 +1,8 @@
+TARGET = golden
+
+include(../tools.pri)
+include(../common/common.pri)
+include(../common/clock.pri)
+
+SOURCES += \
+    main.cpp
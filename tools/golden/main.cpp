@@ -0,0 +1,215 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "CardCorpus.h"
+#include "CardDecoder.h"
+#include "FakeClock.h"
+
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QLocale>
+#include <QtCore/QSaveFile>
+#include <QtCore/QStringList>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+// Decodes each dump in the corpus into canonical text and compares
+// it with <golden>/<dump>.txt, printing the decode time (the best of
+// several runs) next to the result. The time, the timezone and the
+// locale are fixed, so that the output doesn't depend on when and
+// where it's run. With --update the golden files are (re)written.
+
+#define DEFAULT_NOW "2024-06-01T12:00:00+03:00"
+
+static
+void
+golden_print_diff(
+    const QString& aExpected,
+    const QString& aActual)
+{
+    const QStringList expected(aExpected.split('\n'));
+    const QStringList actual(aActual.split('\n'));
+    const int n = qMax(expected.count(), actual.count());
+
+    for (int i = 0; i < n; i++) {
+        const QString e(i < expected.count() ? expected.at(i) : QString());
+        const QString a(i < actual.count() ? actual.at(i) : QString());
+
+        if (e != a) {
+            if (!e.isEmpty()) {
+                printf("  -%s\n", qPrintable(e));
+            }
+            if (!a.isEmpty()) {
+                printf("  +%s\n", qPrintable(a));
+            }
+        }
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    // These need to be set before anything looks at them
+    qputenv("TZ", "Europe/Helsinki");
+    qputenv("LC_ALL", "C");
+    qputenv("LANG", "C");
+    tzset();
+
+    QCoreApplication app(argc, argv);
+    QCommandLineParser parser;
+    QCommandLineOption update(QStringList() << "u" << "update",
+        "Write golden files instead of comparing");
+    QCommandLineOption golden(QStringList() << "g" << "golden",
+        "Golden files directory", "DIR");
+    QCommandLineOption now(QStringList() << "now",
+        "Current time (default " DEFAULT_NOW ")", "ISO",
+        DEFAULT_NOW);
+    QCommandLineOption repeat(QStringList() << "r" << "repeat",
+        "Decode each dump this many times", "N", "10");
+
+    app.setApplicationName("golden");
+    parser.setApplicationDescription("Card parser golden output test.");
+    parser.addHelpOption();
+    parser.addOption(update);
+    parser.addOption(golden);
+    parser.addOption(now);
+    parser.addOption(repeat);
+    parser.addPositionalArgument("corpus", "Dump files or directories "
+        "(default " + CardCorpus::defaultPath() + ")", "[corpus...]");
+    parser.process(app);
+
+    const QDateTime nowTime(QDateTime::fromString(parser.value(now),
+        Qt::ISODate));
+    const int repeatCount = qMax(parser.value(repeat).toInt(), 1);
+    const QString goldenDir(parser.isSet(golden) ? parser.value(golden) :
+        (CardCorpus::defaultPath() + QStringLiteral("/golden")));
+    QStringList paths(parser.positionalArguments());
+    QList<CardCorpus::Dump> corpus;
+
+    if (!nowTime.isValid()) {
+        fprintf(stderr, "Invalid time %s\n", qPrintable(parser.value(now)));
+        return 2;
+    }
+    if (paths.isEmpty()) {
+        paths.append(CardCorpus::defaultPath());
+    }
+    if (!CardCorpus::load(paths, &corpus) || corpus.isEmpty()) {
+        fprintf(stderr, "No dumps loaded\n");
+        return 1;
+    }
+
+    FakeClock::set(nowTime);
+    QLocale::setDefault(QLocale::c());
+
+    int failed = 0;
+    qint64 total = 0;
+
+    for (int i = 0; i < corpus.count(); i++) {
+        const CardCorpus::Dump& dump = corpus.at(i);
+        const QString file(goldenDir + QDir::separator() + dump.iName +
+            QStringLiteral(".txt"));
+        qint64 best = 0;
+        bool stable = true;
+        QString text;
+
+        for (int k = 0; k < repeatCount; k++) {
+            // Fresh parsers every time, the way a new page gets them
+            qint64 ns;
+            const QString out(CardDecoder::toText(CardDecoder().decode(
+                dump.iCardInfo, &ns)));
+
+            if (!k) {
+                text = out;
+                best = ns;
+            } else if (out != text) {
+                // Something non-deterministic is going on
+                stable = false;
+                break;
+            } else {
+                best = qMin(best, ns);
+            }
+        }
+        total += best;
+
+        const char* result;
+
+        if (!stable) {
+            result = "UNSTABLE";
+            failed++;
+        } else if (parser.isSet(update)) {
+            QSaveFile out(file);
+
+            QDir().mkpath(goldenDir);
+            if (out.open(QIODevice::WriteOnly) &&
+                out.write(text.toUtf8()) >= 0 && out.commit()) {
+                result = "updated";
+            } else {
+                result = "WRITE ERROR";
+                failed++;
+            }
+        } else {
+            QFile in(file);
+
+            if (!in.open(QIODevice::ReadOnly)) {
+                result = "NO GOLDEN";
+                failed++;
+            } else {
+                const QString expected(QString::fromUtf8(in.readAll()));
+
+                if (expected == text) {
+                    result = "ok";
+                } else {
+                    result = "FAIL";
+                    failed++;
+                    printf("%-10s %9.1f us  %s\n", result, best/1e3,
+                        qPrintable(dump.iName));
+                    golden_print_diff(expected, text);
+                    continue;
+                }
+            }
+        }
+        printf("%-10s %9.1f us  %s\n", result, best/1e3,
+            qPrintable(dump.iName));
+    }
+    printf("%d dump(s), %d failed, %.1f us total\n", corpus.count(), failed,
+        total/1e3);
+    return failed ? 1 : 0;
+}
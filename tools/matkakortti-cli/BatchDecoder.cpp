@@ -0,0 +1,420 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "BatchDecoder.h"
+
+#include "CardDecoder.h"
+#include "TravelCardDump.h"
+#include "Util.h"
+
+#include "HarbourDebug.h"
+
+#include <QtCore/QAtomicInt>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QThread>
+#include <QtCore/QVector>
+
+// ==========================================================================
+// BatchDecoder::Private
+// ==========================================================================
+
+class BatchDecoder::Private
+{
+public:
+    struct Job {
+        QString iSource;        // File name or file:line
+        QString iFile;          // Read by the worker if not empty
+        QByteArray iJson;       // Otherwise, the dump itself
+        QByteArray iBinary;     // or a binary one
+    };
+
+    struct Result {
+        QString iCardType;
+        QVariantMap iDecoded;
+        QString iError;
+    };
+
+    Private();
+
+    bool addBinary(const QString&);
+    static QString csvField(const QString&);
+    void decode(int);
+    void printJson(FILE*) const;
+    void printCsv(FILE*) const;
+
+public:
+    QList<Job> iJobs;
+    QVector<Result> iResults;
+    QAtomicInt iNextJob;
+};
+
+BatchDecoder::Private::Private() :
+    iNextJob(0)
+{
+}
+
+void
+BatchDecoder::Private::decode(
+    int aIndex)
+{
+    const Job& job = iJobs.at(aIndex);
+    Result* result = iResults.data() + aIndex;
+    QByteArray json(job.iJson);
+
+    if (!job.iBinary.isEmpty()) {
+        TravelCardDump dump;
+        int offset = 0;
+
+        // Already validated by addBinary()
+        TravelCardDump::parse(job.iBinary, &offset, &dump);
+        result->iCardType = dump.iCardType;
+        result->iDecoded = CardDecoder::decodePlain(dump.cardInfo());
+        if (result->iDecoded.isEmpty()) {
+            result->iError = QStringLiteral("Unknown card type");
+        }
+        return;
+    }
+
+    if (!job.iFile.isEmpty()) {
+        QFile f(job.iFile);
+
+        if (f.open(QIODevice::ReadOnly)) {
+            json = f.readAll();
+        } else {
+            result->iError = QStringLiteral("Can't open file");
+            return;
+        }
+    }
+
+    QJsonParseError error;
+    const QJsonDocument doc(QJsonDocument::fromJson(json, &error));
+
+    if (doc.isObject()) {
+        const QVariantMap cardInfo(doc.object().toVariantMap());
+
+        result->iCardType = cardInfo.value(Util::CARD_TYPE_KEY).toString();
+        result->iDecoded = CardDecoder::decodePlain(cardInfo);
+        if (result->iDecoded.isEmpty()) {
+            result->iError = QStringLiteral("Unknown card type");
+        }
+    } else {
+        result->iError = error.errorString();
+    }
+}
+
+bool
+BatchDecoder::Private::addBinary(
+    const QString& aPath)
+{
+    QFile f(aPath);
+
+    if (f.open(QIODevice::ReadOnly)) {
+        // Only the boundaries of the dumps are figured out here,
+        // converting them to card info is left to the workers
+        const QByteArray data(f.readAll());
+        int offset = 0, n = 0;
+
+        while (offset < data.size()) {
+            const int start = offset;
+            TravelCardDump dump;
+
+            if (TravelCardDump::parse(data, &offset, &dump)) {
+                Job job;
+
+                job.iSource = QString("%1#%2").arg(aPath).arg(++n);
+                job.iBinary = data.mid(start, offset - start);
+                iJobs.append(job);
+            } else {
+                HWARN("Garbage at offset" << offset << "in" << qPrintable(aPath));
+                return false;
+            }
+        }
+        return true;
+    }
+    return false;
+}
+
+QString
+BatchDecoder::Private::csvField(
+    const QString& aValue)
+{
+    if (aValue.contains(',') || aValue.contains('"') ||
+        aValue.contains('\n')) {
+        QString quoted(aValue);
+
+        quoted.replace(QStringLiteral("\""), QStringLiteral("\"\""));
+        return QLatin1Char('"') + quoted + QLatin1Char('"');
+    } else {
+        return aValue;
+    }
+}
+
+void
+BatchDecoder::Private::printJson(
+    FILE* aOut) const
+{
+    for (int i = 0; i < iJobs.count(); i++) {
+        const Result& result = iResults.at(i);
+        QJsonObject row;
+
+        row.insert(QStringLiteral("source"), iJobs.at(i).iSource);
+        if (!result.iCardType.isEmpty()) {
+            row.insert(Util::CARD_TYPE_KEY, result.iCardType);
+        }
+        if (!result.iError.isEmpty()) {
+            row.insert(QStringLiteral("error"), result.iError);
+        } else {
+            row.insert(QStringLiteral("decoded"),
+                QJsonObject::fromVariantMap(result.iDecoded));
+        }
+        fputs(QJsonDocument(row).toJson(QJsonDocument::Compact).constData(),
+            aOut);
+        fputc('\n', aOut);
+    }
+}
+
+void
+BatchDecoder::Private::printCsv(
+    FILE* aOut) const
+{
+    // The columns are the union of the values of all card types,
+    // in the order of appearance
+    QVector<QStringList> keys(iJobs.count());
+    QVector<QStringList> values(iJobs.count());
+    QHash<QString,int> columnIndex;
+    QStringList columns;
+
+    for (int i = 0; i < iJobs.count(); i++) {
+        CardDecoder::flatten(iResults.at(i).iDecoded, keys.data() + i,
+            values.data() + i);
+        const QStringList& rowKeys = keys.at(i);
+
+        for (int k = 0; k < rowKeys.count(); k++) {
+            const QString& key = rowKeys.at(k);
+
+            if (!columnIndex.contains(key)) {
+                columnIndex.insert(key, columns.count());
+                columns.append(key);
+            }
+        }
+    }
+
+    QStringList header;
+
+    header << QStringLiteral("source") << Util::CARD_TYPE_KEY <<
+        QStringLiteral("error");
+    for (int c = 0; c < columns.count(); c++) {
+        header.append(csvField(columns.at(c)));
+    }
+    fprintf(aOut, "%s\n", header.join(',').toUtf8().constData());
+
+    for (int i = 0; i < iJobs.count(); i++) {
+        const Result& result = iResults.at(i);
+        const QStringList& rowKeys = keys.at(i);
+        const QStringList& rowValues = values.at(i);
+        QStringList row;
+
+        row << csvField(iJobs.at(i).iSource) << csvField(result.iCardType) <<
+            csvField(result.iError);
+        for (int c = 0; c < columns.count(); c++) {
+            row.append(QString());
+        }
+        for (int k = 0; k < rowKeys.count(); k++) {
+            row[3 + columnIndex.value(rowKeys.at(k))] =
+                csvField(rowValues.at(k));
+        }
+        fprintf(aOut, "%s\n", row.join(',').toUtf8().constData());
+    }
+}
+
+// ==========================================================================
+// BatchDecoder::Worker
+// ==========================================================================
+
+class BatchDecoder::Worker :
+    public QThread
+{
+public:
+    Worker(Private* aBatch) : iBatch(aBatch), iCount(0) {}
+
+protected:
+    void run() Q_DECL_OVERRIDE;
+
+public:
+    Private* iBatch;
+    int iCount;
+};
+
+void
+BatchDecoder::Worker::run()
+{
+    // Plain decoding, no parser objects are created on this thread
+    const int n = iBatch->iJobs.count();
+    int i;
+
+    while ((i = iBatch->iNextJob.fetchAndAddRelaxed(1)) < n) {
+        iBatch->decode(i);
+        iCount++;
+    }
+}
+
+// ==========================================================================
+// BatchDecoder
+// ==========================================================================
+
+BatchDecoder::BatchDecoder() :
+    iPrivate(new Private)
+{
+}
+
+BatchDecoder::~BatchDecoder()
+{
+    delete iPrivate;
+}
+
+bool
+BatchDecoder::addInput(
+    const QString& aPath)
+{
+    const QFileInfo info(aPath);
+
+    if (info.isDir()) {
+        const QFileInfoList files(QDir(aPath).entryInfoList(QStringList() <<
+            QStringLiteral("*.json") << (QLatin1Char('*') +
+            QLatin1String(TravelCardDump::SUFFIX)), QDir::Files |
+            QDir::Readable, QDir::Name));
+        bool ok = true;
+
+        for (int i = 0; i < files.count(); i++) {
+            const QString file(files.at(i).filePath());
+
+            if (files.at(i).suffix() == QStringLiteral("json")) {
+                Private::Job job;
+
+                job.iSource = job.iFile = file;
+                iPrivate->iJobs.append(job);
+            } else if (!iPrivate->addBinary(file)) {
+                ok = false;
+            }
+        }
+        return ok;
+    } else if (info.suffix() == QStringLiteral("jsonl")) {
+        QFile f(aPath);
+
+        if (f.open(QIODevice::ReadOnly)) {
+            int line = 0;
+
+            while (!f.atEnd()) {
+                const QByteArray json(f.readLine().trimmed());
+
+                line++;
+                if (!json.isEmpty()) {
+                    Private::Job job;
+
+                    job.iSource = QString("%1:%2").arg(aPath).arg(line);
+                    job.iJson = json;
+                    iPrivate->iJobs.append(job);
+                }
+            }
+            return true;
+        }
+    } else if (info.suffix() == QLatin1String(TravelCardDump::SUFFIX + 1)) {
+        if (iPrivate->addBinary(aPath)) {
+            return true;
+        }
+    } else if (info.isFile()) {
+        Private::Job job;
+
+        job.iSource = job.iFile = aPath;
+        iPrivate->iJobs.append(job);
+        return true;
+    }
+    HWARN("Can't read" << qPrintable(aPath));
+    return false;
+}
+
+int
+BatchDecoder::count() const
+{
+    return iPrivate->iJobs.count();
+}
+
+int
+BatchDecoder::run(
+    int aThreads,
+    Format aFormat,
+    FILE* aOut)
+{
+    const int n = iPrivate->iJobs.count();
+    const int threads = qBound(1, (aThreads > 0) ? aThreads :
+        QThread::idealThreadCount(), qMax(n, 1));
+    QList<Worker*> workers;
+    int failed = 0;
+
+    iPrivate->iResults = QVector<Private::Result>(n);
+    iPrivate->iNextJob.store(0);
+    for (int i = 0; i < threads; i++) {
+        Worker* worker = new Worker(iPrivate);
+
+        workers.append(worker);
+        worker->start();
+    }
+    for (int i = 0; i < threads; i++) {
+        Worker* worker = workers.at(i);
+
+        worker->wait();
+        HDEBUG("Thread" << i << "decoded" << worker->iCount << "dump(s)");
+        delete worker;
+    }
+
+    for (int i = 0; i < n; i++) {
+        if (!iPrivate->iResults.at(i).iError.isEmpty()) {
+            failed++;
+        }
+    }
+    if (aFormat == FormatCsv) {
+        iPrivate->printCsv(aOut);
+    } else {
+        iPrivate->printJson(aOut);
+    }
+    return failed;
+}
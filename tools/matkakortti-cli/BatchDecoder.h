@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#ifndef BATCH_DECODER_H
+#define BATCH_DECODER_H
+
+#include <QtCore/QString>
+
+#include <stdio.h>
+
+// Decodes lots of card dumps in parallel. Inputs are directories
+// with *.json and *.mkd dumps, individual *.json dumps, *.jsonl files
+// (one card info JSON object per line) and *.mkd files (concatenated
+// binary dumps). Worker threads pull the next dump off the shared
+// queue as soon as they are done with the previous one, so a few slow
+// dumps don't hold up the others. The workers use the plain decoders
+// (CardDecoder::decodePlain) which don't depend on the current time.
+// The output has one row per dump, in the input order.
+class BatchDecoder
+{
+    Q_DISABLE_COPY(BatchDecoder)
+
+public:
+    enum Format {
+        FormatJson,             // One compact JSON object per line
+        FormatCsv               // Header + one row per dump
+    };
+
+    BatchDecoder();
+    ~BatchDecoder();
+
+    bool addInput(const QString& aPath);
+    int count() const;
+
+    // Returns the number of dumps which failed to decode
+    int run(int aThreads, Format aFormat, FILE* aOut);
+
+private:
+    class Worker;
+    class Private;
+    Private* iPrivate;
+};
+
+#endif // BATCH_DECODER_H
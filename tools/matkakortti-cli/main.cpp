@@ -0,0 +1,398 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "BatchDecoder.h"
+#include "CardCorpus.h"
+#include "CardDecoder.h"
+#include "TravelCard.h"
+#include "TravelCardAllocStats.h"
+#include "TravelCardDump.h"
+#include "TravelCardTrace.h"
+
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFileInfo>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QTimer>
+
+#include <nfcdc_default_adapter.h>
+
+#include <stdio.h>
+
+// Reads the card (or takes an already read card info from a file)
+// and prints what the card pages would show. Doesn't use QtQuick,
+// so it starts quickly and can be used from scripts.
+
+class MatkakorttiCli : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Result {
+        ResultOk,
+        ResultFailed,
+        ResultUsage,
+        ResultTimeout
+    };
+
+    MatkakorttiCli(bool aJson, bool aRaw, bool aTiming);
+    ~MatkakorttiCli();
+
+    void read(const QString& aPath, int aTimeoutSec);
+    void waitForTag(int aTimeoutSec);
+    int print(const QVariantMap& aCardInfo);
+
+private:
+    static QVariantMap raw(const QVariantMap&);
+    static void tagsChanged(NfcDefaultAdapter*, NFC_DEFAULT_ADAPTER_PROPERTY,
+        void*);
+    void dropAdapter();
+
+private Q_SLOTS:
+    void onCardStateChanged();
+    void onTagLost();
+    void onTimeout();
+
+private:
+    const bool iJson;
+    const bool iRaw;
+    const bool iTiming;
+    TravelCard* iCard;
+    NfcDefaultAdapter* iAdapter;
+    gulong iAdapterEventId;
+    QTimer* iTimer;
+    QElapsedTimer iElapsed;
+};
+
+MatkakorttiCli::MatkakorttiCli(
+    bool aJson,
+    bool aRaw,
+    bool aTiming) :
+    iJson(aJson),
+    iRaw(aRaw),
+    iTiming(aTiming),
+    iCard(Q_NULLPTR),
+    iAdapter(Q_NULLPTR),
+    iAdapterEventId(0),
+    iTimer(new QTimer(this))
+{
+    iTimer->setSingleShot(true);
+    connect(iTimer, SIGNAL(timeout()), SLOT(onTimeout()));
+    iElapsed.start();
+}
+
+MatkakorttiCli::~MatkakorttiCli()
+{
+    dropAdapter();
+}
+
+void
+MatkakorttiCli::dropAdapter()
+{
+    if (iAdapter) {
+        nfc_default_adapter_remove_handler(iAdapter, iAdapterEventId);
+        nfc_default_adapter_unref(iAdapter);
+        iAdapter = Q_NULLPTR;
+        iAdapterEventId = 0;
+    }
+}
+
+void
+MatkakorttiCli::read(
+    const QString& aPath,
+    int aTimeoutSec)
+{
+    if (!iCard) {
+        iCard = new TravelCard(this);
+        connect(iCard, SIGNAL(cardStateChanged()), SLOT(onCardStateChanged()));
+        connect(iCard, SIGNAL(tagLost()), SLOT(onTagLost()));
+    }
+    if (aTimeoutSec > 0) {
+        iTimer->start(aTimeoutSec * 1000);
+    }
+    iCard->setPath(aPath);
+}
+
+void
+MatkakorttiCli::waitForTag(
+    int aTimeoutSec)
+{
+    fprintf(stderr, "Waiting for the card...\n");
+    iAdapter = nfc_default_adapter_new();
+    iAdapterEventId = nfc_default_adapter_add_property_handler(iAdapter,
+        NFC_DEFAULT_ADAPTER_PROPERTY_TAGS, tagsChanged, this);
+    if (aTimeoutSec > 0) {
+        iTimer->start(aTimeoutSec * 1000);
+    }
+    // The tag may already be there
+    tagsChanged(iAdapter, NFC_DEFAULT_ADAPTER_PROPERTY_TAGS, this);
+}
+
+/* static */
+void
+MatkakorttiCli::tagsChanged(
+    NfcDefaultAdapter* aAdapter,
+    NFC_DEFAULT_ADAPTER_PROPERTY,
+    void* aCli)
+{
+    MatkakorttiCli* self = (MatkakorttiCli*)aCli;
+    const GStrV* tags = aAdapter->tags;
+
+    if (tags && tags[0]) {
+        const QString path(QString::fromLatin1(tags[0]));
+
+        self->dropAdapter();
+        if (self->iTiming) {
+            fprintf(stderr, "Tag %s after %.1f ms\n", qPrintable(path),
+                self->iElapsed.nsecsElapsed()/1e6);
+        }
+        // The timeout keeps running
+        self->read(path, 0);
+    }
+}
+
+/* static */
+QVariantMap
+MatkakorttiCli::raw(
+    const QVariantMap& aCardInfo)
+{
+    // The debug section contains objects (e.g. the APDU log), those
+    // are replaced with their text if they have any
+    const QString debugKey("debug");
+    const QVariantMap debug(aCardInfo.value(debugKey).toMap());
+    QVariantMap info(aCardInfo);
+
+    if (!debug.isEmpty()) {
+        QVariantMap text;
+
+        for (QVariantMap::const_iterator it = debug.constBegin();
+             it != debug.constEnd(); ++it) {
+            QObject* obj = qvariant_cast<QObject*>(it.value());
+
+            if (!obj) {
+                text.insert(it.key(), it.value());
+            } else if (obj->property("text").isValid()) {
+                text.insert(it.key(), obj->property("text"));
+            }
+        }
+        info.insert(debugKey, text);
+    }
+    return info;
+}
+
+int
+MatkakorttiCli::print(
+    const QVariantMap& aCardInfo)
+{
+    QElapsedTimer timer;
+    qint64 decodeNs = 0;
+
+    timer.start();
+    const QVariantMap output(iRaw ? raw(aCardInfo) :
+        CardDecoder().decode(aCardInfo, &decodeNs));
+    const qint64 totalNs = timer.nsecsElapsed();
+
+    if (iJson) {
+        fputs(CardDecoder::toJson(output, false).constData(), stdout);
+    } else {
+        fputs(CardDecoder::toText(output).toUtf8().constData(), stdout);
+    }
+    if (iTiming && !iRaw) {
+        fprintf(stderr, "Decoded in %.1f us (parsers %.1f us)\n",
+            totalNs/1e3, decodeNs/1e3);
+#ifdef MATKAKORTTI_ALLOC_STATS
+        fputs(qPrintable(TravelCardAllocStats::instance()->text()), stderr);
+#endif
+    }
+    return output.isEmpty() ? ResultFailed : ResultOk;
+}
+
+void
+MatkakorttiCli::onCardStateChanged()
+{
+    switch (iCard->cardState()) {
+    case TravelCard::CardRecognized:
+        iTimer->stop();
+        if (iTiming) {
+            fprintf(stderr, "Read in %.1f ms\n", iElapsed.nsecsElapsed()/1e6);
+        }
+        QCoreApplication::exit(print(iCard->cardInfo()));
+        break;
+    case TravelCard::CardNone:
+        if (!iCard->path().isEmpty()) {
+            fprintf(stderr, "Card not recognized\n");
+            QCoreApplication::exit(ResultFailed);
+        }
+        break;
+    case TravelCard::CardReading:
+        break;
+    }
+}
+
+void
+MatkakorttiCli::onTagLost()
+{
+    fprintf(stderr, "Card removed\n");
+    iTimer->stop();
+    // Not to be reported as unrecognized
+    iCard->disconnect(this);
+    QCoreApplication::exit(ResultFailed);
+}
+
+void
+MatkakorttiCli::onTimeout()
+{
+    fprintf(stderr, "Timed out\n");
+    QCoreApplication::exit(ResultTimeout);
+}
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCommandLineParser parser;
+    QCommandLineOption json(QStringList() << "j" << "json",
+        "Output JSON");
+    QCommandLineOption raw(QStringList() << "r" << "raw",
+        "Output raw card info rather than decoded data");
+    QCommandLineOption timing(QStringList() << "T" << "time",
+        "Print timing information to stderr");
+    QCommandLineOption timeout(QStringList() << "t" << "timeout",
+        "Give up after this many seconds (0 = wait forever)", "SEC", "30");
+    QCommandLineOption batch(QStringList() << "b" << "batch",
+        "Decode dumps (directories, *.json, *.jsonl or *.mkd files) in parallel");
+    QCommandLineOption csv(QStringList() << "csv",
+        "Output CSV (batch mode only)");
+    QCommandLineOption threads(QStringList() << "n" << "threads",
+        "Number of batch decoding threads (default: one per core)", "N",
+        "0");
+#ifdef MATKAKORTTI_TRACE
+    QCommandLineOption trace(QStringList() << "trace",
+        "Write Trace Event JSON to FILE", "FILE");
+#endif
+
+    app.setApplicationName("matkakortti-cli");
+    parser.setApplicationDescription("Reads and decodes HSL and Nysse "
+        "travel cards.\n\nSOURCE is an NFC tag path (e.g. /nfc0/tag0), "
+        "replay:TRANSCRIPT, emulator:CONFIG, a card info JSON file or a "
+        "binary dump. "
+        "Without SOURCE, waits for a card on the default NFC adapter.\n\n"
+        "In batch mode, SOURCE is a list of dumps to decode.");
+    parser.addHelpOption();
+    parser.addOption(json);
+    parser.addOption(raw);
+    parser.addOption(timing);
+    parser.addOption(timeout);
+    parser.addOption(batch);
+    parser.addOption(csv);
+    parser.addOption(threads);
+#ifdef MATKAKORTTI_TRACE
+    parser.addOption(trace);
+#endif
+    parser.addPositionalArgument("source", "What to read", "[SOURCE]");
+    parser.process(app);
+
+    const QStringList args(parser.positionalArguments());
+
+    if (parser.isSet(batch)) {
+        BatchDecoder decoder;
+        QElapsedTimer timer;
+        bool ok = !args.isEmpty();
+
+        for (int i = 0; i < args.count(); i++) {
+            ok = decoder.addInput(args.at(i)) && ok;
+        }
+        if (!ok) {
+            parser.showHelp(MatkakorttiCli::ResultUsage);
+        }
+
+        timer.start();
+        const int failed = decoder.run(parser.value(threads).toInt(),
+            parser.isSet(csv) ? BatchDecoder::FormatCsv :
+            BatchDecoder::FormatJson, stdout);
+
+        if (parser.isSet(timing)) {
+            const qint64 ms = qMax(timer.elapsed(), Q_INT64_C(1));
+
+            fprintf(stderr, "%d dump(s) in %lld ms (%.0f/sec), %d failed\n",
+                decoder.count(), (long long)ms, decoder.count() * 1000.0 / ms,
+                failed);
+        }
+        return failed ? MatkakorttiCli::ResultFailed :
+            MatkakorttiCli::ResultOk;
+    }
+
+    const int timeoutSec = parser.value(timeout).toInt();
+    MatkakorttiCli cli(parser.isSet(json), parser.isSet(raw),
+        parser.isSet(timing));
+    int ret;
+
+    if (args.count() > 1) {
+        parser.showHelp(MatkakorttiCli::ResultUsage);
+    }
+
+    const QString source(args.isEmpty() ? QString() : args.first());
+
+    if ((source.endsWith(QStringLiteral(".json")) ||
+         source.endsWith(QLatin1String(TravelCardDump::SUFFIX))) &&
+        QFileInfo(source).isFile()) {
+        // Already read card, just decode it
+        QList<CardCorpus::Dump> dumps;
+
+        ret = CardCorpus::load(source, &dumps) ?
+            cli.print(dumps.first().iCardInfo) :
+            MatkakorttiCli::ResultFailed;
+    } else {
+        if (source.isEmpty()) {
+            cli.waitForTag(timeoutSec);
+        } else {
+            cli.read(source, timeoutSec);
+        }
+        ret = app.exec();
+    }
+
+#ifdef MATKAKORTTI_TRACE
+    if (parser.isSet(trace)) {
+        TravelCardTrace::save(parser.value(trace));
+    }
+#endif
+    return ret;
+}
+
+#include "main.moc"
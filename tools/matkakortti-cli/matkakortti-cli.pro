@@ -0,0 +1,11 @@
+TARGET = matkakortti-cli
+
+include(../tools.pri)
+include(../common/common.pri)
+
+HEADERS += \
+    BatchDecoder.h
+
+SOURCES += \
+    BatchDecoder.cpp \
+    main.cpp
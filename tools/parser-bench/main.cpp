@@ -0,0 +1,170 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "AllocCounter.h"
+#include "CardCorpus.h"
+#include "CardParsers.h"
+
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QScopedPointer>
+
+#include <stdio.h>
+#include <string.h>
+
+// Feeds the corpus to each parser the same way the card pages are
+// doing it (by setting the data property) and measures the time and
+// the number of heap allocations per record. Each parser is run for
+// at least the specified amount of time. Between the measured calls
+// the parser is reset with an empty string, that's not measured.
+
+struct ParserStats {
+    const CardParsers::Parser* iParser;
+    quint64 iRecords;
+    quint64 iNanoseconds;
+    AllocCounter::Stats iAllocs;
+};
+
+static
+bool
+parser_bench_run(
+    const CardParsers::Parser* aParser,
+    const QList<CardCorpus::Dump>& aCorpus,
+    qint64 aMinTimeNs,
+    ParserStats* aStats)
+{
+    QStringList inputs;
+    QList<int> records;
+
+    for (int i = 0; i < aCorpus.count(); i++) {
+        const QString data(CardParsers::data(aParser, aCorpus.at(i)));
+
+        if (!data.isEmpty()) {
+            inputs.append(data);
+            records.append(CardParsers::recordCount(aParser, data));
+        }
+    }
+
+    memset(aStats, 0, sizeof(*aStats));
+    aStats->iParser = aParser;
+    if (!inputs.isEmpty()) {
+        QScopedPointer<QObject> parser(aParser->iNew());
+        QElapsedTimer timer;
+
+        // Warm up (lazy static initialization and such)
+        for (int i = 0; i < inputs.count(); i++) {
+            CardParsers::setData(parser.data(), inputs.at(i));
+        }
+
+        AllocCounter::reset();
+        while ((qint64)aStats->iNanoseconds < aMinTimeNs) {
+            for (int i = 0; i < inputs.count(); i++) {
+                CardParsers::setData(parser.data(), QString());
+                AllocCounter::start();
+                timer.start();
+                CardParsers::setData(parser.data(), inputs.at(i));
+                aStats->iNanoseconds += timer.nsecsElapsed();
+                AllocCounter::stop();
+                aStats->iRecords += records.at(i);
+            }
+        }
+        aStats->iAllocs = AllocCounter::stats();
+        return true;
+    }
+    return false;
+}
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCommandLineParser parser;
+    QCommandLineOption minTime(QStringList() << "t" << "time",
+        "Minimum run time per parser", "MS", "500");
+    QCommandLineOption csv(QStringList() << "c" << "csv",
+        "Output CSV");
+    QCommandLineOption filter(QStringList() << "p" << "parser",
+        "Only run this parser (may be repeated)", "NAME");
+
+    app.setApplicationName("parser-bench");
+    parser.setApplicationDescription("Card parser benchmark.");
+    parser.addHelpOption();
+    parser.addOption(minTime);
+    parser.addOption(csv);
+    parser.addOption(filter);
+    parser.addPositionalArgument("corpus", "Dump files or directories "
+        "(default " + CardCorpus::defaultPath() + ")", "[corpus...]");
+    parser.process(app);
+
+    QStringList paths(parser.positionalArguments());
+    QList<CardCorpus::Dump> corpus;
+
+    if (paths.isEmpty()) {
+        paths.append(CardCorpus::defaultPath());
+    }
+    if (!CardCorpus::load(paths, &corpus) || corpus.isEmpty()) {
+        fprintf(stderr, "No dumps loaded\n");
+        return 1;
+    }
+
+    const QStringList only(parser.values(filter));
+    const qint64 ns = parser.value(minTime).toLongLong() * 1000000;
+    const bool csvOut = parser.isSet(csv);
+
+    if (csvOut) {
+        printf("parser,records,ns/record,allocs/record,bytes/record\n");
+    } else {
+        printf("%-20s %8s %12s %14s %13s\n", "parser", "records",
+            "ns/record", "allocs/record", "bytes/record");
+    }
+    for (int i = 0; i < CardParsers::COUNT; i++) {
+        const CardParsers::Parser* p = CardParsers::ALL + i;
+        ParserStats stats;
+
+        if ((only.isEmpty() || only.contains(p->iName)) &&
+            parser_bench_run(p, corpus, ns, &stats) && stats.iRecords) {
+            const double n = stats.iRecords;
+
+            printf(csvOut ? "%s,%llu,%.1f,%.2f,%.1f\n" :
+                "%-20s %8llu %12.1f %14.2f %13.1f\n", p->iName,
+                (unsigned long long)stats.iRecords, stats.iNanoseconds/n,
+                stats.iAllocs.iCount/n, stats.iAllocs.iBytes/n);
+        }
+    }
+    return 0;
+}
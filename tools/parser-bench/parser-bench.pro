@@ -0,0 +1,8 @@
+TARGET = parser-bench
+
+include(../tools.pri)
+include(../common/common.pri)
+include(../common/alloc.pri)
+
+SOURCES += \
+    main.cpp
@@ -0,0 +1,346 @@
+/*
+ * Copyright (C) 2026 Slava Monich <slava@monich.com>
+ *
+ * You may use this file under the terms of the BSD license as follows:
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  1. Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *  2. Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer
+ *     in the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *  3. Neither the names of the copyright holders nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDERS OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The views and conclusions contained in the software and documentation
+ * are those of the authors and should not be interpreted as representing
+ * any official policies, either expressed or implied.
+ */
+
+#include "TravelCard.h"
+
+#include "HarbourDebug.h"
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFileInfo>
+#include <QtCore/QProcess>
+#include <QtCore/QTimer>
+
+#include <nfcdc_adapter.h>
+
+#include <algorithm>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+// Measures the time from the card being put on the reader to
+// TravelCard reaching the CardRecognized state. The same emulated
+// card is read twice: in-process (which gives the cost of parsing
+// and of the driver logic) and through the fake nfcd, which adds
+// libgnfcdc and D-Bus to the picture. The difference between the
+// two is what D-Bus costs us.
+//
+// The fake daemon sits on the session bus, so this has to be run
+// under dbus-run-session (or any other private session bus).
+
+class TapLatency : public QObject
+{
+    Q_OBJECT
+
+public:
+    TapLatency(const QString& aConfig, const QString& aFakeNfcd, int aRounds);
+    ~TapLatency();
+
+    bool start();
+
+private:
+    static void printStats(const char*, QList<qint64>);
+    static void adapterTagsChanged(NfcAdapterClient*, NFC_ADAPTER_PROPERTY,
+        void*);
+    void nextRound();
+    void roundDone(bool aOk);
+    void finish();
+
+private Q_SLOTS:
+    void onCardStateChanged();
+    void onFakeNfcdOutput();
+    void onFakeNfcdFinished();
+
+private:
+    enum Phase {
+        InProcess,
+        OverDBus,
+        Done
+    };
+
+    const QString iConfig;
+    const QString iFakeNfcd;
+    const int iRounds;
+    TravelCard* iCard;
+    QProcess* iProcess;
+    NfcAdapterClient* iAdapter;
+    gulong iAdapterEventId;
+    QElapsedTimer iTimer;
+    Phase iPhase;
+    int iRound;
+    bool iWaitingForCard;
+    int iFailures;
+    QList<qint64> iInProcess;
+    QList<qint64> iOverDBus;
+};
+
+TapLatency::TapLatency(
+    const QString& aConfig,
+    const QString& aFakeNfcd,
+    int aRounds) :
+    iConfig(aConfig),
+    iFakeNfcd(aFakeNfcd),
+    iRounds(aRounds),
+    iCard(new TravelCard(this)),
+    iProcess(Q_NULLPTR),
+    iAdapter(Q_NULLPTR),
+    iAdapterEventId(0),
+    iPhase(InProcess),
+    iRound(0),
+    iWaitingForCard(false),
+    iFailures(0)
+{
+    connect(iCard, SIGNAL(cardStateChanged()), SLOT(onCardStateChanged()));
+}
+
+TapLatency::~TapLatency()
+{
+    if (iAdapter) {
+        nfc_adapter_client_remove_handler(iAdapter, iAdapterEventId);
+        nfc_adapter_client_unref(iAdapter);
+    }
+    if (iProcess) {
+        iProcess->disconnect(this);
+        iProcess->write("quit\n");
+        if (!iProcess->waitForFinished(1000)) {
+            iProcess->kill();
+        }
+    }
+}
+
+bool
+TapLatency::start()
+{
+    if (qgetenv("DBUS_SESSION_BUS_ADDRESS").isEmpty()) {
+        fprintf(stderr, "No session bus, try dbus-run-session\n");
+        return false;
+    }
+    nextRound();
+    return true;
+}
+
+void
+TapLatency::nextRound()
+{
+    if (iRound < iRounds) {
+        iRound++;
+        iWaitingForCard = true;
+        iTimer.start();
+        if (iPhase == InProcess) {
+            iCard->setPath(QLatin1String("emulator:") + iConfig);
+        } else {
+            // The tag path will be picked up by adapterTagsChanged
+            iProcess->write("tap\n");
+        }
+    } else if (iPhase == InProcess) {
+        // Start the daemon and wait for it to print "ready"
+        iPhase = OverDBus;
+        iRound = 0;
+        iProcess = new QProcess(this);
+        iProcess->setProcessChannelMode(QProcess::ForwardedErrorChannel);
+        connect(iProcess, SIGNAL(readyReadStandardOutput()),
+            SLOT(onFakeNfcdOutput()));
+        connect(iProcess, SIGNAL(finished(int,QProcess::ExitStatus)),
+            SLOT(onFakeNfcdFinished()));
+        connect(iProcess, SIGNAL(error(QProcess::ProcessError)),
+            SLOT(onFakeNfcdFinished()));
+        iProcess->start(iFakeNfcd, QStringList(iConfig));
+    } else {
+        finish();
+    }
+}
+
+void
+TapLatency::roundDone(
+    bool aOk)
+{
+    const qint64 ns = iTimer.nsecsElapsed();
+
+    iWaitingForCard = false;
+    if (aOk) {
+        ((iPhase == InProcess) ? iInProcess : iOverDBus).append(ns);
+    } else {
+        iFailures++;
+    }
+    iCard->setPath(QString());
+    if (iPhase == InProcess) {
+        // Let the old card object go away before starting the next round
+        QTimer::singleShot(0, this, [this]() { nextRound(); });
+    } else {
+        // The next round starts when the tag disappears
+        iProcess->write("remove\n");
+    }
+}
+
+/* static */
+void
+TapLatency::adapterTagsChanged(
+    NfcAdapterClient* aAdapter,
+    NFC_ADAPTER_PROPERTY,
+    void* aTapLatency)
+{
+    TapLatency* self = (TapLatency*)aTapLatency;
+    const GStrV* tags = aAdapter->tags;
+
+    if (tags && tags[0]) {
+        if (self->iWaitingForCard && self->iCard->path().isEmpty()) {
+            self->iCard->setPath(QString::fromLatin1(tags[0]));
+        }
+    } else if (!self->iWaitingForCard && self->iPhase == OverDBus) {
+        self->nextRound();
+    }
+}
+
+void
+TapLatency::onCardStateChanged()
+{
+    if (iWaitingForCard) {
+        switch (iCard->cardState()) {
+        case TravelCard::CardRecognized:
+            roundDone(true);
+            break;
+        case TravelCard::CardNone:
+            roundDone(false);
+            break;
+        case TravelCard::CardReading:
+            break;
+        }
+    }
+}
+
+void
+TapLatency::onFakeNfcdOutput()
+{
+    while (iProcess->canReadLine()) {
+        if (iProcess->readLine().trimmed() == "ready" && !iAdapter) {
+            iAdapter = nfc_adapter_client_new("/nfc0");
+            iAdapterEventId = nfc_adapter_client_add_property_handler(iAdapter,
+                NFC_ADAPTER_PROPERTY_TAGS, adapterTagsChanged, this);
+            nextRound();
+        }
+    }
+}
+
+void
+TapLatency::onFakeNfcdFinished()
+{
+    fprintf(stderr, "%s is gone\n", qPrintable(iFakeNfcd));
+    iProcess->deleteLater();
+    iProcess = Q_NULLPTR;
+    QCoreApplication::exit(1);
+}
+
+/* static */
+void
+TapLatency::printStats(
+    const char* aName,
+    QList<qint64> aList)
+{
+    if (!aList.isEmpty()) {
+        qint64 sum = 0;
+
+        std::sort(aList.begin(), aList.end());
+        for (int i = 0; i < aList.count(); i++) {
+            sum += aList.at(i);
+        }
+        printf("%-12s %4d %10.3f %10.3f %10.3f %10.3f\n", aName, aList.count(),
+            aList.first()/1e6, aList.at(aList.count()/2)/1e6,
+            sum/1e6/aList.count(), aList.last()/1e6);
+    } else {
+        printf("%-12s    0\n", aName);
+    }
+}
+
+void
+TapLatency::finish()
+{
+    iPhase = Done;
+    printf("%-12s %4s %10s %10s %10s %10s\n", "", "n",
+        "min,ms", "median,ms", "mean,ms", "max,ms");
+    printStats("in-process", iInProcess);
+    printStats("d-bus", iOverDBus);
+    if (!iInProcess.isEmpty() && !iOverDBus.isEmpty()) {
+        std::sort(iInProcess.begin(), iInProcess.end());
+        std::sort(iOverDBus.begin(), iOverDBus.end());
+        printf("D-Bus overhead (median): %.3f ms\n",
+            (iOverDBus.at(iOverDBus.count()/2) -
+             iInProcess.at(iInProcess.count()/2))/1e6);
+    }
+    if (iFailures) {
+        printf("%d read(s) failed\n", iFailures);
+    }
+    QCoreApplication::exit(iFailures ? 1 : 0);
+}
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCommandLineParser parser;
+    QCommandLineOption rounds(QStringList() << "n" << "rounds",
+        "Number of taps per phase", "N", "20");
+    QCommandLineOption fakeNfcd(QStringList() << "d" << "daemon",
+        "Path to fake-nfcd", "PATH", QFileInfo(QCoreApplication::
+        applicationDirPath(), FAKE_NFCD).filePath());
+
+    app.setApplicationName("tap-latency");
+    parser.setApplicationDescription("Measures tap-to-recognized latency "
+        "with and without D-Bus in the loop.");
+    parser.addHelpOption();
+    parser.addOption(rounds);
+    parser.addOption(fakeNfcd);
+    parser.addPositionalArgument("config", "Emulated card configuration");
+    parser.process(app);
+
+    const QStringList args(parser.positionalArguments());
+    const int n = parser.value(rounds).toInt();
+
+    if (args.count() != 1 || n <= 0) {
+        parser.showHelp(2);
+    }
+
+    // libgnfcdc always talks to the system bus, redirect it to the
+    // session bus where the fake daemon lives
+    qputenv("DBUS_SYSTEM_BUS_ADDRESS", qgetenv("DBUS_SESSION_BUS_ADDRESS"));
+
+    TapLatency test(args.first(), parser.value(fakeNfcd), n);
+
+    return test.start() ? app.exec() : 1;
+}
+
+#include "main.moc"
@@ -0,0 +1,10 @@
+TARGET = tap-latency
+
+include(../tools.pri)
+
+# The fake daemon is expected next to this binary unless specified
+# on the command line
+DEFINES += FAKE_NFCD=\\\"fake-nfcd\\\"
+
+SOURCES += \
+    main.cpp
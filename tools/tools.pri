@@ -0,0 +1,16 @@
+# Common settings for the command line tools. These are built
+# separately from the app, either all of them (tools.pro or
+# harbour-matkakortti-all.pro) or one by one, e.g.
+# qmake tools/<tool>/<tool>.pro
+
+TEMPLATE = app
+CONFIG += console link_pkgconfig
+CONFIG -= app_bundle
+PKGCONFIG += glib-2.0 gobject-2.0 gio-2.0 gio-unix-2.0
+QT += qml dbus
+QT -= gui
+
+# The tools read recorded and emulated cards
+CONFIG += transports
+
+include(../core.pri)
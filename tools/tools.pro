@@ -0,0 +1,19 @@
+# All the command line tools. Each one can also be built
+# separately, e.g. qmake tools/<tool>/<tool>.pro
+
+TEMPLATE = subdirs
+
+SUBDIRS = \
+    fake_nfcd \
+    golden \
+    matkakortti_cli \
+    parser_bench \
+    tap_latency
+
+fake_nfcd.subdir = fake-nfcd
+matkakortti_cli.subdir = matkakortti-cli
+parser_bench.subdir = parser-bench
+tap_latency.subdir = tap-latency
+
+# tap-latency runs fake-nfcd
+tap_latency.depends = fake_nfcd
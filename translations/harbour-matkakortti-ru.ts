@@ -43,6 +43,11 @@
         <extracomment>Generic menu item, copies text to clipboard</extracomment>
         <translation>Скопировать в буфер обмена</translation>
     </message>
+    <message id="matkakortti-menu-copy_trace">
+        <source>Copy trace</source>
+        <extracomment>Debug menu item, copies the trace of the last card read to clipboard</extracomment>
+        <translation>Скопировать трассировку</translation>
+    </message>
     <message id="matkakortti-card-header">
         <source>Travel card</source>
         <extracomment>Page title</extracomment>
@@ -203,5 +208,30 @@
         <extracomment>Label (generic timestamp, date + time)</extracomment>
         <translation>Время:</translation>
     </message>
+    <message id="matkakortti-history-section-monthly_spending">
+        <source>Monthly spending</source>
+        <extracomment>Section header</extracomment>
+        <translation>Расходы по месяцам</translation>
+    </message>
+    <message id="matkakortti-history-filter-label">
+        <source>Show</source>
+        <extracomment>Combo box label</extracomment>
+        <translation>Показать</translation>
+    </message>
+    <message id="matkakortti-history-filter-all">
+        <source>Everything</source>
+        <extracomment>Combo box value (history filter)</extracomment>
+        <translation>Все</translation>
+    </message>
+    <message id="matkakortti-history-filter-purchases">
+        <source>Purchases</source>
+        <extracomment>Combo box value (history filter)</extracomment>
+        <translation>Покупки</translation>
+    </message>
+    <message id="matkakortti-history-filter-deposits">
+        <source>Deposits</source>
+        <extracomment>Combo box value (history filter)</extracomment>
+        <translation>Пополнения</translation>
+    </message>
 </context>
 </TS>